@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2020-2023 Leandro Nini
+ *  Copyright (C) 2020-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -18,13 +18,20 @@
 
 #include "InputWrapper.h"
 
+#include "loudnessStore.h"
+#include "ringBuffer.h"
 #include "input/input.h"
-#include "output/audioProcess.h"
 #include "converter/converterFactory.h"
+#include "dsp/dspChain.h"
 #include "settings.h"
 
 #include <QDebug>
+#include <QThread>
+#include <QtEndian>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <limits>
 
 //#define PROFILE
@@ -40,22 +47,289 @@
 #  define PROFILE_END
 #endif
 
+// Marks an empty stream position
+constexpr quint64 NO_POS = std::numeric_limits<quint64>::max();
+
+// Frames decoded at once by the decoder thread
+constexpr size_t CHUNK_FRAMES = 2048;
+
+// Max time the decoder sleeps waiting for the output, in milliseconds
+constexpr unsigned long WAIT_TIMEOUT = 20;
+
+// Audio decoded at the new position before output resumes after a seek, in milliseconds
+constexpr unsigned int PREROLL_TIME = 100;
+
+// Max time a blocking output waits for the player to answer a preload request, in milliseconds
+constexpr qint64 PRELOAD_WAIT = 1000;
+
+// Time left to the song end when the next one is requested, on top of
+// the crossfade, the decode ahead buffer and the backend open latency
+constexpr unsigned int PRELOAD_MARGIN = 4000;
+
+// Samples below this level, about -60 dBFS, are considered silent
+constexpr float SILENCE_LEVEL = 0.001f;
+
+// Trailing silence longer than this ends the song, in milliseconds
+constexpr unsigned int MIN_SILENCE = 500;
+
+// Song tail where trailing silence is looked for, in milliseconds
+constexpr unsigned int TRIM_WINDOW = 10000;
+
+// Max leading silence skipped, in milliseconds
+constexpr unsigned int MAX_LEADING_SILENCE = 10000;
+
+// Start of the preloaded song decoded ahead of the switch, in milliseconds
+constexpr unsigned int LOOKAHEAD_TIME = 500;
+
+// The refill threshold is kept above this many times the slowest chunk decode
+constexpr unsigned int JITTER_FACTOR = 4;
+
+// Audio decoded without underruns before the refill threshold is lowered, in milliseconds
+constexpr unsigned int SHRINK_TIME = 30000;
+
+constexpr float HALF_PI = 1.57079632679489661923f;
+
+namespace
+{
+/// ReplayGain scale factor for the song, with clipping prevention
+float replayGain(const input* song)
+{
+    if (!SETTINGS->replayGain())
+        return 1.f;
+
+    replayGain_t rg = song->getMetaData()->getReplayGain();
+    if (std::isnan(rg.trackGain) && std::isnan(rg.albumGain))
+    {
+        // untagged songs use the background measurements
+        LDSTORE->lookup(song->songLoaded(), rg);
+    }
+
+    const bool album = SETTINGS->replayGainMode() == settings::rg_t::Album;
+    float gain = album ? rg.albumGain : rg.trackGain;
+    float peak = album ? rg.albumPeak : rg.trackPeak;
+    if (std::isnan(gain))
+    {
+        // fall back to the other mode
+        gain = album ? rg.trackGain : rg.albumGain;
+        peak = album ? rg.trackPeak : rg.albumPeak;
+    }
+    if (std::isnan(gain))
+        return 1.f;
+
+    float scale = std::pow(10.f, gain / 20.f);
+    if ((peak > 0.f) && (scale * peak > 1.f))
+        scale = 1.f / peak;
+    return scale;
+}
+
+/// Count the silent frames at the end of the buffer
+size_t silentTail(const float* buffer, size_t frames, unsigned int channels)
+{
+    size_t n = 0;
+    for (const float* s = buffer + frames * channels; n < frames; n++)
+    {
+        s -= channels;
+        for (unsigned int c=0; c<channels; c++)
+        {
+            if (std::fabs(s[c]) > SILENCE_LEVEL)
+                return n;
+        }
+    }
+    return n;
+}
+
+/// Count the silent frames at the start of the buffer
+size_t silentHead(const float* buffer, size_t frames, unsigned int channels)
+{
+    size_t n = 0;
+    for (const float* s = buffer; n < frames; n++, s += channels)
+    {
+        for (unsigned int c=0; c<channels; c++)
+        {
+            if (std::fabs(s[c]) > SILENCE_LEVEL)
+                return n;
+        }
+    }
+    return n;
+}
+
+/// Copy from a lookahead buffer, released once consumed
+size_t readLookahead(std::vector<char>& buffer, size_t& pos, char* out, size_t size)
+{
+    const size_t n = std::min(size, buffer.size() - pos);
+    if (n == 0)
+        return 0;
+
+    std::memcpy(out, buffer.data() + pos, n);
+    pos += n;
+    if (pos == buffer.size())
+    {
+        std::vector<char>().swap(buffer);
+        pos = 0;
+    }
+    return n;
+}
+
+#if (Q_BYTE_ORDER == Q_BIG_ENDIAN)
+template <typename T>
+void toLittleEndian(char* buffer, size_t size)
+{
+    T* buf = reinterpret_cast<T*>(buffer);
+    T* const end = buf + size / sizeof(T);
+    while (buf < end)
+    {
+        *buf = qToLittleEndian(*buf);
+        buf++;
+    }
+}
+#endif
+}
+
 InputWrapper::InputWrapper(input* song) :
     m_currentSong(song),
-    m_preloadedSong(nullptr),
-    m_audioProcess(nullptr),
+    m_decodingSong(song),
+    m_nextSong(nullptr),
+    m_preloadRequest(nullptr),
+    m_unloadRequest(false),
+    m_lookaheadPos(0),
+    m_lookaheadSize(0),
+    m_busFrameSize(0),
     m_audioConverter(nullptr),
+    m_outputConverter(nullptr),
+    m_decoder(nullptr),
+    m_stopDecoder(false),
+    m_endOfStream(false),
+    m_seekRequest(false),
+    m_skipRequest(false),
+    m_paused(false),
+    m_blocking(false),
+    m_preloadPending(false),
+    m_seekPos(0.),
+    m_seekState(seek_t::None),
+    m_seekTime(0),
+    m_seekLatency(0),
+    m_seekFrames(0),
+    m_switchPos(NO_POS),
+    m_discardPos(NO_POS),
+    m_switchFrames(0),
+    m_notifySwitch(true),
+    m_crossfade(false),
+    m_trimSilence(false),
+    m_fadeFrames(0),
+    m_minSilence(0),
+    m_trimWindow(0),
+    m_songFrames(0),
+    m_decodedFrames(0),
+    m_silentFrames(0),
+    m_fadeLength(0),
+    m_fadeStart(0),
+    m_fadePos(0),
+    m_fadeInFrames(0),
+    m_fadeHead(0),
+    m_fadeCount(0),
+    m_preloadLead(0),
+    m_openLatency(0),
+    m_preloadRequested(false),
+    m_filling(true),
+    m_floatBus(false),
+    m_busFormat{ 0, 0, sample_t::S16 },
+    m_channels(0),
+    m_swapSize(0),
+    m_highWatermark(0),
+    m_lowWatermark(0),
+    m_minLowWatermark(0),
+    m_maxLowWatermark(0),
+    m_steadyBytes(0),
+    m_lastUnderruns(0),
+    m_songStats(nullptr),
+    m_prerollSize(0),
+    m_silenceSize(0),
+    m_silence(0),
+    m_underruns(0),
+    m_overruns(0),
+    m_minFill(std::numeric_limits<size_t>::max()),
+    m_frames(0),
     m_bytes(0),
-    m_bytePerMilliSec(std::numeric_limits<int>::max()),
-    m_milliSeconds(0),
+    m_frameSize(0),
+    m_sampleRate(0),
+    m_nextUpdate(0),
+    m_preloadFrame(NO_POS),
+    m_outputDelay(0),
     m_finished(false),
     m_maxPlayTime(song->maxPlayTime())
-{}
+{
+    m_clock.start();
+}
 
 InputWrapper::~InputWrapper()
 {
-    delete m_audioProcess;
+    stopDecoder();
+
+    delete m_preloadRequest.exchange(nullptr);
     delete m_audioConverter;
+    delete m_outputConverter;
+}
+
+bool InputWrapper::open(OpenMode mode)
+{
+    if (m_ringBuffer.get() == nullptr)
+        return false;
+
+    if (!QIODevice::open(mode))
+        return false;
+
+    // Prefill the buffer before output starts pulling
+    while (m_ringBuffer->size() < m_lowWatermark)
+    {
+        if (!decode())
+        {
+            m_endOfStream = true;
+            break;
+        }
+    }
+
+    startDecoder();
+    return true;
+}
+
+void InputWrapper::close()
+{
+    stopDecoder();
+
+    qInfo() << "Decoder underruns:" << m_underruns.load() << "overruns:" << m_overruns.load()
+        << "min fill:" << minFill() << "ms refill threshold:" << toMilliSeconds(m_lowWatermark) << "ms";
+    for (const auto& [backend, stats]: m_decodeStats)
+    {
+        const double deviation = (stats.chunks > 1) ? std::sqrt(stats.m2 / (stats.chunks - 1)) : 0.;
+        qInfo().nospace() << "Decoder " << backend << ": " << stats.mean << " ns/frame, jitter "
+            << deviation << " ns/frame, slowest chunk " << stats.maxNanoSeconds / 1000 << " us";
+    }
+    if (m_dsp)
+        m_dsp->logStats();
+
+    QIODevice::close();
+}
+
+void InputWrapper::startDecoder()
+{
+    if ((m_decoder != nullptr) || (m_ringBuffer.get() == nullptr))
+        return;
+
+    m_stopDecoder = false;
+    m_decoder = QThread::create([this]() { decodeLoop(); });
+    m_decoder->start();
+}
+
+void InputWrapper::stopDecoder()
+{
+    if (m_decoder == nullptr)
+        return;
+
+    m_stopDecoder = true;
+    m_wakeUp.wakeAll();
+    m_decoder->wait();
+    delete m_decoder;
+    m_decoder = nullptr;
 }
 
 qint64 InputWrapper::bytesAvailable() const
@@ -63,36 +337,527 @@ qint64 InputWrapper::bytesAvailable() const
     if (m_finished)
         return 0;
 
-    const int bytes = SETTINGS->bufLen() * m_bytePerMilliSec;
+    const qint64 bytes = (SETTINGS->bufLen() * m_sampleRate / 1000) * m_frameSize;
     return bytes + QIODevice::bytesAvailable();
 }
 
-void InputWrapper::enableBs2b()
+size_t InputWrapper::fillBuffer(char *data, size_t maxSize)
 {
-    if (m_audioProcess != nullptr)
-        m_audioProcess->init(m_currentSong->samplerate());
+PROFILE_START
+    size_t n;
+
+    // With the float bus decoding and DSP write to the output converter buffer
+    size_t const busSize = (m_outputConverter != nullptr) ? m_outputConverter->bufSize(maxSize) : maxSize;
+    char* const bus = (m_outputConverter != nullptr) ? m_outputConverter->buffer() : data;
+
+    // A preloaded song starts from what was decoded in advance
+    n = readLookahead(m_lookahead, m_lookaheadPos, bus, busSize);
+    if (n == 0)
+        n = decodeSong(m_decodingSong, m_audioConverter, bus, busSize);
+
+    // Songs are mixed on the bus before the DSP
+    if (m_crossfade)
+        n = crossfade(bus, n, busSize);
+
+    // DSP runs after resampling
+    if (m_floatBus && !m_dsp->empty())
+        m_dsp->process(reinterpret_cast<float*>(bus), n / (m_channels * sizeof(float)));
+
+    if (m_outputConverter != nullptr)
+        n = m_outputConverter->convert(data, n);
+
+#if (Q_BYTE_ORDER == Q_BIG_ENDIAN)
+    //Swap bytes on big endian machines
+    if (m_swapSize == 2)
+        toLittleEndian<quint16>(data, n);
+    else if (m_swapSize == 4)
+        toLittleEndian<quint32>(data, n);
+#endif
+PROFILE_END
+
+    return n;
 }
 
-qint64 InputWrapper::fillBuffer(char *data, qint64 maxSize)
+size_t InputWrapper::decodeSong(input* song, converter* conv, char* bus, size_t busSize)
 {
-PROFILE_START
-    size_t n;
+    if (conv == nullptr)
+        return song->fillBuffer(bus, busSize);
+
+    size_t const bufSize = conv->bufSize(busSize);
+    size_t const size = song->fillBuffer(conv->buffer(), bufSize);
+    return conv->convert(bus, size);
+}
+
+size_t InputWrapper::readPreload(preload_t* song, char* bus, size_t busSize)
+{
+    const size_t n = readLookahead(song->lookahead, song->lookaheadPos, bus, busSize);
+    return (n > 0) ? n : decodeSong(song->song.get(), song->conv.get(), bus, busSize);
+}
+
+bool InputWrapper::fillLookahead()
+{
+    preload_t* const preload = m_preloaded.get();
+    if ((preload == nullptr) || preload->ended || (preload->lookahead.size() >= m_lookaheadSize))
+        return false;
+
+    const size_t size = preload->lookahead.size();
+    const size_t chunk = std::min(CHUNK_FRAMES * m_busFrameSize, m_lookaheadSize - size);
+    preload->lookahead.resize(size + chunk);
+    const size_t n = decodeSong(preload->song.get(), preload->conv.get(), preload->lookahead.data() + size, chunk);
+    preload->lookahead.resize(size + n);
+    if (n == 0)
+        preload->ended = true;
+    return true;
+}
+
+quint64 InputWrapper::songFrames(const input* song) const
+{
+    unsigned int length = song->songDuration();
+    const unsigned int maxPlayTime = song->maxPlayTime();
+    if (maxPlayTime && (!length || (maxPlayTime < length)))
+        length = maxPlayTime;
+    return static_cast<quint64>(length) * m_busFormat.sampleRate / 1000;
+}
 
+void InputWrapper::switchSong(preload_t* next, quint64 startFrame)
+{
+    m_decodingRef = next->song;
+    m_decodingSong = next->song.get();
+    m_nextSong = next->song.get();
+    delete m_audioConverter;
+    m_audioConverter = next->conv.release();
+    m_lookahead.swap(next->lookahead);
+    m_lookaheadPos = next->lookaheadPos;
+    qDebug() << "Switching song with" << (m_lookahead.size() - m_lookaheadPos) / m_busFrameSize << "frames decoded ahead";
+
+    m_songFrames = songFrames(m_decodingSong);
+    m_decodedFrames = startFrame;
+    m_songStats = &m_decodeStats[m_decodingSong->getMetaData()->getBackendName()];
+    m_silentFrames = 0;
+
+    // Mark the point where the output should switch song
+    m_switchFrames = startFrame;
+    m_switchPos.store(m_ringBuffer->writePos(), std::memory_order_release);
+}
+
+size_t InputWrapper::readFadeIn(float* buffer, size_t frames)
+{
+    const size_t frameSize = m_channels * sizeof(float);
+    size_t done = 0;
+
+    // leftover from the leading silence skip
+    if (m_fadeCount > 0)
+    {
+        done = std::min(frames, m_fadeCount);
+        std::memcpy(buffer, &m_fadePending[m_fadeHead * m_channels], done * frameSize);
+        m_fadeHead += done;
+        m_fadeCount -= done;
+    }
+
+    while (done < frames)
+    {
+        char* const out = reinterpret_cast<char*>(buffer + done * m_channels);
+        const size_t n = readPreload(m_fadeIn.get(), out, (frames - done) * frameSize);
+        if (n == 0)
+            break;
+        done += n / frameSize;
+    }
+
+    m_fadeInFrames += done;
+    return done;
+}
+
+void InputWrapper::skipSilence()
+{
+    const size_t frameSize = m_channels * sizeof(float);
+    const quint64 maxFrames = static_cast<quint64>(MAX_LEADING_SILENCE) * m_busFormat.sampleRate / 1000;
+
+    m_fadePending.resize(CHUNK_FRAMES * m_channels);
+    char* const out = reinterpret_cast<char*>(m_fadePending.data());
+
+    while (m_fadeInFrames < maxFrames)
+    {
+        const size_t frames = readPreload(m_fadeIn.get(), out, CHUNK_FRAMES * frameSize) / frameSize;
+        if (frames == 0)
+            return;
+
+        const size_t silent = silentHead(m_fadePending.data(), frames, m_channels);
+        m_fadeInFrames += silent;
+        if (silent < frames)
+        {
+            m_fadeHead = silent;
+            m_fadeCount = frames - silent;
+            qDebug() << "Skipped" << m_fadeInFrames << "frames of leading silence";
+            return;
+        }
+    }
+}
+
+size_t InputWrapper::crossfade(char* bus, size_t n, size_t busSize)
+{
+    const size_t frameSize = m_channels * sizeof(float);
+    float* const out = reinterpret_cast<float*>(bus);
+
+    if (m_fadeIn.get() == nullptr)
+    {
+        const size_t frames = n / frameSize;
+        m_decodedFrames += frames;
+
+        // Songs of unknown length, or ending early, just switch at the end
+        if ((m_songFrames == 0) || (n == 0))
+            return n;
+
+        // Short songs fade for half their length at most
+        quint64 fadeLength = std::min(m_fadeFrames, m_songFrames / 2);
+        const quint64 fadeStart = m_songFrames - fadeLength;
+
+        bool trim = false;
+        if (m_trimSilence)
+        {
+            const size_t tail = silentTail(out, frames, m_channels);
+            m_silentFrames = (tail == frames) ? m_silentFrames + frames : tail;
+            trim = (m_decodedFrames + m_trimWindow >= fadeStart) && (m_silentFrames >= m_minSilence);
+        }
+
+        if (!trim && (m_decodedFrames < fadeStart))
+            return n;
+
+        receivePreload();
+        m_fadeIn = std::move(m_preloaded);
+        if (m_fadeIn.get() != nullptr)
+        {
+            const quint64 nextFrames = songFrames(m_fadeIn->song.get());
+            if (nextFrames > 0)
+                fadeLength = std::min(fadeLength, nextFrames / 2);
+            m_fadeLength = fadeLength;
+            // a silent ending is cut instead of faded, a late
+            // preload joins the curve where the song is
+            m_fadeStart = trim ? m_decodedFrames : m_songFrames - fadeLength;
+            m_fadePos = trim ? fadeLength
+                : ((m_decodedFrames > m_fadeStart) ? std::min(fadeLength, m_decodedFrames - m_fadeStart) : 0);
+            m_fadeInFrames = 0;
+            m_fadeHead = 0;
+            m_fadeCount = 0;
+            if (m_trimSilence)
+                skipSilence();
+            qDebug() << (trim ? "Trimming trailing silence" : "Starting crossfade");
+        }
+        return n;
+    }
+
+    // A shorter incoming song makes the fade start later
+    if ((n > 0) && (m_decodedFrames < m_fadeStart))
+    {
+        m_decodedFrames += n / frameSize;
+        return n;
+    }
+
+    // The outgoing song may end before the fade does
+    const size_t frames = busSize / frameSize;
+    std::memset(bus + n, 0, frames * frameSize - n);
+
+    m_fadeBuffer.resize(frames * m_channels);
+    const quint64 fadeInStart = m_fadeInFrames;
+    const size_t got = readFadeIn(m_fadeBuffer.data(), frames);
+    std::fill(m_fadeBuffer.begin() + got * m_channels, m_fadeBuffer.end(), 0.f);
+
+    // Equal power curve
+    const float* in = m_fadeBuffer.data();
+    float* o = out;
+    for (size_t f=0; f<frames; f++)
+    {
+        const float t = (m_fadePos + f < m_fadeLength)
+            ? static_cast<float>(m_fadePos + f) / m_fadeLength : 1.f;
+        const float gainOut = std::cos(t * HALF_PI);
+        const float gainIn = std::sin(t * HALF_PI);
+        for (unsigned int c=0; c<m_channels; c++)
+            o[c] = o[c] * gainOut + in[c] * gainIn;
+        o += m_channels;
+        in += m_channels;
+    }
+    m_fadePos += frames;
+
+    // The outgoing song is over, go on with the incoming one
+    // once the frames left by the silence skip are used up
+    if ((m_fadePos >= m_fadeLength) && (m_fadeCount == 0))
+    {
+        qDebug() << "Crossfade done";
+        switchSong(m_fadeIn.get(), fadeInStart);
+        m_decodedFrames = m_fadeInFrames;
+        m_fadeIn.reset();
+    }
+
+    return frames * frameSize;
+}
+
+bool InputWrapper::decode()
+{
+    size_t n = fillBuffer(m_decodeBuffer.data(), m_decodeBuffer.size());
+
+    if (n == 0)
+    {
+        receivePreload();
+        std::unique_ptr<preload_t> preload(std::move(m_preloaded));
+        if (preload.get() == nullptr)
+            return false;
+
+        switchSong(preload.get(), 0);
+
+        n = fillBuffer(m_decodeBuffer.data(), m_decodeBuffer.size());
+        if (n == 0)
+            return false;
+    }
+
+    m_ringBuffer->write(m_decodeBuffer.constData(), n);
+    return true;
+}
+
+void InputWrapper::setGain(const input* song, converter* conv)
+{
+    const float gain = replayGain(song);
+    if ((conv != nullptr) && conv->setGain(gain))
+        qDebug() << "ReplayGain scale:" << gain;
+    else if (gain != 1.f)
+        qWarning() << "ReplayGain not available for the card format";
+}
+
+void InputWrapper::doSeek()
+{
+    if ((m_switchPos.load(std::memory_order_acquire) != NO_POS) || (m_fadeIn.get() != nullptr))
+    {
+        qDebug() << "Song switch pending, ignoring seek";
+    }
+    else
+    {
+        const double pos = m_seekPos;
+        if (m_decodingSong->seek(pos))
+        {
+            const quint64 seekMilliSeconds = static_cast<quint64>(pos * m_decodingSong->songDuration());
+            m_decodedFrames = seekMilliSeconds * m_busFormat.sampleRate / 1000;
+            m_seekFrames = m_decodedFrames;
+            m_silentFrames = 0;
+            std::vector<char>().swap(m_lookahead);
+            m_lookaheadPos = 0;
+            // Everything written up to here must be dropped
+            m_discardPos.store(m_ringBuffer->writePos(), std::memory_order_release);
+            m_endOfStream = false;
+            m_filling = true;
+            // filters still hold audio from the old position
+            resetFilters();
+        }
+    }
+
+    // the output waits for the preroll from here,
+    // unless a newer seek came in meanwhile
+    if (!m_seekRequest)
+        m_seekState.store(seek_t::Done, std::memory_order_release);
+}
+
+void InputWrapper::resetFilters()
+{
+    m_dsp->reset();
     if (m_audioConverter != nullptr)
+        m_audioConverter->reset();
+    if (m_outputConverter != nullptr)
+        m_outputConverter->reset();
+}
+
+void InputWrapper::doSkip()
+{
+    // the incoming song of a crossfade is the preloaded one
+    const quint64 startFrame = m_fadeIn ? m_fadeInFrames : 0;
+    receivePreload();
+    std::unique_ptr<preload_t> next(m_fadeIn ? std::move(m_fadeIn) : std::move(m_preloaded));
+
+    if (next.get() == nullptr)
+    {
+        // the decoder may be already on the next song
+        const quint64 switchPos = m_switchPos.load(std::memory_order_acquire);
+        if (switchPos == NO_POS)
+            return;
+
+        m_notifySwitch = false;
+        m_seekFrames = m_switchFrames.load();
+        m_discardPos.store(switchPos, std::memory_order_release);
+        return;
+    }
+
+    // frames left from the silence skip go before the rest of the song
+    if (m_fadeCount > 0)
     {
-        size_t const bufSize = m_audioConverter->bufSize(maxSize);
-        size_t const size = m_currentSong->fillBuffer(m_audioConverter->buffer(), bufSize);
-        n = m_audioConverter->convert(data, size);
+        const char* const pending = reinterpret_cast<const char*>(m_fadePending.data() + m_fadeHead * m_channels);
+        next->lookahead.insert(next->lookahead.begin() + next->lookaheadPos,
+            pending, pending + m_fadeCount * m_channels * sizeof(float));
+        m_fadeCount = 0;
+    }
+
+    m_notifySwitch = false;
+    resetFilters();
+    switchSong(next.get(), startFrame);
+    m_seekFrames = m_switchFrames.load();
+    m_discardPos.store(m_switchPos.load(std::memory_order_relaxed), std::memory_order_release);
+    m_endOfStream = false;
+    m_filling = true;
+}
+
+void InputWrapper::receivePreload()
+{
+    // an unload drops what was taken before, the request after it stands
+    if (m_unloadRequest.exchange(false))
+        m_preloaded.reset();
+
+    preload_t* const preload = m_preloadRequest.exchange(nullptr);
+    if (preload != nullptr)
+        m_preloaded.reset(preload);
+}
+
+void InputWrapper::decodeLoop()
+{
+    while (!m_stopDecoder)
+    {
+        // a song preloaded after the end of stream still follows,
+        // the end is cleared before the request is taken
+        if (m_endOfStream && ((m_preloadRequest.load() != nullptr) || (m_preloaded.get() != nullptr)))
+            m_endOfStream = false;
+
+        // Requests from the GUI thread are handled between chunks
+        receivePreload();
+
+        if (m_skipRequest.exchange(false))
+            doSkip();
+
+        if (m_seekRequest.exchange(false))
+        {
+            doSeek();
+            if (m_blocking)
+                m_dataReady.wakeAll();
+        }
+
+        const size_t fill = m_ringBuffer->size();
+        if (m_filling && (fill >= m_highWatermark))
+        {
+            m_filling = false;
+            m_overruns++;
+        }
+        else if (!m_filling && (fill <= m_lowWatermark))
+        {
+            m_filling = true;
+        }
+
+        if (!m_filling || m_endOfStream || m_paused)
+        {
+            // spare time goes to the start of the next song
+            if (fillLookahead())
+                continue;
+
+            QMutexLocker locker(&m_mutex);
+            m_wakeUp.wait(&m_mutex, WAIT_TIMEOUT);
+            continue;
+        }
+
+        const quint64 writePos = m_ringBuffer->writePos();
+        const qint64 start = m_clock.nsecsElapsed();
+        if (!decode())
+        {
+            qDebug() << "decoder reached end of stream";
+            m_endOfStream = true;
+        }
+        adaptBuffer(m_clock.nsecsElapsed() - start, m_ringBuffer->writePos() - writePos);
+
+        if (m_blocking)
+            m_dataReady.wakeAll();
+    }
+}
+
+void InputWrapper::waitForDecoder()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    while (!m_stopDecoder && m_blocking)
+    {
+        const seek_t seek = m_seekState.load(std::memory_order_acquire);
+        if (seek != seek_t::Requested)
+        {
+            // what is written past a pending discard is what gets played
+            const quint64 discardPos = m_discardPos.load(std::memory_order_acquire);
+            const quint64 readPos = (discardPos != NO_POS) ? discardPos : m_ringBuffer->readPos();
+            const size_t needed = (seek == seek_t::Done) ? std::max<size_t>(m_prerollSize, 1) : 1;
+            if (m_ringBuffer->writePos() - readPos >= needed)
+                return;
+
+            // the song ends unless the player is still choosing the next one
+            const bool preloading = (m_preloadPending && (timer.elapsed() < PRELOAD_WAIT))
+                || (m_preloadRequest.load() != nullptr);
+            if (m_endOfStream && !preloading)
+                return;
+        }
+
+        m_wakeUp.wakeOne();
+        QMutexLocker locker(&m_mutex);
+        m_dataReady.wait(&m_mutex, WAIT_TIMEOUT);
+    }
+}
+
+void InputWrapper::adaptBuffer(qint64 nanoSeconds, size_t bytes)
+{
+    if (bytes < m_frameSize)
+        return;
+
+    // Per frame time, the chunk may end short at the song end
+    decodeStats_t& stats = *m_songStats;
+    const double perFrame = static_cast<double>(nanoSeconds) / (bytes / m_frameSize);
+    stats.chunks++;
+    const double delta = perFrame - stats.mean;
+    stats.mean += delta / stats.chunks;
+    stats.m2 += delta * (perFrame - stats.mean);
+    stats.maxNanoSeconds = std::max(stats.maxNanoSeconds, static_cast<quint64>(nanoSeconds));
+
+    // Refilling must start early enough to outlast the slowest chunk
+    // and the time the decoder may be sleeping
+    const quint64 worstMs = (JITTER_FACTOR * stats.maxNanoSeconds) / 1000000 + WAIT_TIMEOUT;
+    const size_t required = ((worstMs * m_sampleRate) / 1000) * m_frameSize;
+
+    size_t low = m_lowWatermark;
+    const unsigned int underruns = m_underruns;
+    if (underruns != m_lastUnderruns)
+    {
+        m_lastUnderruns = underruns;
+        m_steadyBytes = 0;
+        low *= 2;
     }
     else
     {
-        n = m_currentSong->fillBuffer(data, maxSize);
+        m_steadyBytes += bytes;
+        if (m_steadyBytes >= ((static_cast<quint64>(SHRINK_TIME) * m_sampleRate) / 1000) * m_frameSize)
+        {
+            m_steadyBytes = 0;
+            low -= low / 4;
+        }
     }
 
-    m_audioProcess->process(data, n);
-PROFILE_END
+    low = std::clamp(std::max(low, required), m_minLowWatermark, m_maxLowWatermark);
+    if (low != m_lowWatermark)
+    {
+        qDebug() << "Refill threshold:" << toMilliSeconds(low) << "ms";
+        m_lowWatermark = low;
+    }
+}
 
-    return n;
+unsigned int InputWrapper::toMilliSeconds(size_t bytes) const
+{
+    return ((m_frameSize != 0) && (m_sampleRate != 0)) ? ((bytes / m_frameSize) * 1000) / m_sampleRate : 0;
+}
+
+unsigned int InputWrapper::minFill() const
+{
+    const size_t fill = m_minFill;
+    return (fill != std::numeric_limits<size_t>::max()) ? toMilliSeconds(fill) : 0;
+}
+
+unsigned int InputWrapper::buffered() const
+{
+    return (m_ringBuffer.get() != nullptr) ? toMilliSeconds(m_ringBuffer->size()) : 0;
 }
 
 qint64 InputWrapper::readData(char *data, qint64 maxSize)
@@ -103,7 +868,7 @@ qint64 InputWrapper::readData(char *data, qint64 maxSize)
         return 0;
     }
 
-    if (m_maxPlayTime && (m_milliSeconds > m_maxPlayTime))
+    if (m_maxPlayTime && (m_frames > (static_cast<quint64>(m_maxPlayTime) * m_sampleRate) / 1000))
     {
         qDebug() << "reached max playing time";
         m_finished = true;
@@ -111,51 +876,150 @@ qint64 InputWrapper::readData(char *data, qint64 maxSize)
         return 0;
     }
 
-    size_t n = fillBuffer(data, maxSize);
+    // Offline the output waits for the decoder rather than playing silence
+    if (m_blocking)
+        waitForDecoder();
 
-    if (n == 0)
+    // Nothing from before a seek is played, the sink has been flushed
+    // and gets silence until the decoder has prerolled the new position
+    const seek_t seek = m_seekState.load(std::memory_order_acquire);
+    if (seek == seek_t::Requested)
+        return silence(data, maxSize);
+
+    const quint64 discardPos = m_discardPos.exchange(NO_POS, std::memory_order_acquire);
+    if (discardPos != NO_POS)
     {
-        if (m_preloadedSong != nullptr)
+        m_ringBuffer->skipTo(discardPos);
+        restartClock(m_seekFrames);
+    }
+
+    if (seek == seek_t::Done)
+    {
+        if ((m_ringBuffer->size() < m_prerollSize) && !m_endOfStream)
+            return silence(data, maxSize);
+
+        seek_t expected = seek_t::Done;
+        if (m_seekState.compare_exchange_strong(expected, seek_t::None))
         {
-            m_currentSong = m_preloadedSong;
-            m_preloadedSong = nullptr;
-            m_milliSeconds = 0;
-            n = fillBuffer(data, maxSize);
-            emit songFinished();
+            m_seekLatency = (m_clock.nsecsElapsed() - m_seekTime) / 1000000;
+            qDebug() << "Seek latency:" << m_seekLatency.load() << "ms";
+        }
+    }
+
+    size_t len = maxSize;
+
+    const quint64 switchPos = m_switchPos.load(std::memory_order_acquire);
+    if (switchPos != NO_POS)
+    {
+        const quint64 readPos = m_ringBuffer->readPos();
+        if (readPos >= switchPos)
+        {
+            m_currentSong = m_nextSong;
+            m_maxPlayTime = m_currentSong->maxPlayTime();
+            m_switchPos.store(NO_POS, std::memory_order_release);
+            // a crossfaded song has already played for the fade length
+            restartClock(m_switchFrames);
+            if (m_notifySwitch.exchange(true))
+                emit songFinished();
         }
         else
+        {
+            // Don't mix data from different songs
+            len = std::min(len, static_cast<size_t>(switchPos - readPos));
+        }
+    }
+
+    size_t n = m_ringBuffer->read(data, len);
+
+    const size_t fill = m_ringBuffer->size();
+    if (fill <= m_lowWatermark)
+        m_wakeUp.wakeOne();
+
+    // the buffer drains at the end of the stream
+    if (!m_endOfStream && (fill < m_minFill))
+        m_minFill = fill;
+
+    if (n == 0)
+    {
+        if (m_endOfStream && (m_ringBuffer->size() == 0))
         {
             qDebug() << "finished playing";
             m_finished = true;
             emit songFinished();
             return 0;
         }
+
+        // Decoder is late, play some silence
+        m_underruns++;
+        return silence(data, len);
     }
 
     m_bytes += n;
+    const quint64 frames = m_frames + m_bytes / m_frameSize;
+    m_bytes %= m_frameSize;
+    m_frames = frames;
 
-    const unsigned int oldSeconds = m_milliSeconds / 1000;
-
-    while (m_bytes > m_bytePerMilliSec)
+    if (frames >= m_nextUpdate)
     {
-        m_bytes -= m_bytePerMilliSec;
-        m_milliSeconds++;
+        // Tick when the audible position enters the next second
+        const quint64 delay = m_outputDelay;
+        const quint64 played = (frames > delay) ? frames - delay : 0;
+        m_nextUpdate = (played / m_sampleRate + 1) * m_sampleRate + delay;
+        updatePreloadFrame();
+        emit updateTime();
     }
 
-    const unsigned int newSeconds = m_milliSeconds / 1000;
-
-    if (oldSeconds != newSeconds)
+    if (!m_preloadRequested && (frames >= m_preloadFrame))
     {
-        if (newSeconds == (m_currentSong->songDuration()/1000)-5)
-        {
-            emit preloadSong();
-        }
-        emit updateTime();
+        m_preloadRequested = true;
+        m_preloadPending = true;
+        emit preloadSong();
     }
 
     return n;
 }
 
+void InputWrapper::restartClock(quint64 frame)
+{
+    m_frames = frame;
+    m_bytes = 0;
+    m_nextUpdate = frame;
+    m_preloadRequested = false;
+}
+
+void InputWrapper::updatePreloadFrame()
+{
+    // Request the next song early enough for slow backends to open
+    // and for the decoder to start the fade
+    const quint64 duration = m_currentSong->songDuration();
+    const quint64 lead = m_preloadLead + 2 * m_openLatency;
+    if (duration == 0)
+        m_preloadFrame = NO_POS;
+    else if (duration > lead)
+        m_preloadFrame = ((duration - lead) * m_sampleRate) / 1000;
+    else
+        m_preloadFrame = m_sampleRate;
+}
+
+unsigned int InputWrapper::getPosition(quint64 delay) const
+{
+    if (m_sampleRate == 0)
+        return 0;
+
+    // also aligns the updateTime ticks to what is heard
+    m_outputDelay = delay;
+
+    const quint64 frames = m_frames;
+    return (((frames > delay) ? frames - delay : 0) * 1000) / m_sampleRate;
+}
+
+size_t InputWrapper::silence(char *data, size_t maxSize) const
+{
+    const size_t n = std::min(maxSize, m_silenceSize);
+    std::memset(data, m_silence, n);
+    return n;
+}
+
 qint64 InputWrapper::writeData(const char *data, qint64 maxSize)
 {
     Q_UNUSED(data);
@@ -164,31 +1028,120 @@ qint64 InputWrapper::writeData(const char *data, qint64 maxSize)
     return 0;
 }
 
-bool InputWrapper::tryPreload(input* newSong)
+converter* InputWrapper::songConverter(const input* song) const
 {
-    if ((m_currentSong->samplerate() == newSong->samplerate())
-        && (m_currentSong->channels() == newSong->channels())
-        && (m_currentSong->precision() == newSong->precision()))
+    const audioFormat_t songFormat { song->samplerate(), song->channels(), song->precision() };
+
+    // with the float bus dithering is done by the output converter
+    converter* conv = CFACTORY->get(songFormat, m_busFormat, song->fract(), SETTINGS->resamplerQuality(),
+        !m_floatBus && SETTINGS->noiseShaping());
+
+    // float songs need a pass to apply gain, as do S32 ones without the float bus
+    if ((conv == nullptr) && SETTINGS->replayGain() && (song->precision() == m_busFormat.sampleType))
+        conv = CFACTORY->getGain(m_busFormat);
+
+    return conv;
+}
+
+bool InputWrapper::needsConverter(const input* song) const
+{
+    return (song->samplerate() != m_busFormat.sampleRate) || (song->precision() != m_busFormat.sampleType);
+}
+
+bool InputWrapper::tryPreload(std::shared_ptr<input> newSong)
+{
+    // Nothing playing
+    if (m_ringBuffer.get() == nullptr)
+        return false;
+
+    // Synthesized formats can follow the output rate
+    if (newSong->samplerate() != m_busFormat.sampleRate)
+        newSong->setSamplerate(m_busFormat.sampleRate);
+
+    newSong->setFloat(m_floatBus);
+
+    // Channels are not remixed
+    if (newSong->channels() != m_busFormat.channels)
     {
-        m_preloadedSong = newSong;
-        return true;
+        qDebug() << "Channels differ, cannot preload";
+        unload();
+        return false;
     }
-    else
+
+    // The song gets its own conversion into the open output format
+    std::unique_ptr<preload_t> preload(new preload_t);
+    preload->song = newSong;
+    preload->conv.reset(songConverter(newSong.get()));
+    preload->lookaheadPos = 0;
+    preload->ended = false;
+    if ((preload->conv.get() == nullptr) && needsConverter(newSong.get()))
     {
-        m_preloadedSong = nullptr;
+        qDebug() << "Unsupported format, cannot preload";
+        unload();
         return false;
     }
+
+    // the lookahead is decoded with the song gain already set
+    setGain(newSong.get(), preload->conv.get());
+
+    // the decoder takes it between chunks, replaced requests are freed here
+    delete m_preloadRequest.exchange(preload.release());
+    m_preloadPending = false;
+    m_wakeUp.wakeOne();
+    return true;
+}
+
+bool InputWrapper::skipToPreload()
+{
+    if (m_ringBuffer.get() == nullptr)
+        return false;
+
+    // The decoder may finish the chunk it's on,
+    // the player keeps the current song alive
+    m_skipRequest = true;
+    m_wakeUp.wakeOne();
+    return true;
+}
+
+void InputWrapper::setPaused(bool paused)
+{
+    m_paused = paused;
+    if (!paused)
+        m_wakeUp.wakeOne();
+}
+
+void InputWrapper::setBlocking(bool blocking)
+{
+    m_blocking = blocking;
+
+    // a waiting output returns right away
+    if (!blocking)
+    {
+        QMutexLocker locker(&m_mutex);
+        m_dataReady.wakeAll();
+    }
+}
+
+void InputWrapper::setOpenLatency(unsigned int ms)
+{
+    m_openLatency = ms;
 }
 
 void InputWrapper::unload()
 {
-    m_preloadedSong = nullptr;
+    delete m_preloadRequest.exchange(nullptr);
+    m_unloadRequest = true;
+    m_preloadPending = false;
 }
 
 void InputWrapper::setPosition(double pos)
 {
-    if (m_currentSong->seek(pos))
-        m_milliSeconds = static_cast<unsigned int>(pos * m_currentSong->songDuration());
+    // Seek is performed by the decoder thread
+    m_seekPos = pos;
+    m_seekTime = m_clock.nsecsElapsed();
+    m_seekState.store(seek_t::Requested, std::memory_order_release);
+    m_seekRequest = true;
+    m_wakeUp.wakeOne();
 }
 
 bool InputWrapper::setFormat(audioFormat_t format)
@@ -198,35 +1151,101 @@ bool InputWrapper::setFormat(audioFormat_t format)
     switch (format.sampleType)
     {
     case sample_t::U8:
-        m_audioProcess = new audioProcess8();
         precision = 1;
         break;
     case sample_t::S16:
-        m_audioProcess = new audioProcess16();
         precision = 2;
         break;
     case sample_t::S32:
-        m_audioProcess = new audioProcess32();
-        precision = 4;
-        break;
     case sample_t::SAMPLE_FLOAT:
-        m_audioProcess = new audioProcessFloat();
         precision = 4;
         break;
     default:
-        m_audioProcess = nullptr;
         return false;
     }
 
-    m_bytePerMilliSec = (format.sampleRate * format.channels * precision) / 1000;
+    // Channels are not remixed
+    if (m_currentSong->channels() != format.channels)
+    {
+        qWarning() << "Output channels differ from the song";
+        return false;
+    }
+
+    m_dsp.reset(dspChain::fromSettings());
+    m_dsp->init(format.sampleRate, format.channels);
+
+    // The float bus needs a final conversion to the card format
+    const bool floatCard = (format.sampleType == sample_t::U8)
+        || (format.sampleType == sample_t::S16)
+        || (format.sampleType == sample_t::SAMPLE_FLOAT);
+    const bool mixing = (SETTINGS->crossfade() > 0) || SETTINGS->trimSilence();
+    m_floatBus = floatCard && (SETTINGS->floatBus() || SETTINGS->replayGain() || !m_dsp->empty() || mixing);
+    if (!floatCard && !m_dsp->empty())
+    {
+        qWarning() << "DSP not available for the card format";
+        m_dsp.reset(new dspChain());
+    }
+
+    // integer samples are converted to little endian
+    m_swapSize = ((format.sampleType == sample_t::S16) || (format.sampleType == sample_t::S32)) ? precision : 0;
+    m_channels = format.channels;
+    const size_t frameSize = format.channels * precision;
+    m_frameSize = frameSize;
+    m_sampleRate = format.sampleRate;
+
+    m_highWatermark = (SETTINGS->highWatermark() * format.sampleRate / 1000) * frameSize;
+    m_lowWatermark = (SETTINGS->lowWatermark() * format.sampleRate / 1000) * frameSize;
+    if (m_lowWatermark >= m_highWatermark)
+        m_lowWatermark = m_highWatermark / 2;
+    // the configured refill threshold is raised when the decoder is late
+    m_minLowWatermark = m_lowWatermark;
+    m_maxLowWatermark = std::max(m_minLowWatermark, m_highWatermark / 2);
+    m_prerollSize = std::min(m_minLowWatermark, (PREROLL_TIME * format.sampleRate / 1000) * frameSize);
+    m_silenceSize = (format.sampleRate / 100) * frameSize;
+    m_silence = (format.sampleType == sample_t::U8) ? static_cast<char>(0x80) : 0;
+
+    // Songs are mixed on the float bus
+    m_crossfade = m_floatBus && mixing;
+    m_trimSilence = m_crossfade && SETTINGS->trimSilence();
+    m_fadeFrames = m_crossfade ? SETTINGS->crossfade() * format.sampleRate : 0;
+    m_minSilence = (MIN_SILENCE * format.sampleRate) / 1000;
+    m_trimWindow = (static_cast<quint64>(TRIM_WINDOW) * format.sampleRate) / 1000;
+    m_fadeBuffer.reserve(CHUNK_FRAMES * format.channels);
+    m_preloadLead = PRELOAD_MARGIN + SETTINGS->highWatermark() + (m_crossfade ? SETTINGS->crossfade() * 1000 : 0);
+
+    m_decodeBuffer.resize(CHUNK_FRAMES * frameSize);
+    m_ringBuffer.reset(new ringBuffer(m_highWatermark + m_decodeBuffer.size()));
+    qDebug() << "Ring buffer size:" << m_ringBuffer->capacity();
 
-    audioFormat_t songFormat;
-    songFormat.sampleRate = m_currentSong->samplerate();
-    songFormat.channels = m_currentSong->channels();
-    songFormat.sampleType = m_currentSong->precision();
+    m_currentSong->setFloat(m_floatBus);
+
+    if (m_floatBus)
+    {
+        qDebug() << "Using float bus";
+        m_busFormat = { format.sampleRate, format.channels, sample_t::SAMPLE_FLOAT };
+        m_outputConverter = CFACTORY->get(m_busFormat, format, 0, SETTINGS->resamplerQuality(),
+            SETTINGS->noiseShaping());
+    }
+    else
+    {
+        m_busFormat = format;
+    }
+    m_busFrameSize = m_floatBus ? format.channels * sizeof(float) : frameSize;
+    m_lookaheadSize = (LOOKAHEAD_TIME * format.sampleRate / 1000) * m_busFrameSize;
 
     // Check if soundcard supports requested samplerate
-    m_audioConverter = CFACTORY->get(songFormat, format, m_currentSong->fract());
+    m_audioConverter = songConverter(m_currentSong);
+    if ((m_audioConverter == nullptr) && needsConverter(m_currentSong))
+    {
+        qWarning() << "No conversion from the song format to the output format";
+        return false;
+    }
+
+    setGain(m_currentSong, m_audioConverter);
+
+    m_songFrames = songFrames(m_currentSong);
+    m_decodedFrames = 0;
+    m_songStats = &m_decodeStats[m_currentSong->getMetaData()->getBackendName()];
 
     return true;
 }
@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2020-2023 Leandro Nini
+ *  Copyright (C) 2020-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -19,13 +19,25 @@
 #ifndef INPUTWRAPPER_H
 #define INPUTWRAPPER_H
 
+#include <QElapsedTimer>
 #include <QIODevice>
+#include <QMutex>
+#include <QString>
+#include <QWaitCondition>
 
 #include "inputTypes.h"
 
+#include <atomic>
+#include <map>
+#include <memory>
+#include <vector>
+
 class input;
-class audioProcess;
 class converter;
+class dspChain;
+class ringBuffer;
+
+class QThread;
 
 class InputWrapper : public QIODevice
 {
@@ -37,7 +49,103 @@ signals:
     void songFinished();
 
 private:
-    qint64 fillBuffer(char *data, qint64 maxSize);
+    /// Progress of a seek as seen by the output
+    enum class seek_t
+    {
+        None,
+        Requested,  ///< old data must not be played
+        Done        ///< decoder is at the new position
+    };
+
+    /// Song queued for gapless playback with its conversion to the bus format
+    struct preload_t
+    {
+        std::shared_ptr<input> song;
+        std::unique_ptr<converter> conv;
+        /// Start of the song already decoded in the bus format
+        std::vector<char> lookahead;
+        size_t lookaheadPos;
+        bool ended;
+    };
+
+    /// Decoding time of a backend
+    struct decodeStats_t
+    {
+        quint64 chunks = 0;
+        double mean = 0.;           ///< ns/frame
+        double m2 = 0.;             ///< sum of squared deviations from the mean
+        quint64 maxNanoSeconds = 0; ///< slowest chunk
+    };
+
+private:
+    size_t fillBuffer(char *data, size_t maxSize);
+
+    /// Restart the playback clock of the current song at the given frame
+    void restartClock(quint64 frame);
+
+    /// Compute the frame at which the next song is requested
+    void updatePreloadFrame();
+
+    /// Fill with a short run of silence
+    size_t silence(char *data, size_t maxSize) const;
+
+    /// Create the converter from the song format to the bus format, null if not needed or not available
+    converter* songConverter(const input* song) const;
+
+    /// Check if the song can't be played without a converter
+    bool needsConverter(const input* song) const;
+
+    /// Decode a song through its converter into the bus
+    static size_t decodeSong(input* song, converter* conv, char* bus, size_t busSize);
+
+    /// Read from the song lookahead, then decode
+    static size_t readPreload(preload_t* song, char* bus, size_t busSize);
+
+    /// Decode a chunk of the preloaded song ahead of the switch, returns false if there's nothing to do
+    bool fillLookahead();
+
+    /// Take the preload requests posted by the GUI thread
+    void receivePreload();
+
+    /// Song length in bus frames, 0 if unknown
+    quint64 songFrames(const input* song) const;
+
+    /// Make the decoder go on with the next song, already decoded up to startFrame
+    void switchSong(preload_t* next, quint64 startFrame);
+
+    /// Mix the incoming song into the bus at the end of the current one
+    size_t crossfade(char* bus, size_t n, size_t busSize);
+
+    /// Decode frames of the incoming song
+    size_t readFadeIn(float* buffer, size_t frames);
+
+    /// Drop the leading silence of the incoming song
+    void skipSilence();
+
+    /// Switch to the preloaded song dropping what's left of the current one
+    void doSkip();
+
+    /// Decode one chunk into the ring buffer, returns false at end of stream
+    bool decode();
+
+    /// Decoder thread main loop
+    void decodeLoop();
+
+    /// Wait until there's something to play or the stream has ended
+    void waitForDecoder();
+
+    /// Account a decoded chunk and move the refill threshold accordingly
+    void adaptBuffer(qint64 nanoSeconds, size_t bytes);
+
+    unsigned int toMilliSeconds(size_t bytes) const;
+
+    void doSeek();
+
+    /// Clear the DSP and converter state after a jump in the stream
+    void resetFilters();
+
+    /// Apply the song ReplayGain in the conversion to the float bus
+    void setGain(const input* song, converter* conv);
 
 protected:
     qint64 readData(char *data, qint64 maxSize) override;
@@ -49,35 +157,184 @@ public:
     InputWrapper(input* song);
     ~InputWrapper() override;
 
-    bool tryPreload(input* newSong);
+    bool open(OpenMode mode) override;
+    void close() override;
+
+    /// Start the decoder thread
+    void startDecoder();
+
+    /// Stop the decoder thread, waiting for it to finish
+    void stopDecoder();
+
+    bool tryPreload(std::shared_ptr<input> newSong);
     void unload();
 
-    void enableBs2b();
+    /// Play the preloaded song now, returns false if nothing is playing
+    bool skipToPreload();
+
+    /// Make the decoder idle while the output is paused
+    void setPaused(bool paused);
+
+    /// Make the output wait for the decoder instead of playing silence, for outputs not bound to a device clock,
+    /// turning it off releases an output waiting
+    void setBlocking(bool blocking);
+
+    /// Time taken to open songs, the next one is requested earlier accordingly
+    void setOpenLatency(unsigned int ms);
 
     bool setFormat(audioFormat_t format);
 
-    unsigned int getPosition() const { return m_milliSeconds; }
+    /// Frames of the current song handed to the output
+    quint64 frames() const { return m_frames; }
+
+    /// Position in milliseconds of what is being heard, delay is the number of frames still queued in the output
+    unsigned int getPosition(quint64 delay = 0) const;
 
     // Set position [0,1]
     void setPosition(double pos);
 
-    void resetPosition() { m_milliSeconds = 0; }
+    void resetPosition() { m_frames = 0; }
+
+    /// Number of times the output found the ring buffer empty
+    unsigned int underruns() const { return m_underruns.load(); }
+
+    /// Number of times the decoder filled the ring buffer up
+    unsigned int overruns() const { return m_overruns.load(); }
+
+    /// Lowest amount of decoded audio found by the output, in milliseconds
+    unsigned int minFill() const;
+
+    /// Decoded audio waiting for the output, in milliseconds
+    unsigned int buffered() const;
+
+    /// Time from the last seek request to the new position being output, in milliseconds
+    unsigned int seekLatency() const { return m_seekLatency.load(); }
 
 private:
+    // song being played
     input *m_currentSong;
-    input *m_preloadedSong;
+    // song being decoded, owned by the decoder thread
+    input *m_decodingSong;
+    // song starting at m_switchPos
+    input *m_nextSong;
+    // preload handed to the decoder, which owns m_preloaded
+    std::atomic<preload_t*> m_preloadRequest;
+    std::atomic<bool> m_unloadRequest;
+    std::unique_ptr<preload_t> m_preloaded;
+    // keeps the decoding song alive if the player drops it
+    std::shared_ptr<input> m_decodingRef;
+    // lookahead left from the preload of the decoding song
+    std::vector<char> m_lookahead;
+    size_t m_lookaheadPos;
+    size_t m_lookaheadSize;
+    size_t m_busFrameSize;
 
-    audioProcess *m_audioProcess;
+    std::unique_ptr<dspChain> m_dsp;
 
     converter *m_audioConverter;
+    // float bus to card format, null without the bus
+    converter *m_outputConverter;
+
+    std::unique_ptr<ringBuffer> m_ringBuffer;
+    QByteArray m_decodeBuffer;
+
+    QThread *m_decoder;
+    QMutex m_mutex;
+    QWaitCondition m_wakeUp;
+    // signalled by the decoder to a blocking output
+    QWaitCondition m_dataReady;
+
+    std::atomic<bool> m_stopDecoder;
+    std::atomic<bool> m_endOfStream;
+    std::atomic<bool> m_seekRequest;
+    std::atomic<bool> m_skipRequest;
+    std::atomic<bool> m_paused;
+    std::atomic<bool> m_blocking;
+    // preloadSong emitted and not answered yet
+    std::atomic<bool> m_preloadPending;
+    std::atomic<double> m_seekPos;
+    std::atomic<seek_t> m_seekState;
+    // request time on m_clock, in nanoseconds
+    std::atomic<qint64> m_seekTime;
+    std::atomic<unsigned int> m_seekLatency;
+    QElapsedTimer m_clock;
+    std::atomic<quint64> m_seekFrames;
+    // stream positions of pending song switch and seek
+    std::atomic<quint64> m_switchPos;
+    std::atomic<quint64> m_discardPos;
+    // position of the next song at the switch
+    std::atomic<quint64> m_switchFrames;
+    // songs skipped to don't report the end of the previous one
+    std::atomic<bool> m_notifySwitch;
+
+    // crossfade state, owned by the decoder thread
+    bool m_crossfade;
+    bool m_trimSilence;
+    quint64 m_fadeFrames;
+    quint64 m_minSilence;
+    quint64 m_trimWindow;
+    quint64 m_songFrames;
+    quint64 m_decodedFrames;
+    quint64 m_silentFrames;
+    std::unique_ptr<preload_t> m_fadeIn;
+    quint64 m_fadeLength;
+    quint64 m_fadeStart;
+    quint64 m_fadePos;
+    quint64 m_fadeInFrames;
+    std::vector<float> m_fadeBuffer;
+    std::vector<float> m_fadePending;
+    size_t m_fadeHead;
+    size_t m_fadeCount;
+
+    // time before the song end when the next one is requested
+    unsigned int m_preloadLead;
+    std::atomic<unsigned int> m_openLatency;
+    bool m_preloadRequested;
+
+    bool m_filling;
+
+    bool m_floatBus;
+    // format produced by the song converters
+    audioFormat_t m_busFormat;
+    unsigned int m_channels;
+    // sample size to byteswap on big endian machines
+    unsigned int m_swapSize;
+
+    size_t m_highWatermark;
+    // refill threshold, adapted by the decoder within the bounds
+    std::atomic<size_t> m_lowWatermark;
+    size_t m_minLowWatermark;
+    size_t m_maxLowWatermark;
+    // decoded since the last underrun or threshold change
+    quint64 m_steadyBytes;
+    unsigned int m_lastUnderruns;
+    std::map<QString, decodeStats_t> m_decodeStats;
+    // entry of the decoding song backend, set at song switches
+    decodeStats_t* m_songStats;
+    // data needed after a seek before output resumes
+    size_t m_prerollSize;
+    size_t m_silenceSize;
+    char m_silence;
+
+    std::atomic<unsigned int> m_underruns;
+    std::atomic<unsigned int> m_overruns;
+    std::atomic<size_t> m_minFill;
 
-    int m_bytes;
-    int m_bytePerMilliSec;
-    unsigned int m_milliSeconds;
+    // playback clock of the current song in output frames,
+    // m_bytes holds a partial frame
+    std::atomic<quint64> m_frames;
+    size_t m_bytes;
+    size_t m_frameSize;
+    unsigned int m_sampleRate;
+    // frames at which updateTime and preloadSong are emitted next
+    quint64 m_nextUpdate;
+    quint64 m_preloadFrame;
+    // frames queued in the output at the last position query
+    mutable std::atomic<quint64> m_outputDelay;
 
     bool m_finished;
 
-    const unsigned int m_maxPlayTime;
+    unsigned int m_maxPlayTime;
 };
 
 #endif
@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2006-2025 Leandro Nini
+ *  Copyright (C) 2006-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -25,11 +25,7 @@
 #include "output/qaudioBackend.h"
 
 #include <QDebug>
-#include <QLabel>
-#include <QComboBox>
-#include <QLineEdit>
 #include <QStringList>
-#include <QIntValidator>
 
 /*****************************************************************/
 
@@ -46,15 +42,20 @@ const char* sampleTypeString(sample_t sampleType)
     }
 }
 
-audio::audio() :
+audio::audio(outputBackend* output) :
     m_iw(new InputWrapper(IFACTORY->get())),
-    m_audioOutput(new qaudioBackend()),
-    m_state(state_t::STOP)
+    m_audioOutput((output != nullptr) ? output : new qaudioBackend()),
+    m_state(state_t::STOP),
+    m_card(-1),
+    m_format{ 0, 0, sample_t::S16 },
+    m_outputFormat{ 0, 0, sample_t::S16 },
+    m_openLatency(0),
+    m_flushOnResume(false)
 {
     m_volume = m_settings.value(config::AUDIO_VOLUME, 50).toInt();
 
-    connect(m_audioOutput, &qaudioBackend::songEnded,  this, &audio::songEnded);
-    connect(m_audioOutput, &qaudioBackend::audioError, this, &audio::audioError);
+    connect(m_audioOutput, &outputBackend::songEnded,  this, &audio::songEnded);
+    connect(m_audioOutput, &outputBackend::audioError, this, &audio::audioError);
 }
 
 audio::~audio()
@@ -71,10 +72,25 @@ bool audio::play(input* i)
     if ((i->songLoaded().isEmpty()) || (m_state == state_t::PLAY))
         return false;
 
+    // The stream is still attached to the output
+    if (m_state == state_t::PAUSE)
+    {
+        pause();
+        return true;
+    }
+
     qDebug() << "audio::play";
 
+    int const selectedCard = m_audioOutput->findCard(SETTINGS->card());
+
+    // Synthesized formats can render at the device rate so no resampling is needed
+    const unsigned int deviceRate = m_audioOutput->cardSamplerate(selectedCard);
+    if ((deviceRate != 0) && (deviceRate != i->samplerate()) && i->setSamplerate(deviceRate))
+        qDebug() << "Rendering at device samplerate" << deviceRate;
+
     if (!i->rewind())
     {
+        m_audioOutput->close();
         throw initError("Error rewinding file");
     }
 
@@ -111,34 +127,52 @@ bool audio::play(input* i)
     connect(m_iw.data(), &InputWrapper::songFinished, this, &audio::songEnded);
     connect(m_iw.data(), &InputWrapper::updateTime,  this, &audio::updateTime);
     connect(m_iw.data(), &InputWrapper::preloadSong, this, &audio::preloadSong);
-
-    int const selectedCard = qaudioBackend::getDevices().indexOf(SETTINGS->card());
-
-    try
+    m_iw->setOpenLatency(m_openLatency);
+    m_iw->setBlocking(!m_audioOutput->isRealtime());
+
+    // An output left open by halt() is reused if the format is the same
+    const bool reuse = m_audioOutput->isStarted() && (selectedCard == m_card)
+        && (format.sampleRate == m_format.sampleRate)
+        && (format.channels == m_format.channels)
+        && (format.sampleType == m_format.sampleType);
+    if (reuse)
     {
-        audioFormat_t outputFormat = m_audioOutput->init(selectedCard, format);
+        qDebug() << "Reusing output";
+    }
+    else
+    {
+        m_audioOutput->close();
 
-        qDebug() << "Output parameters"
-            << outputFormat.sampleRate << ":" << outputFormat.channels << ":" << sampleTypeString(outputFormat.sampleType);
+        // The sink buffer grows on underruns up to the decode ahead length
+        m_audioOutput->setBufferTime(SETTINGS->bufLen(), SETTINGS->highWatermark());
 
-        if (!m_iw->setFormat(outputFormat))
+        try
         {
-            m_audioOutput->close();
-            throw initError("Unsupported sample type");
+            m_outputFormat = m_audioOutput->init(selectedCard, format);
+            m_card = selectedCard;
+            m_format = format;
+
+            qDebug() << "Output parameters"
+                << m_outputFormat.sampleRate << ":" << m_outputFormat.channels << ":" << sampleTypeString(m_outputFormat.sampleType);
+        }
+        catch (outputBackend::initError const &e)
+        {
+            throw initError(e.message());
         }
     }
-    catch (qaudioBackend::initError const &e)
+
+    if (!m_iw->setFormat(m_outputFormat))
     {
-        throw initError(e.message());
+        m_audioOutput->close();
+        throw initError("Unsupported sample type");
     }
 
-    if (SETTINGS->bs2b() && (i->channels() == 2))
-        m_iw->enableBs2b();
-
-    m_audioOutput->setVolume(m_volume);
+    if (!reuse)
+        m_audioOutput->setVolume(m_volume);
 
     // We're ready, start playback
     m_audioOutput->start(m_iw.data());
+    m_flushOnResume = false;
 
     m_state = state_t::PLAY;
 
@@ -152,11 +186,18 @@ void audio::pause()
     case state_t::PLAY:
         qDebug() << "Pause";
         m_audioOutput->pause();
+        m_iw->setPaused(true);
         m_state = state_t::PAUSE;
         break;
     case state_t::PAUSE:
         qDebug() << "Unpause";
+        m_iw->setPaused(false);
         m_audioOutput->unpause();
+        if (m_flushOnResume)
+        {
+            m_audioOutput->flush();
+            m_flushOnResume = false;
+        }
         m_state = state_t::PLAY;
         break;
     case state_t::STOP:
@@ -164,15 +205,40 @@ void audio::pause()
     }
 }
 
+bool audio::halt()
+{
+    if (m_state != state_t::PLAY)
+        return stop();
+
+    qDebug() << "audio::halt";
+
+    // An output waiting for the decoder must not hold up the detach
+    m_iw->setBlocking(false);
+
+    // The output keeps playing silence until the next stream is attached
+    m_audioOutput->detach();
+
+    m_iw->close();
+
+    m_state = state_t::STOP;
+
+    m_iw.reset(new InputWrapper(IFACTORY->get()));
+
+    return true;
+}
+
 bool audio::stop()
 {
     if (m_state == state_t::STOP)
+    {
+        // close a halted output
+        m_audioOutput->close();
         return false;
+    }
 
     qDebug() << "audio::stop";
 
-    m_audioOutput->stop();
-
+    m_iw->setBlocking(false);
     m_audioOutput->close();
 
     m_iw->close();
@@ -190,114 +256,51 @@ void audio::setVolume(int vol)
     m_audioOutput->setVolume(m_volume);
 }
 
-bool audio::gapless(input* const i) const { return m_iw->tryPreload(i); }
+bool audio::gapless(const std::shared_ptr<input>& i) const { return m_iw->tryPreload(i); }
 
-void audio::seek(double pos)
+void audio::setOpenLatency(unsigned int ms)
 {
-    m_audioOutput->pause();
-    m_iw->setPosition(pos);
-    m_audioOutput->unpause();
+    m_openLatency = ms;
+    m_iw->setOpenLatency(ms);
 }
 
-int audio::getPosition() const { return m_iw->getPosition(); }
-
-void audio::resetPosition() { m_iw->resetPosition(); }
-
-void audio::unload() { m_iw->unload(); }
-
-/*****************************************************************/
-
-audioConfig::audioConfig(QWidget* win) :
-    configFrame(win)
+void audio::seek(double pos)
 {
-    matrix()->addWidget(new QLabel(tr("Card"), this));
-    QComboBox* cardList = new QComboBox(this);
-    matrix()->addWidget(cardList);
+    m_iw->setPosition(pos);
 
+    // Audio from the old position is still queued in the sink
+    switch (m_state)
     {
-        // Get a list of audio devices
-        const deviceList_t devices = qaudioBackend::getDevices();
-        for (auto device: devices)
-            cardList->addItem(device.name.replace("\n", " - "), device.id);
-
-        int deviceCnt = devices.size();
-        cardList->setMaxVisibleItems((deviceCnt > 5) ? 5 : deviceCnt);
-
-        // Find configured device in list
-        QString card = SETTINGS->card();
-        int val = cardList->findData(card);
-        if (val >= 0) {
-            cardList->setCurrentIndex(val);
-        } else {
-            // backward compatibility
-            val = cardList->findText(card.replace("\n", " - "));
-            if (val >= 0)
-                cardList->setCurrentIndex(val);
-        }
+    case state_t::PLAY:
+        m_audioOutput->flush();
+        break;
+    case state_t::PAUSE:
+        m_flushOnResume = true;
+        break;
+    case state_t::STOP:
+        break;
     }
+}
 
-    connect(cardList, QOverload<int>::of(&QComboBox::currentIndexChanged),
-        [cardList, this](int val) {
-            QString card = cardList->itemData(val).toString();
+unsigned int audio::latency() const
+{
+    const unsigned int sampleRate = m_outputFormat.sampleRate;
+    const unsigned int queued = sampleRate ? (m_audioOutput->latency() * 1000ull) / sampleRate : 0;
+    return m_iw->buffered() + queued;
+}
 
-            qDebug() << "onCmdCard" << card;
+unsigned int audio::underruns() const { return m_iw->underruns() + m_audioOutput->underruns(); }
 
-            SETTINGS->m_card = card;
-        }
-    );
+unsigned int audio::minFill() const { return m_iw->minFill(); }
 
-    matrix()->addWidget(new QLabel(tr("Default bitdepth"), this));
-    QComboBox *bitBox = new QComboBox(this);
-    matrix()->addWidget(bitBox);
-    QStringList items;
-    items << "8" << "16";
-    bitBox->addItems(items);
-    bitBox->setMaxVisibleItems(items.size());
+int audio::getPosition() const
+{
+    // What is queued in the output has not been heard yet
+    return m_iw->getPosition(m_audioOutput->latency());
+}
 
-    {
-        unsigned int val;
-        switch (SETTINGS->bits())
-        {
-        case 8:
-            val = 0;
-            break;
-        default:
-        case 16:
-            val = 1;
-            break;
-        }
+void audio::resetPosition() { m_iw->resetPosition(); }
 
-        bitBox->setCurrentIndex(val);
-    }
+void audio::unload() { m_iw->unload(); }
 
-    connect(bitBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
-        [this](int val) {
-            switch (val)
-            {
-            case 0:
-                SETTINGS->m_bits = 8;
-                break;
-            case 1:
-                SETTINGS->m_bits = 16;
-                break;
-            }
-        }
-    );
-
-    matrix()->addWidget(new QLabel(tr("Buffer length (ms)"), this));
-    QLineEdit *bufLen = new QLineEdit(this);
-    matrix()->addWidget(bufLen);
-    bufLen->setText(QString::number(SETTINGS->bufLen()));
-    bufLen->setValidator(new QIntValidator(5, 5000, this));
-
-    connect(bufLen, &QLineEdit::editingFinished,
-        [bufLen, this]() {
-            QString val = bufLen->text();
-            unsigned int bLen = val.toUInt();
-            if (bLen)
-            {
-                SETTINGS->m_bufLen = bLen;
-            }
-        }
-    );
-}
+bool audio::skipToPreload() { return (m_state != state_t::STOP) && m_iw->skipToPreload(); }
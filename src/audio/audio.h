@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2006-2017 Leandro Nini
+ *  Copyright (C) 2006-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -26,9 +26,11 @@
 #include <QSettings>
 #include <QScopedPointer>
 
+#include <memory>
+
 class input;
 class InputWrapper;
-class qaudioBackend;
+class outputBackend;
 
 /*****************************************************************/
 
@@ -41,13 +43,23 @@ public:
 
 private:
     QScopedPointer<InputWrapper> m_iw;
-    qaudioBackend *m_audioOutput;
+    outputBackend *m_audioOutput;
     QSettings m_settings;
 
     state_t m_state;
 
     int m_volume;
 
+    // card and requested format of the open output
+    int m_card;
+    audioFormat_t m_format;
+    audioFormat_t m_outputFormat;
+
+    unsigned int m_openLatency;
+
+    // a seek while paused drops the sink buffer on resume
+    bool m_flushOnResume;
+
 private:
     audio(const audio&) = delete;
     audio& operator=(const audio&) = delete;
@@ -59,7 +71,8 @@ signals:
     void audioError(const QString&);
 
 public:
-    audio();
+    /// Play through the given output, taking ownership, or the sound card if null
+    explicit audio(outputBackend* output = nullptr);
     ~audio() override;
 
     /// Start stream
@@ -72,6 +85,9 @@ public:
     /// Stop stream
     bool stop();
 
+    /// Stop stream keeping the output open for the next play
+    bool halt();
+
     /// Get state
     state_t state() const { return m_state; }
 
@@ -82,36 +98,33 @@ public:
     int getVolume() const { return m_volume; }
 
     /// Check if gapless playback is supported
-    bool gapless(input* const i) const;
+    bool gapless(const std::shared_ptr<input>& i) const;
+
+    /// Set the expected time to open a song in milliseconds
+    void setOpenLatency(unsigned int ms);
 
     void unload();
 
+    /// Play the preloaded song now, false if there is none
+    bool skipToPreload();
+
     /// Set current position
     void seek(double pos);
 
     /// Get current position in milliseconds
     int getPosition() const;
 
-    /// Reset position
-    void resetPosition();
-};
-
-/*****************************************************************/
+    /// Time from decoding to playing, in milliseconds
+    unsigned int latency() const;
 
-#include "configFrame.h"
+    /// Number of times the decoder or the sink ran out of data
+    unsigned int underruns() const;
 
-class audioConfig : public configFrame
-{
-private:
-    audioConfig() {}
-    audioConfig(const audioConfig&) = delete;
-    audioConfig& operator=(const audioConfig&) = delete;
+    /// Lowest amount of decoded audio found by the output, in milliseconds
+    unsigned int minFill() const;
 
-    void setCards();
-
-public:
-    audioConfig(QWidget* win);
-    ~audioConfig() override = default;
+    /// Reset position
+    void resetPosition();
 };
 
 #endif
@@ -0,0 +1,246 @@
+/*
+ *  Copyright (C) 2006-2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "audioConfig.h"
+
+#include "settings.h"
+#include "output/qaudioBackend.h"
+
+#include <QCheckBox>
+#include <QLabel>
+#include <QComboBox>
+#include <QLineEdit>
+#include <QIntValidator>
+
+audioConfig::audioConfig(QWidget* win) :
+    configFrame(win)
+{
+    matrix()->addWidget(new QLabel(tr("Card"), this));
+    QComboBox* cardList = new QComboBox(this);
+    matrix()->addWidget(cardList);
+
+    {
+        // Get a list of audio devices
+        const deviceList_t devices = qaudioBackend::getDevices();
+        for (auto device: devices)
+            cardList->addItem(device.name.replace("\n", " - "), device.id);
+
+        int deviceCnt = devices.size();
+        cardList->setMaxVisibleItems((deviceCnt > 5) ? 5 : deviceCnt);
+
+        // Find configured device in list
+        QString card = SETTINGS->card();
+        int val = cardList->findData(card);
+        if (val >= 0) {
+            cardList->setCurrentIndex(val);
+        } else {
+            // backward compatibility
+            val = cardList->findText(card.replace("\n", " - "));
+            if (val >= 0)
+                cardList->setCurrentIndex(val);
+        }
+    }
+
+    connect(cardList, QOverload<int>::of(&QComboBox::currentIndexChanged),
+        [cardList, this](int val) {
+            QString card = cardList->itemData(val).toString();
+
+            qDebug() << "onCmdCard" << card;
+
+            SETTINGS->m_card = card;
+        }
+    );
+
+    matrix()->addWidget(new QLabel(tr("Default bitdepth"), this));
+    QComboBox *bitBox = new QComboBox(this);
+    matrix()->addWidget(bitBox);
+    QStringList items;
+    items << "8" << "16";
+    bitBox->addItems(items);
+    bitBox->setMaxVisibleItems(items.size());
+
+    {
+        unsigned int val;
+        switch (SETTINGS->bits())
+        {
+        case 8:
+            val = 0;
+            break;
+        default:
+        case 16:
+            val = 1;
+            break;
+        }
+
+        bitBox->setCurrentIndex(val);
+    }
+
+    connect(bitBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+        [this](int val) {
+            switch (val)
+            {
+            case 0:
+                SETTINGS->m_bits = 8;
+                break;
+            case 1:
+                SETTINGS->m_bits = 16;
+                break;
+            }
+        }
+    );
+
+    matrix()->addWidget(new QLabel(tr("Resampler quality"), this));
+    QComboBox *resamplerBox = new QComboBox(this);
+    matrix()->addWidget(resamplerBox);
+    resamplerBox->addItem(tr("Fast"), static_cast<int>(resampler_t::Fast));
+    resamplerBox->addItem(tr("Medium"), static_cast<int>(resampler_t::Medium));
+    resamplerBox->addItem(tr("Best"), static_cast<int>(resampler_t::Best));
+    resamplerBox->setMaxVisibleItems(resamplerBox->count());
+    resamplerBox->setToolTip(tr("Used when the card doesn't support the song samplerate"));
+    resamplerBox->setCurrentIndex(resamplerBox->findData(static_cast<int>(SETTINGS->resamplerQuality())));
+
+    connect(resamplerBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+        [resamplerBox, this](int val) {
+            SETTINGS->m_resamplerQuality = static_cast<resampler_t>(resamplerBox->itemData(val).toInt());
+        }
+    );
+
+    matrix()->addWidget(new QLabel(tr("Noise shaped dither"), this));
+    QCheckBox *noiseShaping = new QCheckBox(this);
+    matrix()->addWidget(noiseShaping);
+    noiseShaping->setToolTip(tr("Move the requantization noise to less audible frequencies"));
+    noiseShaping->setCheckState(SETTINGS->noiseShaping() ? Qt::Checked : Qt::Unchecked);
+
+    connect(noiseShaping,
+#if QT_VERSION >= QT_VERSION_CHECK(6, 7, 0)
+            &QCheckBox::checkStateChanged,
+        [](Qt::CheckState val)
+#else
+            &QCheckBox::stateChanged,
+        [](int val)
+#endif
+        {
+            SETTINGS->m_noiseShaping = (val == Qt::Checked);
+        }
+    );
+
+    matrix()->addWidget(new QLabel(tr("Float processing"), this));
+    QCheckBox *floatBus = new QCheckBox(this);
+    matrix()->addWidget(floatBus);
+    floatBus->setToolTip(tr("Decode and process in 32 bit float, converting to the card format once at the end"));
+    floatBus->setCheckState(SETTINGS->floatBus() ? Qt::Checked : Qt::Unchecked);
+
+    connect(floatBus,
+#if QT_VERSION >= QT_VERSION_CHECK(6, 7, 0)
+            &QCheckBox::checkStateChanged,
+        [](Qt::CheckState val)
+#else
+            &QCheckBox::stateChanged,
+        [](int val)
+#endif
+        {
+            SETTINGS->m_floatBus = (val == Qt::Checked);
+        }
+    );
+
+    matrix()->addWidget(new QLabel(tr("Crossfade (s)"), this));
+    QLineEdit *crossfade = new QLineEdit(this);
+    matrix()->addWidget(crossfade);
+    crossfade->setText(QString::number(SETTINGS->crossfade()));
+    crossfade->setToolTip(tr("Overlap the end of a song with the start of the next one, 0 to disable"));
+    crossfade->setValidator(new QIntValidator(0, 20, this));
+
+    connect(crossfade, &QLineEdit::editingFinished,
+        [crossfade, this]() {
+            SETTINGS->m_crossfade = crossfade->text().toUInt();
+        }
+    );
+
+    matrix()->addWidget(new QLabel(tr("Trim silence"), this));
+    QCheckBox *trimSilence = new QCheckBox(this);
+    matrix()->addWidget(trimSilence);
+    trimSilence->setToolTip(tr("Skip silence at the start and end of songs when switching"));
+    trimSilence->setCheckState(SETTINGS->trimSilence() ? Qt::Checked : Qt::Unchecked);
+
+    connect(trimSilence,
+#if QT_VERSION >= QT_VERSION_CHECK(6, 7, 0)
+            &QCheckBox::checkStateChanged,
+        [](Qt::CheckState val)
+#else
+            &QCheckBox::stateChanged,
+        [](int val)
+#endif
+        {
+            SETTINGS->m_trimSilence = (val == Qt::Checked);
+        }
+    );
+
+    matrix()->addWidget(new QLabel(tr("Buffer length (ms)"), this));
+    QLineEdit *bufLen = new QLineEdit(this);
+    matrix()->addWidget(bufLen);
+    bufLen->setText(QString::number(SETTINGS->bufLen()));
+    bufLen->setToolTip(tr("Output buffer, grown on underruns up to the decode ahead length"));
+    bufLen->setValidator(new QIntValidator(5, 5000, this));
+
+    connect(bufLen, &QLineEdit::editingFinished,
+        [bufLen, this]() {
+            QString val = bufLen->text();
+            unsigned int bLen = val.toUInt();
+            if (bLen)
+            {
+                SETTINGS->m_bufLen = bLen;
+            }
+        }
+    );
+
+    matrix()->addWidget(new QLabel(tr("Decode ahead (ms)"), this));
+    QLineEdit *highWatermark = new QLineEdit(this);
+    matrix()->addWidget(highWatermark);
+    highWatermark->setText(QString::number(SETTINGS->highWatermark()));
+    highWatermark->setToolTip(tr("Amount of audio decoded in advance"));
+    highWatermark->setValidator(new QIntValidator(50, 10000, this));
+
+    connect(highWatermark, &QLineEdit::editingFinished,
+        [highWatermark, this]() {
+            QString val = highWatermark->text();
+            unsigned int wm = val.toUInt();
+            if (wm)
+            {
+                SETTINGS->m_highWatermark = wm;
+            }
+        }
+    );
+
+    matrix()->addWidget(new QLabel(tr("Refill threshold (ms)"), this));
+    QLineEdit *lowWatermark = new QLineEdit(this);
+    matrix()->addWidget(lowWatermark);
+    lowWatermark->setText(QString::number(SETTINGS->lowWatermark()));
+    lowWatermark->setToolTip(tr("Decoding restarts when buffered audio drops below this, raised automatically when the decoder is late"));
+    lowWatermark->setValidator(new QIntValidator(10, 5000, this));
+
+    connect(lowWatermark, &QLineEdit::editingFinished,
+        [lowWatermark, this]() {
+            QString val = lowWatermark->text();
+            unsigned int wm = val.toUInt();
+            if (wm)
+            {
+                SETTINGS->m_lowWatermark = wm;
+            }
+        }
+    );
+}
@@ -0,0 +1,38 @@
+/*
+ *  Copyright (C) 2006-2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef AUDIOCONFIG_H
+#define AUDIOCONFIG_H
+
+#include "configFrame.h"
+
+class audioConfig : public configFrame
+{
+private:
+    audioConfig() {}
+    audioConfig(const audioConfig&) = delete;
+    audioConfig& operator=(const audioConfig&) = delete;
+
+    void setCards();
+
+public:
+    audioConfig(QWidget* win);
+    ~audioConfig() override = default;
+};
+
+#endif
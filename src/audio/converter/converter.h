@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2009-2023 Leandro Nini
+ *  Copyright (C) 2009-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -28,7 +28,8 @@ class converter
 {
 protected:
     const unsigned int m_channels;
-    const unsigned int m_frameRatio;
+    const unsigned int m_inputPrecision;
+    const unsigned int m_outputPrecision;
 
     QByteArray m_buffer;
 
@@ -39,10 +40,11 @@ protected:
 protected:
     converter(unsigned int channels, unsigned int inputPrecision, unsigned int outputPrecision) :
         m_channels(channels),
-        m_frameRatio(inputPrecision/outputPrecision),
+        m_inputPrecision(inputPrecision),
+        m_outputPrecision(outputPrecision),
         m_inputSize(0)
     {
-        qDebug() << "Frame ratio" << m_frameRatio;
+        qDebug() << "Sample size" << m_inputPrecision << "->" << m_outputPrecision;
         m_buffer.reserve(INIT_BUFFER_SIZE);
     }
 
@@ -57,6 +59,12 @@ public:
 
     /// Do the conversion
     virtual size_t convert(const void* out, size_t len) =0;
+
+    /// Set a gain applied during conversion, returns false if not supported
+    virtual bool setGain([[maybe_unused]] float gain) { return false; }
+
+    /// Drop the state left by previous input
+    virtual void reset() {}
 };
 
 #endif
@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2009-2023 Leandro Nini
+ *  Copyright (C) 2009-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -18,44 +18,124 @@
 
 #include "converterBackend.h"
 
+#include "simd.h"
+
 #include <QDebug>
 
-resamplerBackend::resamplerBackend(unsigned int srIn, unsigned int srOut,
-        unsigned int channels, unsigned int inputPrecision, unsigned int outputPrecision) :
+#include <algorithm>
+#include <numeric>
+
+resamplerBackend::resamplerBackend(unsigned int srIn, unsigned int srOut, unsigned int channels,
+        unsigned int inputPrecision, unsigned int outputPrecision, resampler_t quality) :
     converter(channels, inputPrecision, outputPrecision),
-    m_dataPos(0),
+    m_filter(polyphaseFilter::get(srIn, srOut, quality)),
+    m_index(0),
+    m_num(0),
+    m_history(channels),
+    m_maxFrames(0),
+    m_flushed(false),
     m_inputFrameSize(inputPrecision*m_channels),
     m_outputFrameSize(outputPrecision*m_channels)
 {
-    qDebug() << "Conversion ratio " << (float)(srIn/srOut);
+    const unsigned int gcd = std::gcd(srIn, srOut);
+    m_step = srIn / gcd;
+    m_den = srOut / gcd;
+    qDebug() << "Resampling" << srIn << "->" << srOut << "using" << simd::name();
 
-    m_rate = (((unsigned int)srIn)<<16)/srOut;
-    qDebug() << "m_rate " << m_rate;
+    prime();
 }
 
 resamplerBackend::~resamplerBackend() = default;
 
-void resamplerBackend::setBufferSize(size_t size)
+void resamplerBackend::prime()
 {
-    m_inputSize = size;
-
-    size_t const frames = size / m_outputFrameSize;
-    unsigned long tmp = ((unsigned long)frames * (unsigned long)m_rate);
-    if (tmp & 0xFFFFll)
-        tmp += 0x10000ll;
+    // prime with silence so the first output is aligned to the first input
+    for (auto& history: m_history)
+        history.assign(m_filter->taps()/2 - 1, 0.f);
+}
 
-    size_t const bufferSize = (tmp>>16) * m_inputFrameSize;
-    qDebug() << "resampler buffer size:" << bufferSize;
-    m_buffer.resize(bufferSize);
+void resamplerBackend::reset()
+{
+    m_index = 0;
+    m_num = 0;
+    m_flushed = false;
+    prime();
 }
 
 size_t resamplerBackend::bufSize(size_t size)
 {
-    if (size > m_inputSize)
+    m_maxFrames = std::max<size_t>(size / m_outputFrameSize, 1);
+
+    // input needed up to the last output frame, plus one for phase rounding
+    const size_t last = m_index + (m_num + static_cast<quint64>(m_maxFrames - 1) * m_step) / m_den + 1;
+    const size_t needed = last + m_filter->taps();
+    const size_t available = m_history[0].size();
+
+    // always ask for something, an empty read means end of stream
+    const size_t bytes = ((needed > available) ? needed - available : 1) * m_inputFrameSize;
+    if (bytes > static_cast<size_t>(m_buffer.size()))
+        m_buffer.resize(bytes);
+    return bytes;
+}
+
+void resamplerBackend::flush()
+{
+    for (auto& history: m_history)
+        history.resize(history.size() + m_filter->taps()/2, 0.f);
+}
+
+size_t resamplerBackend::filter()
+{
+    const unsigned int taps = m_filter->taps();
+    const unsigned int phases = m_filter->phases();
+    const size_t available = m_history[0].size();
+
+    m_output.resize(m_maxFrames * m_channels);
+    float* out = m_output.data();
+
+    size_t frames = 0;
+    while (frames < m_maxFrames)
     {
-        setBufferSize(size);
+        size_t base = m_index;
+        unsigned int phase;
+        if (phases == m_den)
+        {
+            phase = m_num;
+        }
+        else
+        {
+            // too many phases for an exact table, take the nearest one
+            phase = (static_cast<quint64>(m_num) * phases + m_den/2) / m_den;
+            if (phase == phases)
+            {
+                phase = 0;
+                base++;
+            }
+        }
+
+        if (base + taps > available)
+            break;
+
+        const float* const h = m_filter->phase(phase);
+        for (unsigned int c=0; c<m_channels; c++)
+            *out++ = simd::dot(m_history[c].data() + base, h, taps);
+
+        frames++;
+        m_num += m_step;
+        m_index += m_num / m_den;
+        m_num %= m_den;
+    }
+
+    // drop consumed input
+    const size_t consumed = std::min(m_index, available);
+    if (consumed > 0)
+    {
+        for (auto& history: m_history)
+            history.erase(history.begin(), history.begin() + consumed);
+        m_index -= consumed;
     }
-    return (size*m_frameRatio)-m_dataPos;
+
+    return frames;
 }
 
 /******************************************************************************/
@@ -71,7 +151,7 @@ void converterBackend::setBufferSize(size_t size)
 {
     m_inputSize = size;
 
-    size_t const bufferSize = size * m_frameRatio;
+    size_t const bufferSize = size / m_outputPrecision * m_inputPrecision;
     qDebug() << "converter buffer size:" << bufferSize;
     m_buffer.resize(bufferSize);
 }
@@ -82,5 +162,5 @@ size_t converterBackend::bufSize(size_t size)
     {
         setBufferSize(size);
     }
-    return size*m_frameRatio;
+    return size / m_outputPrecision * m_inputPrecision;
 }
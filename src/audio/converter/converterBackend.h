@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2009-2023 Leandro Nini
+ *  Copyright (C) 2009-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -20,13 +20,34 @@
 #define CONVERTERPLUGIN_H
 
 #include "converter.h"
+#include "polyphase.h"
+
+#include <memory>
+#include <vector>
 
 class resamplerBackend : public converter
 {
 protected:
-    unsigned int m_rate;
+    std::shared_ptr<const polyphaseFilter> m_filter;
+
+    /// Input frames per output frame as reduced m_step/m_den ratio
+    unsigned int m_step;
+    unsigned int m_den;
+
+    /// Position of the next output frame, in input frames
+    size_t m_index;
+    unsigned int m_num;
+
+    /// Deinterleaved input not yet consumed
+    std::vector<std::vector<float>> m_history;
+
+    /// Filtered output, interleaved
+    std::vector<float> m_output;
+
+    /// Max frames to produce in next convert
+    size_t m_maxFrames;
 
-    unsigned int m_dataPos;
+    bool m_flushed;
 
     const unsigned int m_inputFrameSize;
     const unsigned int m_outputFrameSize;
@@ -37,19 +58,29 @@ private:
     resamplerBackend& operator=(const resamplerBackend&) = delete;
 
 protected:
-    resamplerBackend(unsigned int srIn, unsigned int srOut,
-        unsigned int channels, unsigned int inputPrecision, unsigned int outputPrecision);
+    resamplerBackend(unsigned int srIn, unsigned int srOut, unsigned int channels,
+        unsigned int inputPrecision, unsigned int outputPrecision, resampler_t quality);
 
-    void setBufferSize(size_t size);
+    /// Pad the input with silence to drain the filter
+    void flush();
+
+    /// Filter available input into m_output, return produced frames
+    size_t filter();
+
+    /// Fill the filter history with silence
+    void prime();
 
 public:
     ~resamplerBackend() override;
 
     /// Get pointer to buffer
-    char* buffer() override { return m_buffer.data()+m_dataPos; }
+    char* buffer() override { return m_buffer.data(); }
 
     /// Get buffer size
     size_t bufSize(size_t size) override;
+
+    /// Clear the filter history
+    void reset() override;
 };
 
 /******************************************************************************/
@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2009-2023 Leandro Nini
+ *  Copyright (C) 2009-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -24,6 +24,22 @@
 
 #include "converters.h"
 
+#include <cmath>
+
+namespace
+{
+/// Scale to the float bus, resampling if needed
+template <typename I>
+converter* toFloat(audioFormat_t inFormat, audioFormat_t outFormat, float scale, resampler_t quality)
+{
+    if (inFormat.sampleRate != outFormat.sampleRate)
+        return (converter*)new resampler<I, float>(inFormat.sampleRate, outFormat.sampleRate,
+            outFormat.channels, new quantizerToFloat<float>(scale), quality);
+    else
+        return (converter*)new converterDecimal<I, float>(outFormat.channels, new quantizerToFloat<I>(scale));
+}
+}
+
 cFactory* cFactory::instance()
 {
     static cFactory o;
@@ -31,19 +47,43 @@ cFactory* cFactory::instance()
 }
 
 converter* cFactory::get(audioFormat_t inFormat, audioFormat_t outFormat,
-        unsigned int fract)
+        unsigned int fract, resampler_t quality, bool noiseShaping)
 {
+    if ((outFormat.sampleType == sample_t::SAMPLE_FLOAT) && (inFormat.sampleType != sample_t::SAMPLE_FLOAT))
+    {
+        qDebug() << "converter to float";
+        switch (inFormat.sampleType)
+        {
+        case sample_t::U8:
+            return toFloat<unsigned char>(inFormat, outFormat, 1.f/128.f, quality);
+        case sample_t::S16:
+            return toFloat<short>(inFormat, outFormat, 1.f/32768.f, quality);
+        case sample_t::S32:
+            return toFloat<int>(inFormat, outFormat, std::ldexp(1.f, -31), quality);
+        case sample_t::SAMPLE_FIXED:
+            return toFloat<int>(inFormat, outFormat, std::ldexp(1.f, -static_cast<int>(fract)), quality);
+        default:
+            return nullptr;
+        }
+    }
+
+    // below here samples are only resampled to the same type
+    // or quantized to U8 or S16, anything else isn't supported
     switch (inFormat.sampleType)
     {
     case sample_t::U8:
+        if (outFormat.sampleType != sample_t::U8)
+            return nullptr;
         return (inFormat.sampleRate != outFormat.sampleRate)
             ? new resampler<unsigned char, unsigned char>(inFormat.sampleRate, outFormat.sampleRate,
-                outFormat.channels, new quantizerVoid<unsigned char>())
+                outFormat.channels, new quantizerVoid<unsigned char>(), quality)
             : nullptr;
     case sample_t::S16:
+        if (outFormat.sampleType != sample_t::S16)
+            return nullptr;
         return (inFormat.sampleRate != outFormat.sampleRate)
             ? new resampler<short, short>(inFormat.sampleRate, outFormat.sampleRate,
-                outFormat.channels, new quantizerVoid<short>())
+                outFormat.channels, new quantizerVoid<short>(), quality)
             : nullptr;
     case sample_t::S24:
     case sample_t::S32:
@@ -55,32 +95,34 @@ converter* cFactory::get(audioFormat_t inFormat, audioFormat_t outFormat,
             {
                 qDebug() << "resampler float->U8";
                 return (converter*)new resampler<float, unsigned char>(inFormat.sampleRate, outFormat.sampleRate,
-                    outFormat.channels, new quantizerFloat<unsigned char>());
+                    outFormat.channels, new quantizerFloat<unsigned char>(noiseShaping), quality);
             }
             else if (outFormat.sampleType == sample_t::S16)
             {
                 qDebug() << "resampler float->S16";
                 return (converter*)new resampler<float, short>(inFormat.sampleRate, outFormat.sampleRate,
-                    outFormat.channels, new quantizerFloat<short>());
+                    outFormat.channels, new quantizerFloat<short>(noiseShaping), quality);
             }
-            else
+            else if (outFormat.sampleType == sample_t::SAMPLE_FLOAT)
             {
                 qDebug() << "resampler float->float";
                 return (converter*)new resampler<float, float>(inFormat.sampleRate, outFormat.sampleRate,
-                    outFormat.channels, new quantizerVoid<float>());
+                    outFormat.channels, new quantizerToFloat<float>(1.f), quality);
             }
+            else
+                return nullptr;
         }
         else
         {
             if (outFormat.sampleType == sample_t::U8)
             {
                 qDebug() << "converter float->U8";
-                return (converter*)new converterDecimal<float, unsigned char>(outFormat.channels, new quantizerFloat<unsigned char>());
+                return (converter*)new converterDecimal<float, unsigned char>(outFormat.channels, new quantizerFloat<unsigned char>(noiseShaping));
             }
             else if (outFormat.sampleType == sample_t::S16)
             {
                 qDebug() << "converter float->S16";
-                return (converter*)new converterDecimal<float, short>(outFormat.channels, new quantizerFloat<short>());
+                return (converter*)new converterDecimal<float, short>(outFormat.channels, new quantizerFloat<short>(noiseShaping));
             }
             else
                 return nullptr;
@@ -92,29 +134,48 @@ converter* cFactory::get(audioFormat_t inFormat, audioFormat_t outFormat,
             {
                 qDebug() << "resampler fixed->U8";
                 return (converter*)new resampler<int, unsigned char>(inFormat.sampleRate, outFormat.sampleRate,
-                    outFormat.channels, new quantizerFixed<unsigned char>(fract));
+                    outFormat.channels, new quantizerFixed<unsigned char>(fract, noiseShaping), quality);
             }
-            else
+            else if (outFormat.sampleType == sample_t::S16)
             {
                 qDebug() << "resampler fixed->S16";
                 return (converter*)new resampler<int, short>(inFormat.sampleRate, outFormat.sampleRate,
-                    outFormat.channels, new quantizerFixed<short>(fract));
+                    outFormat.channels, new quantizerFixed<short>(fract, noiseShaping), quality);
             }
+            else
+                return nullptr;
         }
         else
         {
             if (outFormat.sampleType == sample_t::U8)
             {
                 qDebug() << "converter fixed->U8";
-                return (converter*)new converterDecimal<int, unsigned char>(outFormat.channels, new quantizerFixed<unsigned char>(fract));
+                return (converter*)new converterDecimal<int, unsigned char>(outFormat.channels, new quantizerFixed<unsigned char>(fract, noiseShaping));
             }
-            else
+            else if (outFormat.sampleType == sample_t::S16)
             {
                 qDebug() << "converter fixed->S16";
-                return (converter*)new converterDecimal<int, short>(outFormat.channels, new quantizerFixed<short>(fract));
+                return (converter*)new converterDecimal<int, short>(outFormat.channels, new quantizerFixed<short>(fract, noiseShaping));
             }
+            else
+                return nullptr;
         }
     default:
         return nullptr;
     }
 }
+
+converter* cFactory::getGain(audioFormat_t format)
+{
+    switch (format.sampleType)
+    {
+    case sample_t::SAMPLE_FLOAT:
+        qDebug() << "converter float gain";
+        return (converter*)new converterDecimal<float, float>(format.channels, new quantizerToFloat<float>(1.f));
+    case sample_t::S32:
+        qDebug() << "converter S32 gain";
+        return (converter*)new converterDecimal<int, int>(format.channels, new quantizerGain<int>());
+    default:
+        return nullptr;
+    }
+}
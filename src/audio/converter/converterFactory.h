@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2009-2023 Leandro Nini
+ *  Copyright (C) 2009-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -36,10 +36,12 @@ public:
     /// Get singleton instance
     static cFactory* instance();
 
-    /// Instantiate backend
+    /// Instantiate backend, null if not needed or if there's no conversion to the output type
     converter* get(audioFormat_t inFormat, audioFormat_t outFormat,
-        unsigned int fract);
+        unsigned int fract, resampler_t quality, bool noiseShaping);
 
+    /// Converter only applying gain, for float or S32 samples, null otherwise
+    converter* getGain(audioFormat_t format);
 };
 
 #endif
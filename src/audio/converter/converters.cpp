@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2009-2021 Leandro Nini
+ *  Copyright (C) 2009-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -18,41 +18,78 @@
 
 #include "converters.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+namespace
+{
+// Filtering runs on float in the input scale, unsigned samples are centered
+template <typename T> inline float toFloat(T sample) { return sample; }
+template <> inline float toFloat(unsigned char sample) { return static_cast<int>(sample) - 128; }
+
+template <typename T> inline T fromFloat(float sample) { return sample; }
+template <> inline unsigned char fromFloat(float sample)
+{
+    return static_cast<unsigned char>(std::clamp(std::lrint(sample), -128L, 127L) + 128);
+}
+template <> inline short fromFloat(float sample)
+{
+    return static_cast<short>(std::clamp(std::lrint(sample), -32768L, 32767L));
+}
+template <> inline int fromFloat(float sample)
+{
+    return static_cast<int>(std::clamp(std::llrint(sample),
+        static_cast<long long>(std::numeric_limits<int>::min()),
+        static_cast<long long>(std::numeric_limits<int>::max())));
+}
+}
+
 template <typename I, typename O>
 size_t resampler<I, O>::convert(const void* buf, size_t len)
 {
-    I* const in = (I*)m_buffer.data();
-    O* const out = (O*)buf;
-
-    size_t idx = 0;
-    unsigned int error = 0;
-    const size_t samples = len/sizeof(I);
-    for (size_t j=0; j<samples; j+=m_channels)
+    const size_t frames = len/m_inputFrameSize;
+    if (frames == 0)
     {
+        // end of stream, drain the filter once
+        if (m_flushed)
+            return 0;
+        flush();
+        m_flushed = true;
+    }
+    else
+    {
+        m_flushed = false;
+
+        const I* const in = (const I*)m_buffer.data();
         for (unsigned int c=0; c<m_channels; c++)
         {
-            const I val = in[idx+c];
-            out[j+c] = _quantizer->get(val+(I)(((unsigned int)(in[idx+c+m_channels]-val)*error)>>16), c);
-        }
-        error += m_rate;
-        while (error >= 0x10000)
-        {
-            error -= 0x10000;
-            idx += m_channels;
+            std::vector<float>& history = m_history[c];
+            const size_t pos = history.size();
+            history.resize(pos + frames);
+            for (size_t j=0; j<frames; j++)
+                history[pos+j] = toFloat<I>(in[j*m_channels+c]);
         }
     }
 
-    const size_t l = m_buffer.size()/sizeof(I);
-    qDebug().nospace() << "resamplerDecimal idx: " << static_cast<int>(idx) << ", l: " << static_cast<int>(l);
+    const size_t produced = filter();
 
-    m_dataPos = (l < idx) ? (l-idx)*sizeof(I) : 0;
-    for (size_t j=idx; j<l; j+=m_channels)
+    O* const out = (O*)buf;
+    if constexpr (std::is_same_v<filtered_t<I, O>, float>)
     {
-        for (unsigned int c=0; c<m_channels; c++)
-            in[c] = in[j+c];
+        _quantizer->process(m_output.data(), out, produced, m_channels);
+    }
+    else
+    {
+        const size_t samples = produced*m_channels;
+        m_samples.resize(samples);
+        for (size_t j=0; j<samples; j++)
+            m_samples[j] = fromFloat<I>(m_output[j]);
+        _quantizer->process(m_samples.data(), out, produced, m_channels);
     }
 
-    return samples * sizeof(O);
+    return produced * m_outputFrameSize;
 }
 
 template size_t resampler<unsigned char, unsigned char>::convert(const void* buf, const size_t len);
@@ -62,6 +99,9 @@ template size_t resampler<int, short>::convert(const void* buf, const size_t len
 template size_t resampler<float, unsigned char>::convert(const void* buf, const size_t len);
 template size_t resampler<float, short>::convert(const void* buf, const size_t len);
 template size_t resampler<float, float>::convert(const void* buf, const size_t len);
+template size_t resampler<unsigned char, float>::convert(const void* buf, const size_t len);
+template size_t resampler<short, float>::convert(const void* buf, const size_t len);
+template size_t resampler<int, float>::convert(const void* buf, const size_t len);
 
 /******************************************************************************/
 
@@ -72,13 +112,7 @@ size_t converterDecimal<I, O>::convert(const void* buf, size_t len)
     O* const out = (O*)buf;
 
     const size_t samples = len/sizeof(I);
-    for (size_t j=0; j<samples; j+=m_channels)
-    {
-        for (unsigned int c=0; c<m_channels; c++)
-        {
-            out[j+c] = _quantizer->get(in[j+c], c);
-        }
-    }
+    _quantizer->process(in, out, samples/m_channels, m_channels);
 
     return samples * sizeof(O);
 }
@@ -87,3 +121,8 @@ template size_t converterDecimal<int, unsigned char>::convert(const void* buf, c
 template size_t converterDecimal<int, short>::convert(const void* buf, const size_t len);
 template size_t converterDecimal<float, unsigned char>::convert(const void* buf, const size_t len);
 template size_t converterDecimal<float, short>::convert(const void* buf, const size_t len);
+template size_t converterDecimal<unsigned char, float>::convert(const void* buf, const size_t len);
+template size_t converterDecimal<short, float>::convert(const void* buf, const size_t len);
+template size_t converterDecimal<int, float>::convert(const void* buf, const size_t len);
+template size_t converterDecimal<float, float>::convert(const void* buf, const size_t len);
+template size_t converterDecimal<int, int>::convert(const void* buf, const size_t len);
@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2009-2020 Leandro Nini
+ *  Copyright (C) 2009-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -22,24 +22,40 @@
 #include "converterBackend.h"
 #include "quantizer.h"
 
+#include <type_traits>
+#include <vector>
+
+/// Filtered frames go to the float bus as they are, otherwise back to the input type
+template <typename I, typename O>
+using filtered_t = std::conditional_t<std::is_same_v<O, float>, float, I>;
+
 template <typename I, typename O>
 class resampler : public resamplerBackend
 {
-    quantizer<I, O>* _quantizer;
+    quantizer<filtered_t<I, O>, O>* _quantizer;
+
+    /// Filtered frames converted back to the input type
+    std::vector<I> m_samples;
 
 private:
     void init(unsigned int fract);
 
 public:
     resampler(unsigned int srIn, unsigned int srOut,
-        unsigned int channels, quantizer<I, O>* quantizer) :
-        resamplerBackend(srIn, srOut, channels, sizeof(I), sizeof(O)),
+        unsigned int channels, quantizer<filtered_t<I, O>, O>* quantizer, resampler_t quality) :
+        resamplerBackend(srIn, srOut, channels, sizeof(I), sizeof(O), quality),
         _quantizer(quantizer)
     {}
     ~resampler() override { delete _quantizer; }
 
     /// Do the conversion
     size_t convert(const void* buf, size_t len) override;
+
+    /// Set a gain applied during conversion
+    bool setGain(float gain) override { return _quantizer->setGain(gain); }
+
+    /// Clear the filter history and the quantizer state
+    void reset() override { resamplerBackend::reset(); _quantizer->reset(); }
 };
 
 /******************************************************************************/
@@ -61,6 +77,12 @@ public:
 
     /// Do the conversion
     size_t convert(const void* buf, size_t len) override;
+
+    /// Set a gain applied during conversion
+    bool setGain(float gain) override { return _quantizer->setGain(gain); }
+
+    /// Clear the quantizer state
+    void reset() override { _quantizer->reset(); }
 };
 
 #endif
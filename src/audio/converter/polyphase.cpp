@@ -0,0 +1,133 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "polyphase.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <numeric>
+#include <tuple>
+
+namespace
+{
+constexpr double PI = 3.14159265358979323846;
+
+struct preset_t
+{
+    unsigned int taps;  ///< filter length at the lower rate
+    double rolloff;     ///< cutoff relative to the lower Nyquist
+    double beta;        ///< Kaiser window parameter
+};
+
+// stopband attenuation is about beta/0.1102+8.7 dB
+const preset_t presets[] =
+{
+    {  24, 0.85,  6. }, // Fast, ~63dB
+    {  64, 0.90,  8. }, // Medium, ~81dB
+    { 160, 0.95, 10. }, // Best, ~99dB
+};
+
+constexpr unsigned int MAX_TAPS = 1024;
+
+/// Zeroth order modified Bessel function of the first kind
+double besselI0(double x)
+{
+    double sum = 1.;
+    double term = 1.;
+    const double x2 = x * x / 4.;
+    for (int k = 1; k < 64; k++)
+    {
+        term *= x2 / (k * k);
+        sum += term;
+        if (term < sum * 1e-12)
+            break;
+    }
+    return sum;
+}
+
+QMutex cacheMutex;
+std::map<std::tuple<unsigned int, unsigned int, resampler_t>, std::weak_ptr<const polyphaseFilter>> cache;
+} // namespace
+
+polyphaseFilter::polyphaseFilter(unsigned int phases, unsigned int taps, double cutoff, double beta) :
+    m_coeffs(static_cast<size_t>(phases) * taps),
+    m_phases(phases),
+    m_taps(taps)
+{
+    const double half = taps / 2.;
+    const double norm = 1. / besselI0(beta);
+
+    for (unsigned int p = 0; p < phases; p++)
+    {
+        float* const h = m_coeffs.data() + static_cast<size_t>(p) * taps;
+        double sum = 0.;
+        for (unsigned int k = 0; k < taps; k++)
+        {
+            // distance from the output point, in input samples
+            const double x = (half - 1. - k) + static_cast<double>(p) / phases;
+            const double sinc = (x == 0.) ? 1. : std::sin(PI * cutoff * x) / (PI * cutoff * x);
+            const double r = x / half;
+            const double window = (std::fabs(r) < 1.) ? besselI0(beta * std::sqrt(1. - r*r)) * norm : 0.;
+            const double c = cutoff * sinc * window;
+            h[k] = static_cast<float>(c);
+            sum += c;
+        }
+
+        // unity gain at DC for every phase
+        for (unsigned int k = 0; k < taps; k++)
+            h[k] = static_cast<float>(h[k] / sum);
+    }
+}
+
+std::shared_ptr<const polyphaseFilter> polyphaseFilter::get(unsigned int srIn, unsigned int srOut, resampler_t quality)
+{
+    const auto key = std::make_tuple(srIn, srOut, quality);
+
+    QMutexLocker locker(&cacheMutex);
+
+    auto it = cache.find(key);
+    if (it != cache.end())
+    {
+        if (auto filter = it->second.lock())
+            return filter;
+    }
+
+    const preset_t& preset = presets[static_cast<int>(quality)];
+
+    const unsigned int phases = std::min(srOut / std::gcd(srIn, srOut), MAX_PHASES);
+
+    // when downsampling the filter stretches to keep the transition band
+    const double ratio = static_cast<double>(srOut) / srIn;
+    const double cutoff = preset.rolloff * std::min(1., ratio);
+    unsigned int taps = static_cast<unsigned int>(std::ceil(preset.taps / std::min(1., ratio)));
+    taps = std::min((taps + 7) & ~7u, MAX_TAPS);
+
+    QElapsedTimer timer;
+    timer.start();
+    std::shared_ptr<const polyphaseFilter> filter(new polyphaseFilter(phases, taps, cutoff, preset.beta));
+    qDebug() << "Polyphase filter" << srIn << "->" << srOut << ":" << phases << "phases," << taps << "taps in" << timer.elapsed() << "ms";
+
+    cache[key] = filter;
+    return filter;
+}
@@ -0,0 +1,63 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef POLYPHASE_H
+#define POLYPHASE_H
+
+#include "inputTypes.h"
+
+#include <memory>
+#include <vector>
+
+/**
+ * Kaiser windowed sinc lowpass, split into phases.
+ * Tables are shared between resamplers with the same parameters.
+ */
+class polyphaseFilter
+{
+private:
+    /// Upper bound for the number of phases,
+    /// ratios needing more are rounded to the nearest phase
+    static constexpr unsigned int MAX_PHASES = 1024;
+
+private:
+    std::vector<float> m_coeffs;
+
+    unsigned int m_phases;
+    unsigned int m_taps;
+
+private:
+    polyphaseFilter(unsigned int phases, unsigned int taps, double cutoff, double beta);
+    polyphaseFilter(const polyphaseFilter&) = delete;
+    polyphaseFilter& operator=(const polyphaseFilter&) = delete;
+
+public:
+    /// Get the filter for the given conversion
+    static std::shared_ptr<const polyphaseFilter> get(unsigned int srIn, unsigned int srOut, resampler_t quality);
+
+    /// Number of phases
+    unsigned int phases() const { return m_phases; }
+
+    /// Number of taps for each phase, a multiple of 8
+    unsigned int taps() const { return m_taps; }
+
+    /// Get coefficients for phase i
+    const float* phase(unsigned int i) const { return m_coeffs.data() + i*m_taps; }
+};
+
+#endif
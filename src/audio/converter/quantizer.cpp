@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2006-2021 Leandro Nini
+ *  Copyright (C) 2006-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -19,94 +19,200 @@
 #include "quantizer.h"
 
 #include <algorithm>
+#include <cmath>
 #include <limits>
 
-// LCG
-unsigned int random(unsigned int val)
+namespace
 {
-    return val * 1664525 + 1013904223;
-}
+// Error feedback filter pushing the noise above 15kHz (Wannamaker, 3 taps)
+constexpr float SHAPING[] = { 1.623f, -0.982f, 0.109f };
 
-template<typename O>
-quantizerFixed<O>::quantizerFixed(const unsigned int fract)
-{
-    _random[0][0] = 3686734;
-    _random[0][1] = 86526882;
-    _random[1][0] = 268268;
-    _random[1][1] = 7628932;
-
-    qDebug() << "quantizerFixed" << static_cast<int>(sizeof(O)) << "bytes";
-    _scalebits = fract+1-(sizeof(O)<<3);
-    _mask = (1L<<_scalebits)-1;
-    _clip = (1L<<fract);
-}
+template <typename O> constexpr float fullScale();
+template <> constexpr float fullScale<unsigned char>() { return 128.f; }
+template <> constexpr float fullScale<short>() { return 32768.f; }
 
-template quantizerFixed<unsigned char>::quantizerFixed(const unsigned int fract);
-template quantizerFixed<short>::quantizerFixed(const unsigned int fract);
+/// Round, saturate and store a block of samples in output LSB units
+template <typename O> void store(const float* in, O* out, size_t n);
 
-template<typename O>
-inline int quantizerFixed<O>::get32(const int sample, const unsigned int channel)
+template <>
+void store(const float* in, short* out, size_t n)
 {
-    _random[channel][0] = random(_random[channel][0]);
-    _random[channel][1] = random(_random[channel][1]);
+    simd::toS16(in, out, n);
+}
 
-    // Dither
-    int output = sample + (_random[channel][0]&_mask) + (_random[channel][1]&_mask);
+template <>
+void store(const float* in, unsigned char* out, size_t n)
+{
+    for (size_t i=0; i<n; i++)
+        out[i] = static_cast<unsigned char>(std::lrint(std::clamp(in[i], -128.f, 127.f)) + 128);
+}
+}
 
-    return std::clamp(output, -_clip, _clip-1);
+template <typename I, typename O>
+quantizerDither<I, O>::quantizerDither(float scale, bool noiseShaping) :
+    m_scale(scale),
+    m_noiseShaping(noiseShaping)
+{
+    qDebug() << "quantizerDither" << static_cast<int>(sizeof(O)) << "bytes, noise shaping" << noiseShaping;
 }
 
-template<>
-unsigned char quantizerFixed<unsigned char>::get(const int sample, const unsigned int channel)
+template <typename I, typename O>
+void quantizerDither<I, O>::process(const I* in, O* out, size_t frames, unsigned int channels)
 {
-    return (unsigned char)(get32(sample, channel)>>_scalebits)+128;
+    const size_t samples = BLOCK_FRAMES * channels;
+    if (m_noise.size() < samples)
+    {
+        m_noise.resize(samples);
+        m_scaled.resize(samples);
+        m_error.assign(channels * SHAPING_TAPS, 0.f);
+    }
+
+    switch (channels)
+    {
+    case 1:
+        block<1>(in, out, frames, channels);
+        break;
+    case 2:
+        block<2>(in, out, frames, channels);
+        break;
+    default:
+        block<0>(in, out, frames, channels);
+        break;
+    }
 }
 
-template<>
-short quantizerFixed<short>::get(const int sample, const unsigned int channel)
+template <typename I, typename O>
+template <unsigned int CH>
+void quantizerDither<I, O>::block(const I* in, O* out, size_t frames, unsigned int channels)
 {
-    return (short)(get32(sample, channel)>>_scalebits);
+    // compile time channel count when specialized
+    const unsigned int ch = CH ? CH : channels;
+    constexpr float lo = -fullScale<O>();
+    constexpr float hi = fullScale<O>() - 1.f;
+
+    float* const noise = m_noise.data();
+    float* const scaled = m_scaled.data();
+
+    while (frames > 0)
+    {
+        const size_t n = std::min(frames, BLOCK_FRAMES);
+        const size_t samples = n * ch;
+
+        simd::tpdf(noise, samples, m_rng);
+
+        if (!m_noiseShaping)
+        {
+            for (size_t i=0; i<samples; i++)
+                scaled[i] = static_cast<float>(in[i]) * m_scale + noise[i];
+        }
+        else
+        {
+            for (size_t i=0; i<samples; i+=ch)
+            {
+                for (unsigned int c=0; c<ch; c++)
+                {
+                    float* const e = m_error.data() + c*SHAPING_TAPS;
+                    const float y = static_cast<float>(in[i+c]) * m_scale
+                        - (SHAPING[0]*e[0] + SHAPING[1]*e[1] + SHAPING[2]*e[2]);
+                    const float q = std::nearbyint(std::clamp(y + noise[i+c], lo, hi));
+                    e[2] = e[1];
+                    e[1] = e[0];
+                    // bound the error so clipping can't make the loop unstable
+                    e[0] = std::clamp(q - y, -2.f, 2.f);
+                    scaled[i+c] = q;
+                }
+            }
+        }
+
+        store<O>(scaled, out, samples);
+
+        in += samples;
+        out += samples;
+        frames -= n;
+    }
 }
 
+template class quantizerDither<int, unsigned char>;
+template class quantizerDither<int, short>;
+template class quantizerDither<float, unsigned char>;
+template class quantizerDither<float, short>;
+
 /******************************************************************************/
 
 template<typename O>
-quantizerFloat<O>::quantizerFloat()
-{
-    _random[0][0] = 3686734;
-    _random[0][1] = 86526882;
-    _random[1][0] = 268268;
-    _random[1][1] = 7628932;
+quantizerFixed<O>::quantizerFixed(const unsigned int fract, bool noiseShaping) :
+    quantizerDither<int, O>(std::ldexp(fullScale<O>(), -static_cast<int>(fract)), noiseShaping)
+{}
 
-    qDebug() << "quantizerFloat " << static_cast<int>(sizeof(O)) << " bytes";
-}
+template quantizerFixed<unsigned char>::quantizerFixed(const unsigned int fract, bool noiseShaping);
+template quantizerFixed<short>::quantizerFixed(const unsigned int fract, bool noiseShaping);
 
-template quantizerFloat<unsigned char>::quantizerFloat();
-template quantizerFloat<short>::quantizerFloat();
+/******************************************************************************/
 
 template<typename O>
-inline int quantizerFloat<O>::get32(const float sample, const unsigned int channel, const int max)
-{
-    _random[channel][0] = random(_random[channel][0]);
-    _random[channel][1] = random(_random[channel][1]);
+quantizerFloat<O>::quantizerFloat(bool noiseShaping) :
+    quantizerDither<float, O>(fullScale<O>(), noiseShaping)
+{}
 
-    const float r1 = (float)_random[channel][0]/(float)std::numeric_limits<unsigned int>::max();
-    const float r2 = (float)_random[channel][1]/(float)std::numeric_limits<unsigned int>::max();
+template quantizerFloat<unsigned char>::quantizerFloat(bool noiseShaping);
+template quantizerFloat<short>::quantizerFloat(bool noiseShaping);
 
-    // Dither
-    int output = (int)(sample*(float)max + r1 + r2);
+/******************************************************************************/
+
+template<typename I>
+quantizerToFloat<I>::quantizerToFloat(float scale) :
+    m_unity(scale),
+    m_scale(scale)
+{
+    qDebug() << "quantizerToFloat" << static_cast<int>(sizeof(I)) << "bytes";
+}
 
-    return std::clamp(output, -max, max-1);
+template<typename I>
+void quantizerToFloat<I>::process(const I* in, float* out, size_t frames, unsigned int channels)
+{
+    const size_t samples = frames * channels;
+    for (size_t i=0; i<samples; i++)
+        out[i] = static_cast<float>(in[i]) * m_scale;
 }
 
 template<>
-unsigned char quantizerFloat<unsigned char>::get(const float sample, const unsigned int channel)
+void quantizerToFloat<unsigned char>::process(const unsigned char* in, float* out, size_t frames, unsigned int channels)
 {
-    return (unsigned char)(get32(sample, channel, 128))+128;
+    const size_t samples = frames * channels;
+    for (size_t i=0; i<samples; i++)
+        out[i] = static_cast<float>(static_cast<int>(in[i]) - 128) * m_scale;
 }
 
 template<>
-short quantizerFloat<short>::get(const float sample, const unsigned int channel)
+void quantizerToFloat<short>::process(const short* in, float* out, size_t frames, unsigned int channels)
+{
+    simd::fromS16(in, out, frames * channels, m_scale);
+}
+
+template class quantizerToFloat<unsigned char>;
+template class quantizerToFloat<short>;
+template class quantizerToFloat<int>;
+template class quantizerToFloat<float>;
+
+/******************************************************************************/
+
+template<typename T>
+quantizerGain<T>::quantizerGain() :
+    m_gain(1.)
+{
+    qDebug() << "quantizerGain" << static_cast<int>(sizeof(T)) << "bytes";
+}
+
+template<typename T>
+void quantizerGain<T>::process(const T* in, T* out, size_t frames, unsigned int channels)
 {
-    return (short)(get32(sample, channel, 32768));
+    // double keeps the precision of 32 bit samples
+    constexpr double lo = std::numeric_limits<T>::min();
+    constexpr double hi = std::numeric_limits<T>::max();
+
+    const size_t samples = frames * channels;
+    for (size_t i=0; i<samples; i++)
+        out[i] = static_cast<T>(std::llrint(std::clamp(in[i] * m_gain, lo, hi)));
 }
+
+template class quantizerGain<int>;
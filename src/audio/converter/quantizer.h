@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2006-2017 Leandro Nini
+ *  Copyright (C) 2006-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -19,16 +19,28 @@
 #ifndef QUANTIZER_H
 #define QUANTIZER_H
 
+#include "simd.h"
+
 #include <QDebug>
 
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
 template <typename I, typename O>
 class quantizer
 {
 public:
     virtual ~quantizer() = default;
 
-    /// Get dithered sample
-    virtual O get(const I sample, const unsigned int channel) =0;
+    /// Quantize a block of interleaved frames
+    virtual void process(const I* in, O* out, size_t frames, unsigned int channels) =0;
+
+    /// Set a gain folded into the scaling, returns false if not supported
+    virtual bool setGain([[maybe_unused]] float gain) { return false; }
+
+    /// Drop the state left by previous input
+    virtual void reset() {}
 };
 
 /******************************************************************************/
@@ -43,56 +55,139 @@ public:
     quantizerVoid() { qDebug() << "quantizerVoid" <<  static_cast<int>(sizeof(T)) << "bytes"; };
     ~quantizerVoid() override = default;
 
-    /// Get dithered sample
-    inline T get(const T sample, [[maybe_unused]] const unsigned int channel) override { return sample; }
+    /// Quantize a block of interleaved frames
+    void process(const T* in, T* out, size_t frames, unsigned int channels) override
+    {
+        if (in != out)
+            std::memcpy(out, in, frames * channels * sizeof(T));
+    }
 };
 
 /******************************************************************************/
 
-template<typename O>
-class quantizerFixed final : public quantizer<int, O>
+/**
+ * TPDF dithered quantizer, optionally noise shaped.
+ * Input is scaled to output LSB units, dither is generated
+ * a block at a time and the inner loops are instantiated
+ * for mono and stereo so they carry no per sample branches.
+ */
+template <typename I, typename O>
+class quantizerDither : public quantizer<I, O>
 {
 protected:
-    unsigned int _random[2][2];
+    static constexpr size_t BLOCK_FRAMES = 256;
+    static constexpr int SHAPING_TAPS = 3;
 
-    int _scalebits;
-    int _clip;
-    int _mask;
+protected:
+    simd::rng_t m_rng;
+
+    /// Input to output LSB scale
+    const float m_scale;
+
+    const bool m_noiseShaping;
+
+    /// Noise shaping error history, SHAPING_TAPS per channel
+    std::vector<float> m_error;
+
+    std::vector<float> m_noise;
+    std::vector<float> m_scaled;
 
 private:
-    quantizerFixed(const quantizerFixed&);
-    quantizerFixed& operator=(const quantizerFixed&);
+    quantizerDither(const quantizerDither&) = delete;
+    quantizerDither& operator=(const quantizerDither&) = delete;
 
-    int get32(const int sample, const unsigned int channel);
+    template <unsigned int CH>
+    void block(const I* in, O* out, size_t frames, unsigned int channels);
+
+protected:
+    quantizerDither(float scale, bool noiseShaping);
 
 public:
-    quantizerFixed(const unsigned int fract);
-    ~quantizerFixed() override = default;
+    ~quantizerDither() override = default;
+
+    /// Quantize a block of interleaved frames
+    void process(const I* in, O* out, size_t frames, unsigned int channels) override;
 
-    /// Get dithered sample
-    O get(const int sample, const unsigned int channel) override;
+    /// Clear the noise shaping error
+    void reset() override { std::fill(m_error.begin(), m_error.end(), 0.f); }
 };
 
 /******************************************************************************/
 
 template<typename O>
-class quantizerFloat final : public quantizer<float, O>
+class quantizerFixed final : public quantizerDither<int, O>
 {
-protected:
-    unsigned int _random[2][2];
+public:
+    quantizerFixed(const unsigned int fract, bool noiseShaping=false);
+    ~quantizerFixed() override = default;
+};
+
+/******************************************************************************/
 
+template<typename O>
+class quantizerFloat final : public quantizerDither<float, O>
+{
+public:
+    quantizerFloat(bool noiseShaping=false);
+    ~quantizerFloat() override = default;
+};
+
+/******************************************************************************/
+
+/**
+ * Scale to float for the processing bus,
+ * unsigned input is centered first.
+ */
+template<typename I>
+class quantizerToFloat final : public quantizer<I, float>
+{
 private:
-    quantizerFloat(const quantizerFloat<O>&);
-    quantizerFloat<O>& operator=(const quantizerFloat<O>&);
+    /// Input to float scale
+    const float m_unity;
+
+    /// Scale including gain
+    float m_scale;
 
-    int get32(const float sample, const unsigned int channel, const int max);
+private:
+    quantizerToFloat(const quantizerToFloat&) = delete;
+    quantizerToFloat& operator=(const quantizerToFloat&) = delete;
 
 public:
-    quantizerFloat();
-    ~quantizerFloat() override = default;
+    quantizerToFloat(float scale);
+    ~quantizerToFloat() override = default;
+
+    /// Quantize a block of interleaved frames
+    void process(const I* in, float* out, size_t frames, unsigned int channels) override;
+
+    /// Set a gain folded into the scaling
+    bool setGain(float gain) override { m_scale = m_unity * gain; return true; }
+};
+
+/******************************************************************************/
+
+/**
+ * Apply a gain to integer samples in place of the float bus,
+ * saturating at full scale.
+ */
+template<typename T>
+class quantizerGain final : public quantizer<T, T>
+{
+private:
+    double m_gain;
+
+private:
+    quantizerGain(const quantizerGain&) = delete;
+    quantizerGain& operator=(const quantizerGain&) = delete;
+
+public:
+    quantizerGain();
+    ~quantizerGain() override = default;
+
+    /// Quantize a block of interleaved frames
+    void process(const T* in, T* out, size_t frames, unsigned int channels) override;
 
-    /// Get dithered sample
-    O get(const float sample, const unsigned int channel) override;
+    /// Set the gain
+    bool setGain(float gain) override { m_gain = gain; return true; }
 };
 
 #endif
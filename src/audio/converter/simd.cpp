@@ -0,0 +1,450 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "simd.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define HAVE_SSE2
+#  include <immintrin.h>
+#  if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+// AVX2 kernel is built with a target attribute and enabled at runtime
+#    define HAVE_AVX2
+#  endif
+#elif defined(__aarch64__)
+#  define HAVE_NEON
+#  include <arm_neon.h>
+#endif
+
+namespace
+{
+[[maybe_unused]] float dotScalar(const float* a, const float* b, size_t n)
+{
+    // four accumulators to break the dependency chain
+    float s0 = 0.f, s1 = 0.f, s2 = 0.f, s3 = 0.f;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        s0 += a[i] * b[i];
+        s1 += a[i+1] * b[i+1];
+        s2 += a[i+2] * b[i+2];
+        s3 += a[i+3] * b[i+3];
+    }
+    for (; i < n; i++)
+        s0 += a[i] * b[i];
+    return (s0 + s1) + (s2 + s3);
+}
+
+inline uint32_t xorshift(uint32_t x)
+{
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
+
+// signed 32 bit to [-0.5, 0.5)
+constexpr float UNIFORM_SCALE = 1.f / 4294967296.f;
+
+[[maybe_unused]] void tpdfScalar(float* out, size_t n, simd::rng_t& rng)
+{
+    while (n > 0)
+    {
+        const size_t lanes = std::min<size_t>(n, simd::rng_t::LANES);
+        for (size_t l = 0; l < lanes; l++)
+        {
+            rng.a[l] = xorshift(rng.a[l]);
+            rng.b[l] = xorshift(rng.b[l]);
+            out[l] = (static_cast<int32_t>(rng.a[l]) + static_cast<float>(static_cast<int32_t>(rng.b[l]))) * UNIFORM_SCALE;
+        }
+        out += lanes;
+        n -= lanes;
+    }
+}
+
+[[maybe_unused]] void toS16Scalar(const float* in, short* out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        out[i] = static_cast<short>(std::lrint(std::clamp(in[i], -32768.f, 32767.f)));
+}
+
+[[maybe_unused]] void fromS16Scalar(const short* in, float* out, size_t n, float gain)
+{
+    for (size_t i = 0; i < n; i++)
+        out[i] = in[i] * gain;
+}
+
+[[maybe_unused]] void cascade4Scalar(const simd::biquad4_t& c, simd::biquad4State_t& s,
+    float* buf, size_t frames, unsigned int stride)
+{
+    float y[4], z1[4], z2[4];
+    std::copy(s.y, s.y+4, y);
+    std::copy(s.z1, s.z1+4, z1);
+    std::copy(s.z2, s.z2+4, z2);
+    for (size_t n = 0; n < frames; n++, buf += stride)
+    {
+        const float x[4] = { *buf, y[0], y[1], y[2] };
+        for (int l = 0; l < 4; l++)
+        {
+            y[l] = c.b0[l] * x[l] + z1[l];
+            z1[l] = c.b1[l] * x[l] - c.a1[l] * y[l] + z2[l];
+            z2[l] = c.b2[l] * x[l] - c.a2[l] * y[l];
+        }
+        *buf = y[3];
+    }
+    std::copy(y, y+4, s.y);
+    std::copy(z1, z1+4, s.z1);
+    std::copy(z2, z2+4, s.z2);
+}
+
+#ifdef HAVE_SSE2
+float dotSse2(const float* a, const float* b, size_t n)
+{
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a+i), _mm_loadu_ps(b+i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a+i+4), _mm_loadu_ps(b+i+4)));
+    }
+    acc0 = _mm_add_ps(acc0, acc1);
+    acc0 = _mm_add_ps(acc0, _mm_movehl_ps(acc0, acc0));
+    acc0 = _mm_add_ss(acc0, _mm_shuffle_ps(acc0, acc0, 1));
+    float sum = _mm_cvtss_f32(acc0);
+    for (; i < n; i++)
+        sum += a[i] * b[i];
+    return sum;
+}
+
+inline __m128i xorshiftSse2(__m128i x)
+{
+    x = _mm_xor_si128(x, _mm_slli_epi32(x, 13));
+    x = _mm_xor_si128(x, _mm_srli_epi32(x, 17));
+    x = _mm_xor_si128(x, _mm_slli_epi32(x, 5));
+    return x;
+}
+
+void tpdfSse2(float* out, size_t n, simd::rng_t& rng)
+{
+    const __m128 scale = _mm_set1_ps(UNIFORM_SCALE);
+    __m128i a0 = _mm_loadu_si128((const __m128i*)rng.a);
+    __m128i a1 = _mm_loadu_si128((const __m128i*)(rng.a+4));
+    __m128i b0 = _mm_loadu_si128((const __m128i*)rng.b);
+    __m128i b1 = _mm_loadu_si128((const __m128i*)(rng.b+4));
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        a0 = xorshiftSse2(a0);
+        a1 = xorshiftSse2(a1);
+        b0 = xorshiftSse2(b0);
+        b1 = xorshiftSse2(b1);
+        _mm_storeu_ps(out+i, _mm_mul_ps(_mm_add_ps(_mm_cvtepi32_ps(a0), _mm_cvtepi32_ps(b0)), scale));
+        _mm_storeu_ps(out+i+4, _mm_mul_ps(_mm_add_ps(_mm_cvtepi32_ps(a1), _mm_cvtepi32_ps(b1)), scale));
+    }
+    _mm_storeu_si128((__m128i*)rng.a, a0);
+    _mm_storeu_si128((__m128i*)(rng.a+4), a1);
+    _mm_storeu_si128((__m128i*)rng.b, b0);
+    _mm_storeu_si128((__m128i*)(rng.b+4), b1);
+    tpdfScalar(out+i, n-i, rng);
+}
+
+void toS16Sse2(const float* in, short* out, size_t n)
+{
+    const __m128 lo = _mm_set1_ps(-32768.f);
+    const __m128 hi = _mm_set1_ps(32767.f);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        // cvtps rounds to nearest, packs saturates
+        const __m128i v0 = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(in+i), lo), hi));
+        const __m128i v1 = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(in+i+4), lo), hi));
+        _mm_storeu_si128((__m128i*)(out+i), _mm_packs_epi32(v0, v1));
+    }
+    toS16Scalar(in+i, out+i, n-i);
+}
+
+void fromS16Sse2(const short* in, float* out, size_t n, float gain)
+{
+    const __m128 scale = _mm_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        // sign extend by placing the sample in the high half
+        const __m128i v = _mm_loadu_si128((const __m128i*)(in+i));
+        const __m128i v0 = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        const __m128i v1 = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        _mm_storeu_ps(out+i, _mm_mul_ps(_mm_cvtepi32_ps(v0), scale));
+        _mm_storeu_ps(out+i+4, _mm_mul_ps(_mm_cvtepi32_ps(v1), scale));
+    }
+    fromS16Scalar(in+i, out+i, n-i, gain);
+}
+
+void cascade4Sse2(const simd::biquad4_t& c, simd::biquad4State_t& s,
+    float* buf, size_t frames, unsigned int stride)
+{
+    const __m128 b0 = _mm_loadu_ps(c.b0);
+    const __m128 b1 = _mm_loadu_ps(c.b1);
+    const __m128 b2 = _mm_loadu_ps(c.b2);
+    const __m128 a1 = _mm_loadu_ps(c.a1);
+    const __m128 a2 = _mm_loadu_ps(c.a2);
+    __m128 y = _mm_loadu_ps(s.y);
+    __m128 z1 = _mm_loadu_ps(s.z1);
+    __m128 z2 = _mm_loadu_ps(s.z2);
+    for (size_t n = 0; n < frames; n++, buf += stride)
+    {
+        // shift the outputs up one lane, the new sample enters lane 0
+        const __m128 x = _mm_move_ss(_mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(y), 4)), _mm_set_ss(*buf));
+        y = _mm_add_ps(_mm_mul_ps(b0, x), z1);
+        z1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(b1, x), _mm_mul_ps(a1, y)), z2);
+        z2 = _mm_sub_ps(_mm_mul_ps(b2, x), _mm_mul_ps(a2, y));
+        *buf = _mm_cvtss_f32(_mm_shuffle_ps(y, y, _MM_SHUFFLE(3, 3, 3, 3)));
+    }
+    _mm_storeu_ps(s.y, y);
+    _mm_storeu_ps(s.z1, z1);
+    _mm_storeu_ps(s.z2, z2);
+}
+#endif
+
+#ifdef HAVE_AVX2
+__attribute__((target("avx2")))
+inline __m256i xorshiftAvx2(__m256i x)
+{
+    x = _mm256_xor_si256(x, _mm256_slli_epi32(x, 13));
+    x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 17));
+    x = _mm256_xor_si256(x, _mm256_slli_epi32(x, 5));
+    return x;
+}
+
+__attribute__((target("avx2")))
+void tpdfAvx2(float* out, size_t n, simd::rng_t& rng)
+{
+    const __m256 scale = _mm256_set1_ps(UNIFORM_SCALE);
+    __m256i a = _mm256_loadu_si256((const __m256i*)rng.a);
+    __m256i b = _mm256_loadu_si256((const __m256i*)rng.b);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        a = xorshiftAvx2(a);
+        b = xorshiftAvx2(b);
+        _mm256_storeu_ps(out+i, _mm256_mul_ps(_mm256_add_ps(_mm256_cvtepi32_ps(a), _mm256_cvtepi32_ps(b)), scale));
+    }
+    _mm256_storeu_si256((__m256i*)rng.a, a);
+    _mm256_storeu_si256((__m256i*)rng.b, b);
+    tpdfScalar(out+i, n-i, rng);
+}
+
+__attribute__((target("avx2")))
+void toS16Avx2(const float* in, short* out, size_t n)
+{
+    const __m256 lo = _mm256_set1_ps(-32768.f);
+    const __m256 hi = _mm256_set1_ps(32767.f);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        const __m256i v = _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(in+i), lo), hi));
+        _mm_storeu_si128((__m128i*)(out+i), _mm_packs_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1)));
+    }
+    toS16Scalar(in+i, out+i, n-i);
+}
+
+__attribute__((target("avx2")))
+void fromS16Avx2(const short* in, float* out, size_t n, float gain)
+{
+    const __m256 scale = _mm256_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        const __m256i v = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(in+i)));
+        _mm256_storeu_ps(out+i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+    }
+    fromS16Scalar(in+i, out+i, n-i, gain);
+}
+
+__attribute__((target("avx2,fma")))
+float dotAvx2(const float* a, const float* b, size_t n)
+{
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a+i), _mm256_loadu_ps(b+i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a+i+8), _mm256_loadu_ps(b+i+8), acc1);
+    }
+    for (; i + 8 <= n; i += 8)
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a+i), _mm256_loadu_ps(b+i), acc0);
+    acc0 = _mm256_add_ps(acc0, acc1);
+    __m128 sum4 = _mm_add_ps(_mm256_castps256_ps128(acc0), _mm256_extractf128_ps(acc0, 1));
+    sum4 = _mm_add_ps(sum4, _mm_movehl_ps(sum4, sum4));
+    sum4 = _mm_add_ss(sum4, _mm_shuffle_ps(sum4, sum4, 1));
+    float sum = _mm_cvtss_f32(sum4);
+    for (; i < n; i++)
+        sum += a[i] * b[i];
+    return sum;
+}
+#endif
+
+#ifdef HAVE_NEON
+float dotNeon(const float* a, const float* b, size_t n)
+{
+    float32x4_t acc0 = vdupq_n_f32(0.f);
+    float32x4_t acc1 = vdupq_n_f32(0.f);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        acc0 = vmlaq_f32(acc0, vld1q_f32(a+i), vld1q_f32(b+i));
+        acc1 = vmlaq_f32(acc1, vld1q_f32(a+i+4), vld1q_f32(b+i+4));
+    }
+    acc0 = vaddq_f32(acc0, acc1);
+    float32x2_t sum2 = vadd_f32(vget_low_f32(acc0), vget_high_f32(acc0));
+    float sum = vget_lane_f32(vpadd_f32(sum2, sum2), 0);
+    for (; i < n; i++)
+        sum += a[i] * b[i];
+    return sum;
+}
+
+void tpdfNeon(float* out, size_t n, simd::rng_t& rng)
+{
+    uint32x4_t a0 = vld1q_u32(rng.a);
+    uint32x4_t a1 = vld1q_u32(rng.a+4);
+    uint32x4_t b0 = vld1q_u32(rng.b);
+    uint32x4_t b1 = vld1q_u32(rng.b+4);
+    auto next = [](uint32x4_t x) {
+        x = veorq_u32(x, vshlq_n_u32(x, 13));
+        x = veorq_u32(x, vshrq_n_u32(x, 17));
+        return veorq_u32(x, vshlq_n_u32(x, 5));
+    };
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        a0 = next(a0);
+        a1 = next(a1);
+        b0 = next(b0);
+        b1 = next(b1);
+        const float32x4_t v0 = vaddq_f32(vcvtq_f32_s32(vreinterpretq_s32_u32(a0)), vcvtq_f32_s32(vreinterpretq_s32_u32(b0)));
+        const float32x4_t v1 = vaddq_f32(vcvtq_f32_s32(vreinterpretq_s32_u32(a1)), vcvtq_f32_s32(vreinterpretq_s32_u32(b1)));
+        vst1q_f32(out+i, vmulq_n_f32(v0, UNIFORM_SCALE));
+        vst1q_f32(out+i+4, vmulq_n_f32(v1, UNIFORM_SCALE));
+    }
+    vst1q_u32(rng.a, a0);
+    vst1q_u32(rng.a+4, a1);
+    vst1q_u32(rng.b, b0);
+    vst1q_u32(rng.b+4, b1);
+    tpdfScalar(out+i, n-i, rng);
+}
+
+void toS16Neon(const float* in, short* out, size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        // vcvtn rounds to nearest, vqmovn saturates
+        const int32x4_t v0 = vcvtnq_s32_f32(vld1q_f32(in+i));
+        const int32x4_t v1 = vcvtnq_s32_f32(vld1q_f32(in+i+4));
+        vst1q_s16(out+i, vcombine_s16(vqmovn_s32(v0), vqmovn_s32(v1)));
+    }
+    toS16Scalar(in+i, out+i, n-i);
+}
+
+void fromS16Neon(const short* in, float* out, size_t n, float gain)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        const int16x8_t v = vld1q_s16(in+i);
+        vst1q_f32(out+i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), gain));
+        vst1q_f32(out+i+4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), gain));
+    }
+    fromS16Scalar(in+i, out+i, n-i, gain);
+}
+
+void cascade4Neon(const simd::biquad4_t& c, simd::biquad4State_t& s,
+    float* buf, size_t frames, unsigned int stride)
+{
+    const float32x4_t b0 = vld1q_f32(c.b0);
+    const float32x4_t b1 = vld1q_f32(c.b1);
+    const float32x4_t b2 = vld1q_f32(c.b2);
+    const float32x4_t a1 = vld1q_f32(c.a1);
+    const float32x4_t a2 = vld1q_f32(c.a2);
+    float32x4_t y = vld1q_f32(s.y);
+    float32x4_t z1 = vld1q_f32(s.z1);
+    float32x4_t z2 = vld1q_f32(s.z2);
+    for (size_t n = 0; n < frames; n++, buf += stride)
+    {
+        // shift the outputs up one lane, the new sample enters lane 0
+        const float32x4_t x = vextq_f32(vdupq_n_f32(*buf), y, 3);
+        y = vmlaq_f32(z1, b0, x);
+        z1 = vmlsq_f32(vmlaq_f32(z2, b1, x), a1, y);
+        z2 = vmlsq_f32(vmulq_f32(b2, x), a2, y);
+        *buf = vgetq_lane_f32(y, 3);
+    }
+    vst1q_f32(s.y, y);
+    vst1q_f32(s.z1, z1);
+    vst1q_f32(s.z2, z2);
+}
+#endif
+
+struct kernels_t
+{
+    const char* name;
+    simd::dot_t dot;
+    simd::tpdf_t tpdf;
+    simd::toS16_t toS16;
+    simd::fromS16_t fromS16;
+    simd::cascade4_t cascade4;
+};
+
+kernels_t selectKernels()
+{
+#ifdef HAVE_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return { "AVX2", dotAvx2, tpdfAvx2, toS16Avx2, fromS16Avx2, cascade4Sse2 };
+#endif
+#if defined(HAVE_SSE2)
+    return { "SSE2", dotSse2, tpdfSse2, toS16Sse2, fromS16Sse2, cascade4Sse2 };
+#elif defined(HAVE_NEON)
+    return { "NEON", dotNeon, tpdfNeon, toS16Neon, fromS16Neon, cascade4Neon };
+#else
+    return { "scalar", dotScalar, tpdfScalar, toS16Scalar, fromS16Scalar, cascade4Scalar };
+#endif
+}
+
+const kernels_t kernels = selectKernels();
+} // namespace
+
+simd::rng_t::rng_t()
+{
+    uint32_t seed = 0x9E3779B9;
+    for (int l = 0; l < LANES; l++)
+    {
+        a[l] = seed = xorshift(seed + l);
+        b[l] = seed = xorshift(seed ^ 0x85EBCA6B);
+    }
+}
+
+const simd::dot_t simd::dot = kernels.dot;
+const simd::tpdf_t simd::tpdf = kernels.tpdf;
+const simd::toS16_t simd::toS16 = kernels.toS16;
+const simd::fromS16_t simd::fromS16 = kernels.fromS16;
+const simd::cascade4_t simd::cascade4 = kernels.cascade4;
+
+const char* simd::name() { return kernels.name; }
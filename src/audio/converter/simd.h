@@ -0,0 +1,88 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Vector kernels, the best implementation
+ * for the running CPU is selected at startup
+ */
+namespace simd
+{
+    /// Independent xorshift generators, one per vector lane
+    struct rng_t
+    {
+        static constexpr int LANES = 8;
+        uint32_t a[LANES];
+        uint32_t b[LANES];
+
+        rng_t();
+    };
+
+    /// Coefficients of four biquads in cascade, one per lane, normalized to a0 = 1
+    struct biquad4_t
+    {
+        float b0[4];
+        float b1[4];
+        float b2[4];
+        float a1[4];
+        float a2[4];
+    };
+
+    /// Transposed direct form II state plus the last output of each lane
+    struct biquad4State_t
+    {
+        float y[4];
+        float z1[4];
+        float z2[4];
+    };
+
+    using dot_t = float(*)(const float* a, const float* b, size_t n);
+    using tpdf_t = void(*)(float* out, size_t n, rng_t& rng);
+    using toS16_t = void(*)(const float* in, short* out, size_t n);
+    using fromS16_t = void(*)(const short* in, float* out, size_t n, float gain);
+    using cascade4_t = void(*)(const biquad4_t& c, biquad4State_t& s, float* buf, size_t frames, unsigned int stride);
+
+    /// Dot product of two float vectors
+    extern const dot_t dot;
+
+    /// Fill with triangular noise in the [-1, 1) range
+    extern const tpdf_t tpdf;
+
+    /// Round to nearest and saturate to 16 bit
+    extern const toS16_t toS16;
+
+    /// Convert 16 bit to float multiplying by gain
+    extern const fromS16_t fromS16;
+
+    /**
+     * Filter one channel of interleaved frames in place.
+     * Lane k works on the output lane k-1 produced a sample before,
+     * so the cascade adds three samples of latency.
+     */
+    extern const cascade4_t cascade4;
+
+    /// Name of the selected instruction set
+    const char* name();
+}
+
+#endif
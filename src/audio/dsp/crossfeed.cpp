@@ -0,0 +1,78 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "crossfeed.h"
+
+#include <QDebug>
+
+crossfeed::crossfeed()
+#ifdef HAVE_BS2B
+    : m_bs2bdp(nullptr)
+#endif
+{}
+
+crossfeed::~crossfeed()
+{
+#ifdef HAVE_BS2B
+    if (m_bs2bdp)
+        bs2b_close(m_bs2bdp);
+#endif
+}
+
+void crossfeed::init(unsigned int sampleRate, unsigned int channels)
+{
+    dspNode::init(sampleRate, channels);
+
+#ifdef HAVE_BS2B
+    if (channels != 2)
+        return;
+
+    if (!m_bs2bdp)
+        m_bs2bdp = bs2b_open();
+    if (m_bs2bdp)
+    {
+        qDebug() << "bs2b enabled";
+        bs2b_set_srate(m_bs2bdp, sampleRate);
+        bs2b_set_level(m_bs2bdp, BS2B_DEFAULT_CLEVEL);
+    }
+#endif
+}
+
+void crossfeed::reset()
+{
+#ifdef HAVE_BS2B
+    if (m_bs2bdp)
+        bs2b_clear(m_bs2bdp);
+#endif
+}
+
+bool crossfeed::active() const
+{
+#ifdef HAVE_BS2B
+    return m_bs2bdp != nullptr;
+#else
+    return false;
+#endif
+}
+
+void crossfeed::process([[maybe_unused]] float* buffer, [[maybe_unused]] size_t frames)
+{
+#ifdef HAVE_BS2B
+    bs2b_cross_feed_f(m_bs2bdp, buffer, frames);
+#endif
+}
@@ -0,0 +1,58 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CROSSFEED_H
+#define CROSSFEED_H
+
+#include "dspNode.h"
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#ifdef HAVE_BS2B
+#  include <bs2b.h>
+#endif
+
+/**
+ * Bauer stereophonic-to-binaural crossfeed,
+ * only active on stereo streams
+ */
+class crossfeed : public dspNode
+{
+#ifdef HAVE_BS2B
+private:
+    t_bs2bdp m_bs2bdp;
+#endif
+
+public:
+    crossfeed();
+    ~crossfeed() override;
+
+    const char* name() const override { return "Crossfeed"; }
+
+    void init(unsigned int sampleRate, unsigned int channels) override;
+
+    void reset() override;
+
+    bool active() const override;
+
+    void process(float* buffer, size_t frames) override;
+};
+
+#endif
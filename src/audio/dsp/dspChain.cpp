@@ -0,0 +1,126 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "dspChain.h"
+
+#include "crossfeed.h"
+#include "equalizer.h"
+#include "limiter.h"
+#include "preamp.h"
+
+#include "settings.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+
+#include <algorithm>
+
+dspChain::dspChain() :
+    m_frames(0),
+    m_sampleRate(0)
+{}
+
+dspChain::~dspChain() = default;
+
+dspChain* dspChain::fromSettings()
+{
+    dspChain* chain = new dspChain();
+
+    // the limiter goes last to catch the peaks from the other nodes
+    chain->add(new preamp(SETTINGS->preamp()));
+    if (SETTINGS->equalizer())
+        chain->add(new equalizer(SETTINGS->eqBands()));
+    if (SETTINGS->bs2b())
+        chain->add(new crossfeed());
+    if (SETTINGS->limiter())
+        chain->add(new limiter(SETTINGS->limiterCeiling()));
+
+    return chain;
+}
+
+void dspChain::add(dspNode* node)
+{
+    std::unique_ptr<entry_t> entry(new entry_t);
+    entry->node.reset(node);
+    entry->nanoSeconds = 0;
+    m_nodes.push_back(std::move(entry));
+}
+
+void dspChain::init(unsigned int sampleRate, unsigned int channels)
+{
+    m_sampleRate = sampleRate;
+
+    for (auto& entry: m_nodes)
+        entry->node->init(sampleRate, channels);
+
+    m_nodes.erase(std::remove_if(m_nodes.begin(), m_nodes.end(),
+            [](const std::unique_ptr<entry_t>& entry) { return !entry->node->active(); }),
+        m_nodes.end());
+
+    for (const auto& entry: m_nodes)
+        qDebug() << "DSP node" << entry->node->name() << "latency" << entry->node->latency();
+}
+
+void dspChain::reset()
+{
+    for (auto& entry: m_nodes)
+        entry->node->reset();
+}
+
+unsigned int dspChain::latency() const
+{
+    unsigned int frames = 0;
+    for (const auto& entry: m_nodes)
+        frames += entry->node->latency();
+    return frames;
+}
+
+void dspChain::process(float* buffer, size_t frames)
+{
+    QElapsedTimer timer;
+    for (auto& entry: m_nodes)
+    {
+        timer.start();
+        entry->node->process(buffer, frames);
+        entry->nanoSeconds.fetch_add(timer.nsecsElapsed(), std::memory_order_relaxed);
+    }
+    m_frames.fetch_add(frames, std::memory_order_relaxed);
+}
+
+std::vector<dspChain::stats_t> dspChain::stats() const
+{
+    std::vector<stats_t> result;
+    for (const auto& entry: m_nodes)
+        result.push_back({ entry->node->name(), entry->node->latency(), entry->nanoSeconds.load(std::memory_order_relaxed) });
+    return result;
+}
+
+void dspChain::logStats() const
+{
+    const quint64 processed = frames();
+    if ((processed == 0) || (m_sampleRate == 0))
+        return;
+
+    // processing time relative to the audio duration
+    const double audioNs = processed * 1e9 / m_sampleRate;
+    for (const stats_t& s: stats())
+    {
+        qInfo().nospace() << "DSP " << s.name << ": " << s.nanoSeconds / static_cast<double>(processed) << " ns/frame, "
+            << 100. * s.nanoSeconds / audioNs << "% cpu, latency " << s.latency << " frames";
+    }
+}
@@ -0,0 +1,97 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef DSPCHAIN_H
+#define DSPCHAIN_H
+
+#include "dspNode.h"
+
+#include <QtGlobal>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/**
+ * Ordered chain of DSP nodes working in place on float frames.
+ * Nodes that are inactive for the stream format are dropped at init
+ * so bypassing costs nothing.
+ */
+class dspChain
+{
+public:
+    struct stats_t
+    {
+        const char* name;
+        unsigned int latency;   ///< frames
+        quint64 nanoSeconds;    ///< time spent processing
+    };
+
+private:
+    struct entry_t
+    {
+        std::unique_ptr<dspNode> node;
+        std::atomic<quint64> nanoSeconds;
+    };
+
+    std::vector<std::unique_ptr<entry_t>> m_nodes;
+
+    std::atomic<quint64> m_frames;
+
+    unsigned int m_sampleRate;
+
+private:
+    dspChain(const dspChain&) = delete;
+    dspChain& operator=(const dspChain&) = delete;
+
+public:
+    dspChain();
+    ~dspChain();
+
+    /// Create the chain configured in the settings
+    static dspChain* fromSettings();
+
+    /// Append a node, takes ownership
+    void add(dspNode* node);
+
+    /// Prepare the nodes, inactive ones are removed
+    void init(unsigned int sampleRate, unsigned int channels);
+
+    /// Clear the nodes state
+    void reset();
+
+    /// Check if there is something to do
+    bool empty() const { return m_nodes.empty(); }
+
+    /// Total latency in frames
+    unsigned int latency() const;
+
+    /// Process frames in place
+    void process(float* buffer, size_t frames);
+
+    /// Per node processing time
+    std::vector<stats_t> stats() const;
+
+    /// Processed frames
+    quint64 frames() const { return m_frames.load(std::memory_order_relaxed); }
+
+    /// Log the per node load
+    void logStats() const;
+};
+
+#endif
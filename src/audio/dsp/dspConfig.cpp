@@ -0,0 +1,164 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "dspConfig.h"
+
+#include "settings.h"
+
+#include <QCheckBox>
+#include <QDoubleSpinBox>
+#include <QGroupBox>
+#include <QLabel>
+
+dspConfig::dspConfig(QWidget* win) :
+    configFrame(win)
+{
+    matrix()->addWidget(new QLabel(tr("Preamp (dB)"), this), 0, 0);
+    QDoubleSpinBox *preamp = new QDoubleSpinBox(this);
+    matrix()->addWidget(preamp, 0, 1);
+    preamp->setRange(-12., 12.);
+    preamp->setSingleStep(0.5);
+    preamp->setDecimals(1);
+    preamp->setToolTip(tr("Gain applied before the other processing"));
+    preamp->setValue(SETTINGS->preamp());
+
+    connect(preamp, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
+        [](double val) {
+            SETTINGS->m_preamp = val;
+        }
+    );
+
+    matrix()->addWidget(new QLabel(tr("Crossfeed"), this), 1, 0);
+    QCheckBox *crossfeed = new QCheckBox(this);
+    matrix()->addWidget(crossfeed, 1, 1);
+    crossfeed->setToolTip(tr("Bauer stereophonic-to-binaural DSP"));
+    crossfeed->setCheckState(SETTINGS->bs2b() ? Qt::Checked : Qt::Unchecked);
+
+    connect(crossfeed,
+#if QT_VERSION >= QT_VERSION_CHECK(6, 7, 0)
+            &QCheckBox::checkStateChanged,
+        [](Qt::CheckState val)
+#else
+            &QCheckBox::stateChanged,
+        [](int val)
+#endif
+        {
+            SETTINGS->m_bs2b = (val == Qt::Checked);
+        }
+    );
+#ifndef HAVE_BS2B
+    crossfeed->setDisabled(true);
+#endif
+
+    matrix()->addWidget(new QLabel(tr("Limiter"), this), 2, 0);
+    QCheckBox *limiter = new QCheckBox(this);
+    matrix()->addWidget(limiter, 2, 1);
+    limiter->setToolTip(tr("Lookahead true peak limiter, keeps the output below the ceiling"));
+    limiter->setCheckState(SETTINGS->limiter() ? Qt::Checked : Qt::Unchecked);
+
+    matrix()->addWidget(new QLabel(tr("Ceiling (dBTP)"), this), 3, 0);
+    QDoubleSpinBox *ceiling = new QDoubleSpinBox(this);
+    matrix()->addWidget(ceiling, 3, 1);
+    ceiling->setRange(-12., 0.);
+    ceiling->setSingleStep(0.1);
+    ceiling->setDecimals(1);
+    ceiling->setValue(SETTINGS->limiterCeiling());
+    ceiling->setEnabled(SETTINGS->limiter());
+
+    connect(limiter,
+#if QT_VERSION >= QT_VERSION_CHECK(6, 7, 0)
+            &QCheckBox::checkStateChanged,
+        [ceiling](Qt::CheckState val)
+#else
+            &QCheckBox::stateChanged,
+        [ceiling](int val)
+#endif
+        {
+            SETTINGS->m_limiter = (val == Qt::Checked);
+            ceiling->setEnabled(val == Qt::Checked);
+        }
+    );
+    connect(ceiling, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
+        [](double val) {
+            SETTINGS->m_limiterCeiling = val;
+        }
+    );
+
+    {
+        QGroupBox *group = new QGroupBox(tr("Equalizer"));
+        QVBoxLayout *equalizerBox = new QVBoxLayout(group);
+        group->setCheckable(true);
+        group->setToolTip(tr("Enable parametric equalizer, first and last bands are shelves"));
+        group->setChecked(SETTINGS->equalizer());
+        connect(group, &QGroupBox::toggled,
+            [](bool val) {
+                SETTINGS->m_equalizer = val;
+            }
+        );
+
+        QGridLayout* mat = new QGridLayout();
+        equalizerBox->addLayout(mat);
+        mat->addWidget(new QLabel(tr("Frequency (Hz)"), this), 1, 0);
+        mat->addWidget(new QLabel(tr("Gain (dB)"), this), 2, 0);
+        mat->addWidget(new QLabel(tr("Q"), this), 3, 0);
+
+        for (int i=0; i<EQ_BANDS; i++)
+        {
+            const eqBand_t& band = SETTINGS->eqBands()[i];
+
+            mat->addWidget(new QLabel(QString::number(i+1), this), 0, i+1, 1, 1, Qt::AlignCenter);
+
+            QDoubleSpinBox *freq = new QDoubleSpinBox(this);
+            freq->setRange(20., 20000.);
+            freq->setDecimals(0);
+            freq->setValue(band.freq);
+            mat->addWidget(freq, 1, i+1);
+            connect(freq, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
+                [i](double val) {
+                    SETTINGS->m_eqBands[i].freq = val;
+                }
+            );
+
+            QDoubleSpinBox *gain = new QDoubleSpinBox(this);
+            gain->setRange(-12., 12.);
+            gain->setSingleStep(0.5);
+            gain->setDecimals(1);
+            gain->setValue(band.gain);
+            mat->addWidget(gain, 2, i+1);
+            connect(gain, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
+                [i](double val) {
+                    SETTINGS->m_eqBands[i].gain = val;
+                }
+            );
+
+            QDoubleSpinBox *q = new QDoubleSpinBox(this);
+            q->setRange(0.1, 10.);
+            q->setSingleStep(0.1);
+            q->setDecimals(2);
+            q->setValue(band.q);
+            mat->addWidget(q, 3, i+1);
+            connect(q, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
+                [i](double val) {
+                    SETTINGS->m_eqBands[i].q = val;
+                }
+            );
+        }
+
+        extraBottom()->addWidget(group);
+    }
+}
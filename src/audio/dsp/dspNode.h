@@ -0,0 +1,71 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef DSPNODE_H
+#define DSPNODE_H
+
+#include <cstddef>
+
+/**
+ * Base class for DSP nodes.
+ * Nodes work in place on interleaved float frames,
+ * memory is only allocated in init.
+ */
+class dspNode
+{
+protected:
+    unsigned int m_sampleRate;
+    unsigned int m_channels;
+
+private:
+    dspNode(const dspNode&) = delete;
+    dspNode& operator=(const dspNode&) = delete;
+
+protected:
+    dspNode() :
+        m_sampleRate(0),
+        m_channels(0)
+    {}
+
+public:
+    virtual ~dspNode() = default;
+
+    /// Node name
+    virtual const char* name() const =0;
+
+    /// Prepare for the stream format
+    virtual void init(unsigned int sampleRate, unsigned int channels)
+    {
+        m_sampleRate = sampleRate;
+        m_channels = channels;
+    }
+
+    /// Clear the internal state
+    virtual void reset() {}
+
+    /// Check if the node alters the signal, inactive nodes are skipped
+    virtual bool active() const { return true; }
+
+    /// Latency in frames
+    virtual unsigned int latency() const { return 0; }
+
+    /// Process frames in place
+    virtual void process(float* buffer, size_t frames) =0;
+};
+
+#endif
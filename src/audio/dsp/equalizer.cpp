@@ -0,0 +1,160 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "equalizer.h"
+
+#include <QDebug>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+constexpr double PI = 3.14159265358979323846;
+
+enum class filter_t
+{
+    LowShelf,
+    Peaking,
+    HighShelf
+};
+
+/// RBJ cookbook coefficients, normalized to a0 = 1
+void design(filter_t type, const eqBand_t& band, unsigned int sampleRate, double coeffs[5])
+{
+    const double A = std::pow(10., band.gain / 40.);
+    const double w0 = 2. * PI * band.freq / sampleRate;
+    const double cosw = std::cos(w0);
+    const double alpha = std::sin(w0) / (2. * band.q);
+    const double sqrtA2alpha = 2. * std::sqrt(A) * alpha;
+
+    double b0, b1, b2, a0, a1, a2;
+    switch (type)
+    {
+    case filter_t::LowShelf:
+        b0 = A * ((A+1.) - (A-1.)*cosw + sqrtA2alpha);
+        b1 = 2. * A * ((A-1.) - (A+1.)*cosw);
+        b2 = A * ((A+1.) - (A-1.)*cosw - sqrtA2alpha);
+        a0 = (A+1.) + (A-1.)*cosw + sqrtA2alpha;
+        a1 = -2. * ((A-1.) + (A+1.)*cosw);
+        a2 = (A+1.) + (A-1.)*cosw - sqrtA2alpha;
+        break;
+    case filter_t::HighShelf:
+        b0 = A * ((A+1.) + (A-1.)*cosw + sqrtA2alpha);
+        b1 = -2. * A * ((A-1.) + (A+1.)*cosw);
+        b2 = A * ((A+1.) + (A-1.)*cosw - sqrtA2alpha);
+        a0 = (A+1.) - (A-1.)*cosw + sqrtA2alpha;
+        a1 = 2. * ((A-1.) - (A+1.)*cosw);
+        a2 = (A+1.) - (A-1.)*cosw - sqrtA2alpha;
+        break;
+    default:
+        b0 = 1. + alpha*A;
+        b1 = -2. * cosw;
+        b2 = 1. - alpha*A;
+        a0 = 1. + alpha/A;
+        a1 = -2. * cosw;
+        a2 = 1. - alpha/A;
+        break;
+    }
+
+    coeffs[0] = b0 / a0;
+    coeffs[1] = b1 / a0;
+    coeffs[2] = b2 / a0;
+    coeffs[3] = a1 / a0;
+    coeffs[4] = a2 / a0;
+}
+
+/// Flush tiny values so silence doesn't leave denormals in the state
+inline void flush(float* v)
+{
+    for (int l=0; l<4; l++)
+    {
+        if (std::fabs(v[l]) < 1e-20f)
+            v[l] = 0.f;
+    }
+}
+}
+
+equalizer::equalizer(const bands_t& bands) :
+    m_bands(bands)
+{}
+
+void equalizer::init(unsigned int sampleRate, unsigned int channels)
+{
+    dspNode::init(sampleRate, channels);
+
+    m_sections.clear();
+
+    // flat bands are left out, unused lanes pass through
+    int lane = 4;
+    for (int i=0; i<EQ_BANDS; i++)
+    {
+        const eqBand_t& band = m_bands[i];
+        if ((band.gain == 0.f) || (band.q <= 0.f) || (band.freq <= 0.f) || (band.freq >= 0.49f * sampleRate))
+            continue;
+
+        if (lane == 4)
+        {
+            simd::biquad4_t section;
+            std::memset(&section, 0, sizeof(section));
+            std::fill(section.b0, section.b0+4, 1.f);
+            m_sections.push_back(section);
+            lane = 0;
+        }
+
+        const filter_t type = (i == 0) ? filter_t::LowShelf
+            : (i == EQ_BANDS-1) ? filter_t::HighShelf : filter_t::Peaking;
+        double coeffs[5];
+        design(type, band, sampleRate, coeffs);
+
+        simd::biquad4_t& section = m_sections.back();
+        section.b0[lane] = coeffs[0];
+        section.b1[lane] = coeffs[1];
+        section.b2[lane] = coeffs[2];
+        section.a1[lane] = coeffs[3];
+        section.a2[lane] = coeffs[4];
+        lane++;
+    }
+
+    qDebug() << "Equalizer sections:" << m_sections.size();
+
+    m_state.resize(m_sections.size() * channels);
+    reset();
+}
+
+void equalizer::reset()
+{
+    std::memset(m_state.data(), 0, m_state.size() * sizeof(simd::biquad4State_t));
+}
+
+void equalizer::process(float* buffer, size_t frames)
+{
+    const size_t sections = m_sections.size();
+    for (unsigned int c=0; c<m_channels; c++)
+    {
+        simd::biquad4State_t* state = &m_state[c * sections];
+        for (size_t s=0; s<sections; s++)
+        {
+            simd::cascade4(m_sections[s], state[s], buffer+c, frames, m_channels);
+            flush(state[s].y);
+            flush(state[s].z1);
+            flush(state[s].z2);
+        }
+    }
+}
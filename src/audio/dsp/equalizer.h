@@ -0,0 +1,64 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef EQUALIZER_H
+#define EQUALIZER_H
+
+#include "dspNode.h"
+#include "inputTypes.h"
+#include "converter/simd.h"
+
+#include <array>
+#include <vector>
+
+/**
+ * Parametric equalizer, the first band is a low shelf,
+ * the last one a high shelf and the others are peaking.
+ * Bands are packed four at a time into SIMD cascades.
+ */
+class equalizer : public dspNode
+{
+public:
+    using bands_t = std::array<eqBand_t, EQ_BANDS>;
+
+private:
+    const bands_t m_bands;
+
+    std::vector<simd::biquad4_t> m_sections;
+
+    /// Filter state, all the sections of a channel are adjacent
+    std::vector<simd::biquad4State_t> m_state;
+
+public:
+    equalizer(const bands_t& bands);
+    ~equalizer() override = default;
+
+    const char* name() const override { return "Equalizer"; }
+
+    void init(unsigned int sampleRate, unsigned int channels) override;
+
+    void reset() override;
+
+    bool active() const override { return !m_sections.empty(); }
+
+    unsigned int latency() const override { return 3 * m_sections.size(); }
+
+    void process(float* buffer, size_t frames) override;
+};
+
+#endif
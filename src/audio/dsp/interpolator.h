@@ -0,0 +1,52 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef INTERPOLATOR_H
+#define INTERPOLATOR_H
+
+#include <cmath>
+
+/**
+ * Blackman windowed sinc filters interpolating the intermediate
+ * phases of an oversampled signal between the two middle taps,
+ * used for true peak estimation.
+ */
+template <int PHASES, int TAPS>
+void designInterpolator(float (&phases)[PHASES][TAPS])
+{
+    constexpr double PI = 3.14159265358979323846;
+    constexpr int OVERSAMPLING = PHASES + 1;
+
+    for (int p=1; p<OVERSAMPLING; p++)
+    {
+        float* phase = phases[p-1];
+        double sum = 0.;
+        for (int k=0; k<TAPS; k++)
+        {
+            const double d = (TAPS/2 - 1) - k + static_cast<double>(p) / OVERSAMPLING;
+            const double w = 0.42 + 0.5 * std::cos(PI * d / (TAPS/2)) + 0.08 * std::cos(2. * PI * d / (TAPS/2));
+            const double sinc = std::sin(PI * d) / (PI * d);
+            phase[k] = sinc * w;
+            sum += phase[k];
+        }
+        for (int k=0; k<TAPS; k++)
+            phase[k] /= sum;
+    }
+}
+
+#endif
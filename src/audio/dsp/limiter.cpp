@@ -0,0 +1,136 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "limiter.h"
+
+#include "interpolator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+constexpr unsigned int LOOKAHEAD_MS = 2;
+constexpr float RELEASE_S = 0.1f;
+}
+
+limiter::limiter(float ceiling) :
+    m_ceiling(std::pow(10.f, ceiling / 20.f)),
+    m_window(1),
+    m_releaseCoeff(1.f)
+{}
+
+void limiter::init(unsigned int sampleRate, unsigned int channels)
+{
+    dspNode::init(sampleRate, channels);
+
+    m_window = std::max(1u, sampleRate * LOOKAHEAD_MS / 1000);
+    m_releaseCoeff = 1.f - std::exp(-1.f / (RELEASE_S * sampleRate));
+
+    designInterpolator(m_phases);
+
+    m_history.resize(channels * TAPS * 2);
+    m_delay.resize(latency() * channels);
+    m_minGain.resize(m_window);
+    m_minFrame.resize(m_window);
+    m_average.resize(m_window);
+
+    reset();
+}
+
+void limiter::reset()
+{
+    std::fill(m_history.begin(), m_history.end(), 0.f);
+    m_historyPos = 0;
+    std::fill(m_delay.begin(), m_delay.end(), 0.f);
+    m_delayPos = 0;
+    m_minHead = 0;
+    m_minSize = 0;
+    m_frame = 0;
+    m_lastInterval = 0.f;
+    m_release = 1.f;
+    std::fill(m_average.begin(), m_average.end(), 1.f);
+    m_averagePos = 0;
+    m_sum = m_window;
+}
+
+void limiter::process(float* buffer, size_t frames)
+{
+    const size_t delayFrames = latency();
+
+    for (size_t f=0; f<frames; f++, buffer+=m_channels)
+    {
+        // true peak around the sample entering the lookahead window
+        float peak = 0.f;
+        float interval = 0.f;
+        for (unsigned int c=0; c<m_channels; c++)
+        {
+            float* history = &m_history[c * TAPS * 2];
+            history[m_historyPos] = buffer[c];
+            history[m_historyPos + TAPS] = buffer[c];
+
+            // oldest sample first
+            const float* h = history + m_historyPos + 1;
+            peak = std::max(peak, std::fabs(h[TAPS/2 - 1]));
+            for (int p=0; p<OVERSAMPLING-1; p++)
+            {
+                float v = 0.f;
+                for (int k=0; k<TAPS; k++)
+                    v += h[k] * m_phases[p][k];
+                interval = std::max(interval, std::fabs(v));
+            }
+        }
+        m_historyPos = (m_historyPos + 1) % TAPS;
+
+        peak = std::max(peak, std::max(interval, m_lastInterval));
+        m_lastInterval = interval;
+
+        const float required = (peak > m_ceiling) ? m_ceiling / peak : 1.f;
+
+        // keep the queue increasing, the head is the minimum over the window
+        while ((m_minSize > 0) && (m_minGain[(m_minHead + m_minSize - 1) % m_window] >= required))
+            m_minSize--;
+        if ((m_minSize > 0) && (m_minFrame[m_minHead] + m_window <= m_frame))
+        {
+            m_minHead = (m_minHead + 1) % m_window;
+            m_minSize--;
+        }
+        const size_t tail = (m_minHead + m_minSize) % m_window;
+        m_minGain[tail] = required;
+        m_minFrame[tail] = m_frame;
+        m_minSize++;
+
+        const float held = m_minGain[m_minHead];
+        m_release = (held < m_release) ? held : m_release + (held - m_release) * m_releaseCoeff;
+
+        m_sum += m_release - m_average[m_averagePos];
+        m_average[m_averagePos] = m_release;
+        m_averagePos = (m_averagePos + 1) % m_window;
+        const float gain = std::min(1.f, static_cast<float>(m_sum / m_window));
+
+        float* delayed = &m_delay[m_delayPos * m_channels];
+        for (unsigned int c=0; c<m_channels; c++)
+        {
+            const float out = delayed[c] * gain;
+            delayed[c] = buffer[c];
+            buffer[c] = out;
+        }
+        m_delayPos = (m_delayPos + 1) % delayFrames;
+        m_frame++;
+    }
+}
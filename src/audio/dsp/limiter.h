@@ -0,0 +1,93 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef LIMITER_H
+#define LIMITER_H
+
+#include "dspNode.h"
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Lookahead true peak limiter.
+ * Peaks are estimated on a 4x oversampled signal, the gain needed
+ * is held over the lookahead window and smoothed with a moving
+ * average of the same length so it reaches the target when the
+ * peak gets out of the delay line.
+ */
+class limiter : public dspNode
+{
+public:
+    static constexpr int OVERSAMPLING = 4;
+    static constexpr int TAPS = 8;
+
+private:
+    /// Linear ceiling
+    const float m_ceiling;
+
+    /// Lookahead window in frames
+    unsigned int m_window;
+
+    float m_releaseCoeff;
+
+    /// Interpolation filters for the intermediate phases
+    float m_phases[OVERSAMPLING-1][TAPS];
+
+    /// Last TAPS samples per channel, stored twice so the window is contiguous
+    std::vector<float> m_history;
+    size_t m_historyPos;
+
+    /// Audio delay line, interleaved
+    std::vector<float> m_delay;
+    size_t m_delayPos;
+
+    /// Sliding minimum of the required gain, a monotonic queue
+    std::vector<float> m_minGain;
+    std::vector<uint64_t> m_minFrame;
+    size_t m_minHead;
+    size_t m_minSize;
+    uint64_t m_frame;
+
+    /// Inter-sample peak before the current sample
+    float m_lastInterval;
+
+    float m_release;
+
+    /// Moving average
+    std::vector<float> m_average;
+    size_t m_averagePos;
+    double m_sum;
+
+public:
+    /// Ceiling in dBTP
+    limiter(float ceiling);
+    ~limiter() override = default;
+
+    const char* name() const override { return "Limiter"; }
+
+    void init(unsigned int sampleRate, unsigned int channels) override;
+
+    void reset() override;
+
+    unsigned int latency() const override { return m_window + TAPS/2 - 1; }
+
+    void process(float* buffer, size_t frames) override;
+};
+
+#endif
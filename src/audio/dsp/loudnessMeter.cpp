@@ -0,0 +1,242 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "loudnessMeter.h"
+
+#include "interpolator.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+constexpr double PI = 3.14159265358979323846;
+
+constexpr size_t CHUNK_FRAMES = 1024;
+
+// Gating blocks as multiples of the 100 ms sub-blocks
+constexpr size_t MOMENTARY_BLOCKS = 4;
+constexpr size_t SHORT_TERM_BLOCKS = 30;
+
+constexpr double ABSOLUTE_GATE = -70.;
+constexpr double RELATIVE_GATE = -10.;
+constexpr double RANGE_GATE = -20.;
+
+constexpr double RANGE_LOW = 0.10;
+constexpr double RANGE_HIGH = 0.95;
+
+/// Mean square of the given loudness
+double fromLufs(double lufs) { return std::pow(10., (lufs + 0.691) / 10.); }
+
+/// Flush tiny values so silence doesn't leave denormals in the state
+inline void flush(float* v)
+{
+    for (int l=0; l<4; l++)
+    {
+        if (std::fabs(v[l]) < 1e-20f)
+            v[l] = 0.f;
+    }
+}
+
+/// Gated mean square of the blocks, returns the number of blocks above the threshold
+size_t gatedMean(const std::vector<double>& blocks, double threshold, double& mean)
+{
+    double sum = 0.;
+    size_t n = 0;
+    for (double z: blocks)
+    {
+        if (z > threshold)
+        {
+            sum += z;
+            n++;
+        }
+    }
+    mean = n ? sum / n : 0.;
+    return n;
+}
+}
+
+loudnessMeter::loudnessMeter(unsigned int sampleRate, unsigned int channels) :
+    m_channels(channels),
+    m_blockFrames(std::max(1u, (sampleRate + 5) / 10)),
+    m_state(channels),
+    m_weights(channels, 1.f),
+    m_scratch(CHUNK_FRAMES * channels),
+    m_history(channels * TAPS * 2, 0.f),
+    m_historyPos(0),
+    m_peak(0.f),
+    m_energy(0.),
+    m_blockFill(0)
+{
+    // BS.1770 pre-filter, a high shelf modeling the head,
+    // followed by the RLB high pass, recomputed for the samplerate
+    std::memset(&m_kWeighting, 0, sizeof(m_kWeighting));
+    std::fill(m_kWeighting.b0, m_kWeighting.b0+4, 1.f);
+
+    double K = std::tan(PI * 1681.974450955533 / sampleRate);
+    double Q = 0.7071752369554196;
+    const double Vh = std::pow(10., 3.999843853973347 / 20.);
+    const double Vb = std::pow(Vh, 0.4996667741545416);
+    double a0 = 1. + K / Q + K * K;
+    m_kWeighting.b0[0] = (Vh + Vb * K / Q + K * K) / a0;
+    m_kWeighting.b1[0] = 2. * (K * K - Vh) / a0;
+    m_kWeighting.b2[0] = (Vh - Vb * K / Q + K * K) / a0;
+    m_kWeighting.a1[0] = 2. * (K * K - 1.) / a0;
+    m_kWeighting.a2[0] = (1. - K / Q + K * K) / a0;
+
+    K = std::tan(PI * 38.13547087602444 / sampleRate);
+    Q = 0.5003270373238773;
+    a0 = 1. + K / Q + K * K;
+    m_kWeighting.b0[1] = 1.f;
+    m_kWeighting.b1[1] = -2.f;
+    m_kWeighting.b2[1] = 1.f;
+    m_kWeighting.a1[1] = 2. * (K * K - 1.) / a0;
+    m_kWeighting.a2[1] = (1. - K / Q + K * K) / a0;
+
+    std::memset(m_state.data(), 0, m_state.size() * sizeof(simd::biquad4State_t));
+
+    // surround channels of 5.0 and 5.1 layouts get +1.5 dB, LFE is left out
+    if (channels == 5)
+    {
+        m_weights[3] = 1.41f;
+        m_weights[4] = 1.41f;
+    }
+    else if (channels == 6)
+    {
+        m_weights[3] = 0.f;
+        m_weights[4] = 1.41f;
+        m_weights[5] = 1.41f;
+    }
+
+    designInterpolator(m_phases);
+}
+
+void loudnessMeter::truePeak(const float* buffer, size_t frames)
+{
+    for (size_t f=0; f<frames; f++, buffer+=m_channels)
+    {
+        for (unsigned int c=0; c<m_channels; c++)
+        {
+            float* history = &m_history[c * TAPS * 2];
+            history[m_historyPos] = buffer[c];
+            history[m_historyPos + TAPS] = buffer[c];
+
+            // oldest sample first
+            const float* h = history + m_historyPos + 1;
+            float peak = std::fabs(buffer[c]);
+            for (int p=0; p<OVERSAMPLING-1; p++)
+                peak = std::max(peak, std::fabs(simd::dot(h, m_phases[p], TAPS)));
+            m_peak = std::max(m_peak, peak);
+        }
+        m_historyPos = (m_historyPos + 1) % TAPS;
+    }
+}
+
+void loudnessMeter::process(const float* buffer, size_t frames)
+{
+    while (frames > 0)
+    {
+        const size_t n = std::min(frames, CHUNK_FRAMES);
+
+        truePeak(buffer, n);
+
+        float* const scratch = m_scratch.data();
+        std::memcpy(scratch, buffer, n * m_channels * sizeof(float));
+        for (unsigned int c=0; c<m_channels; c++)
+        {
+            simd::biquad4State_t& state = m_state[c];
+            simd::cascade4(m_kWeighting, state, scratch+c, n, m_channels);
+            flush(state.y);
+            flush(state.z1);
+            flush(state.z2);
+        }
+
+        const float* s = scratch;
+        for (size_t f=0; f<n; f++, s+=m_channels)
+        {
+            float sum = 0.f;
+            for (unsigned int c=0; c<m_channels; c++)
+                sum += m_weights[c] * s[c] * s[c];
+            m_energy += sum;
+
+            if (++m_blockFill == m_blockFrames)
+            {
+                m_blocks.push_back(m_energy);
+                m_energy = 0.;
+                m_blockFill = 0;
+            }
+        }
+
+        buffer += n * m_channels;
+        frames -= n;
+    }
+}
+
+double loudnessMeter::energy(size_t block, size_t n) const
+{
+    double sum = 0.;
+    for (size_t i=block; i<block+n; i++)
+        sum += m_blocks[i];
+    return sum / (n * m_blockFrames);
+}
+
+loudness_t loudnessMeter::result() const
+{
+    loudness_t result;
+    result.peak = m_peak;
+
+    const double absolute = fromLufs(ABSOLUTE_GATE);
+
+    // 400 ms blocks overlapping by 75%
+    std::vector<double> blocks;
+    for (size_t i=0; i+MOMENTARY_BLOCKS<=m_blocks.size(); i++)
+        blocks.push_back(energy(i, MOMENTARY_BLOCKS));
+
+    double mean;
+    if (gatedMean(blocks, absolute, mean) > 0)
+    {
+        const double relative = mean * std::pow(10., RELATIVE_GATE / 10.);
+        result.blocks = gatedMean(blocks, std::max(absolute, relative), mean);
+        if (result.blocks > 0)
+            result.integrated = lufs(mean);
+    }
+
+    // 3 s blocks for the range
+    blocks.clear();
+    for (size_t i=0; i+SHORT_TERM_BLOCKS<=m_blocks.size(); i++)
+        blocks.push_back(energy(i, SHORT_TERM_BLOCKS));
+
+    if (gatedMean(blocks, absolute, mean) > 0)
+    {
+        const double threshold = std::max(absolute, mean * std::pow(10., RANGE_GATE / 10.));
+        std::vector<double> levels;
+        for (double z: blocks)
+        {
+            if (z > threshold)
+                levels.push_back(lufs(z));
+        }
+        if (levels.size() > 1)
+        {
+            std::sort(levels.begin(), levels.end());
+            const size_t last = levels.size() - 1;
+            result.range = levels[std::lround(last * RANGE_HIGH)] - levels[std::lround(last * RANGE_LOW)];
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,98 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef LOUDNESSMETER_H
+#define LOUDNESSMETER_H
+
+#include "converter/simd.h"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+/// Loudness measurement
+struct loudness_t
+{
+    float integrated = NAN; ///< LUFS, NaN if not measured
+    float range = 0.f;      ///< LU
+    float peak = 0.f;       ///< linear true peak
+    uint32_t blocks = 0;    ///< gating blocks above the thresholds
+};
+
+/**
+ * EBU R128 loudness meter.
+ * The signal is K-weighted by two biquads running in the lanes of
+ * a SIMD cascade, mean squares are collected over 100 ms sub-blocks
+ * which are combined into the overlapping gating blocks at the end.
+ * True peak is measured on a 4x oversampled signal.
+ */
+class loudnessMeter
+{
+public:
+    static constexpr int OVERSAMPLING = 4;
+    static constexpr int TAPS = 12;
+
+private:
+    const unsigned int m_channels;
+
+    /// Frames in a sub-block
+    const unsigned int m_blockFrames;
+
+    simd::biquad4_t m_kWeighting;
+    std::vector<simd::biquad4State_t> m_state;
+
+    std::vector<float> m_weights;
+    std::vector<float> m_scratch;
+
+    /// Interpolation filters for the intermediate phases
+    float m_phases[OVERSAMPLING-1][TAPS];
+
+    /// Last TAPS samples per channel, stored twice so the window is contiguous
+    std::vector<float> m_history;
+    size_t m_historyPos;
+
+    float m_peak;
+
+    /// Weighted energy of the completed sub-blocks
+    std::vector<double> m_blocks;
+    double m_energy;
+    unsigned int m_blockFill;
+
+private:
+    loudnessMeter(const loudnessMeter&) = delete;
+    loudnessMeter& operator=(const loudnessMeter&) = delete;
+
+    void truePeak(const float* buffer, size_t frames);
+
+    /// Mean square of n sub-blocks starting from the given one
+    double energy(size_t block, size_t n) const;
+
+public:
+    loudnessMeter(unsigned int sampleRate, unsigned int channels);
+
+    /// Feed interleaved frames
+    void process(const float* buffer, size_t frames);
+
+    /// Gated integrated loudness, loudness range and true peak
+    loudness_t result() const;
+
+    /// Loudness of a mean square value
+    static double lufs(double energy) { return -0.691 + 10. * std::log10(energy); }
+};
+
+#endif
@@ -0,0 +1,45 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PREAMP_H
+#define PREAMP_H
+
+#include "dspNode.h"
+
+/**
+ * Fixed gain
+ */
+class preamp : public dspNode
+{
+private:
+    /// Linear gain
+    const float m_gain;
+
+public:
+    /// Gain in dB
+    preamp(float gain);
+    ~preamp() override = default;
+
+    const char* name() const override { return "Preamp"; }
+
+    bool active() const override { return m_gain != 1.f; }
+
+    void process(float* buffer, size_t frames) override;
+};
+
+#endif
@@ -91,9 +91,10 @@ QStringList adlBackend::ext() { return QString(EXT).split("|"); }
 adlBackend::adlBackend(const QString& fileName) :
     input(name),
     m_currentTrack(0),
-    m_config(name)
+    m_config(name),
+    m_samplerate(m_config.samplerate())
 {
-    m_player = adl_init(m_config.samplerate());
+    m_player = adl_init(m_samplerate);
     if (!m_player)
     {
         QString error = QString("Error: %1").arg(adl_errorString());
@@ -142,6 +143,31 @@ adlBackend::~adlBackend()
     adl_close(m_player);
 }
 
+bool adlBackend::setSamplerate(unsigned int rate)
+{
+    // output rate is fixed at init
+    struct ADL_MIDIPlayer *player = adl_init(rate);
+    if (!player)
+        return false;
+
+    if (!m_config.woplPath().isEmpty())
+        adl_openBankFile(player, m_config.woplPath().toUtf8().constData());
+
+    if (adl_openFile(player, songLoaded().toUtf8().constData()) < 0)
+    {
+        qWarning() << "Warning: " << adl_errorInfo(player);
+        adl_close(player);
+        return false;
+    }
+
+    adl_selectSongNum(player, m_currentTrack);
+
+    adl_close(m_player);
+    m_player = player;
+    m_samplerate = rate;
+    return true;
+}
+
 bool adlBackend::rewind()
 {
     adl_positionRewind(m_player);
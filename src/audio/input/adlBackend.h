@@ -102,6 +102,8 @@ private:
 
     adlConfig m_config;
 
+    unsigned int m_samplerate;
+
 private:
     adlBackend(const QString& fileName);
 
@@ -136,7 +138,10 @@ public:
     bool seek(double pos) override;
 
     /// Get samplerate
-    unsigned int samplerate() const override { return m_config.samplerate(); }
+    unsigned int samplerate() const override { return m_samplerate; }
+
+    /// Render at the given samplerate
+    bool setSamplerate(unsigned int rate) override;
 
     /// Get channels
     unsigned int channels() const override { return 2; }
@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2006-2023 Leandro Nini
+ *  Copyright (C) 2006-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -317,6 +317,14 @@ ffmpegBackend::ffmpegBackend(const QString& fileName) :
         m_metaData.addInfo(metaData::TRACK_NUMBER, getMetadata("track"));
         m_metaData.addInfo(metaData::COMMENT, getMetadata("comment"));
 
+        for (const char* tag: { "REPLAYGAIN_TRACK_GAIN", "REPLAYGAIN_TRACK_PEAK",
+                "REPLAYGAIN_ALBUM_GAIN", "REPLAYGAIN_ALBUM_PEAK", "R128_TRACK_GAIN", "R128_ALBUM_GAIN" })
+        {
+            const QString value = getMetadata(tag);
+            if (!value.isEmpty())
+                m_metaData.addReplayGain(tag, value);
+        }
+
         setDuration(m_formatContext->duration/1000);
 
         songLoaded(fileName);
@@ -117,13 +117,14 @@ gmeBackend::gmeBackend(const QString& fileName) :
     , m_stil(nullptr)
 #endif
     , m_config(name)
+    , m_samplerate(m_config.samplerate())
 {
     gme_type_t fileType;
     checkRetCode(gme_identify_file(fileName.toUtf8().constData(), &fileType));
 
     qDebug() << "System" << gme_type_system(fileType);
 
-    m_emu = gme_new_emu(fileType, m_config.samplerate());
+    m_emu = gme_new_emu(fileType, m_samplerate);
     if (m_emu == nullptr)
         throw loadError("Error creating gme emu");
 
@@ -268,6 +269,41 @@ bool gmeBackend::rewind()
     return true;
 }
 
+bool gmeBackend::setSamplerate(unsigned int rate)
+{
+    // emu rate is fixed at creation
+    Music_Emu *emu = gme_new_emu(gme_type(m_emu), rate);
+    if (emu == nullptr)
+        return false;
+
+    if (m_config.equalizer())
+    {
+        gme_equalizer_t eq;
+        eq.bass   = m_config.bass_freq();
+        eq.treble = m_config.treble_dB();
+        gme_set_equalizer(emu, &eq);
+    }
+
+    const QString fileName = songLoaded();
+    const char* error = gme_load_file(emu, fileName.toUtf8().constData());
+    if (error)
+    {
+        qWarning() << error;
+        gme_delete(emu);
+        return false;
+    }
+
+    QFileInfo fInfo(fileName);
+    QString m3u = QString("%1/%2.m3u").arg(fInfo.canonicalPath()).arg(fInfo.completeBaseName());
+    gme_load_m3u(emu, m3u.toLocal8Bit().constData());
+
+    gme_delete(m_emu);
+    m_emu = emu;
+    m_samplerate = rate;
+
+    return subtune(m_currentTrack+1);
+}
+
 bool gmeBackend::subtune(unsigned int i)
 {
     if ((i > 0) && (i <= (unsigned int)gme_track_count(m_emu)))
@@ -116,6 +116,8 @@ private:
 
     gmeConfig m_config;
 
+    unsigned int m_samplerate;
+
 private:
     gmeBackend(const QString& fileName);
 
@@ -152,7 +154,10 @@ public:
     bool subtune(unsigned int i) override;
 
     /// Get samplerate
-    unsigned int samplerate() const override { return m_config.samplerate(); }
+    unsigned int samplerate() const override { return m_samplerate; }
+
+    /// Render at the given samplerate
+    bool setSamplerate(unsigned int rate) override;
 
     /// Get channels
     unsigned int channels() const override { return 2; }
@@ -160,11 +160,12 @@ QStringList hvlBackend::ext() { return QString(EXT).split("|"); }
 hvlBackend::hvlBackend(const QString& fileName) :
     input(name),
     m_buffer(nullptr),
-    m_config(name, iconHvl, 1006)
+    m_config(name, iconHvl, 1006),
+    m_samplerate(m_config.samplerate())
 {
     hvl_InitReplayer();
 
-    m_tune = hvl_LoadTune((TEXT*)fileName.toUtf8().constData(), m_config.samplerate(), 2);
+    m_tune = hvl_LoadTune((TEXT*)fileName.toUtf8().constData(), m_samplerate, 2);
 
     if (m_tune == nullptr)
         throw loadError("Error loading tune");
@@ -179,7 +180,7 @@ hvlBackend::hvlBackend(const QString& fileName) :
     m_metaData.addInfo(metaData::COMMENT, comment.trimmed());
 
     m_left = 0;
-    m_size = (m_config.samplerate()*4) / 50;
+    m_size = (m_samplerate*4) / 50;
     m_buffer = new char[m_size];
 
     songLoaded(fileName);
@@ -191,6 +192,26 @@ hvlBackend::~hvlBackend()
     delete[] m_buffer;
 }
 
+bool hvlBackend::setSamplerate(unsigned int rate)
+{
+    // mixing rate is fixed at load time
+    struct hvl_tune *tune = hvl_LoadTune((TEXT*)songLoaded().toUtf8().constData(), rate, 2);
+    if (tune == nullptr)
+        return false;
+
+    hvl_InitSubsong(tune, m_tune->ht_SongNum);
+    hvl_FreeTune(m_tune);
+    m_tune = tune;
+
+    m_samplerate = rate;
+
+    delete[] m_buffer;
+    m_left = 0;
+    m_size = (m_samplerate*4) / 50;
+    m_buffer = new char[m_size];
+    return true;
+}
+
 bool hvlBackend::rewind()
 {
     return hvl_InitSubsong(m_tune, m_tune->ht_SongNum) == HVL_TRUE;
@@ -94,6 +94,8 @@ private:
 
     hvlConfig m_config;
 
+    unsigned int m_samplerate;
+
 private:
     hvlBackend(const QString& fileName);
 
@@ -122,7 +124,10 @@ public:
     bool subtune(unsigned int i) override;
 
     /// Get samplerate
-    unsigned int samplerate() const override { return m_config.samplerate(); }
+    unsigned int samplerate() const override { return m_samplerate; }
+
+    /// Render at the given samplerate
+    bool setSamplerate(unsigned int rate) override;
 
     /// Get channels
     unsigned int channels() const override { return 2; }
@@ -0,0 +1,234 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "hvscCache.h"
+
+#include "sidlib_features.h"
+
+#ifdef HAVE_STILVIEW
+#  include <stilview/stil.h>
+#endif
+
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+
+// HVSC path to STIL.
+#define HVSC_STIL "/DOCUMENTS/STIL.txt"
+
+// HVSC path to BUGlist.
+#define HVSC_BUGLIST "/DOCUMENTS/BUGlist.txt"
+
+/*****************************************************************/
+
+int songLengthDb::parseTime(const QByteArray& time)
+{
+    // format is m:ss[.SSS] optionally followed by attributes in brackets
+    const int colon = time.indexOf(':');
+    if (colon <= 0)
+        return -1;
+
+    int end = time.indexOf('(');
+    if (end < 0)
+        end = time.size();
+
+    bool ok;
+    const int minutes = time.left(colon).toInt(&ok);
+    if (!ok)
+        return -1;
+    const double seconds = time.mid(colon+1, end-colon-1).toDouble(&ok);
+    if (!ok)
+        return -1;
+
+    return minutes*60000 + static_cast<int>(seconds*1000. + 0.5);
+}
+
+bool songLengthDb::load()
+{
+    QFile file(m_path);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    m_modified = QFileInfo(file).lastModified();
+
+    while (!file.atEnd())
+    {
+        const QByteArray line = file.readLine().trimmed();
+        if (line.isEmpty() || (line[0] == ';') || (line[0] == '['))
+            continue;
+
+        const int eq = line.indexOf('=');
+        if (eq != 2*16)
+            continue;
+
+        const QByteArray md5 = QByteArray::fromHex(line.left(eq));
+
+        QVector<int> lengths;
+        for (const QByteArray& time: line.mid(eq+1).split(' '))
+        {
+            if (!time.isEmpty())
+                lengths.append(parseTime(time));
+        }
+
+        m_lengths.insert(md5, lengths);
+    }
+
+    qDebug() << "Parsed" << m_lengths.size() << "songlength entries in" << timer.elapsed() << "ms";
+    return !m_lengths.isEmpty();
+}
+
+int songLengthDb::lengthMs(const char* md5, unsigned int song) const
+{
+    const auto it = m_lengths.constFind(QByteArray::fromHex(QByteArray(md5)));
+    if (it == m_lengths.constEnd())
+        return -1;
+
+    if ((song < 1) || (song > static_cast<unsigned int>(it->size())))
+        return -1;
+
+    return it->at(song-1);
+}
+
+/*****************************************************************/
+
+hvscCache* hvscCache::instance()
+{
+    static hvscCache c;
+    return &c;
+}
+
+hvscCache::~hvscCache() = default;
+
+std::shared_ptr<const songLengthDb> hvscCache::songLengths(const QString& hvscPath)
+{
+    if (hvscPath.isEmpty())
+        return nullptr;
+
+    const QString slDbPath(QString("%1%2DOCUMENTS%2Songlengths").arg(hvscPath, QDir::separator()));
+
+    QStringList candidates;
+#ifdef FEAT_NEW_SONLEGTH_DB
+    candidates << QString(slDbPath).append(".md5");
+#endif
+    candidates << QString(slDbPath).append(".txt");
+
+    QMutexLocker locker(&m_dbMutex);
+
+    for (const QString& path: candidates)
+    {
+        const QFileInfo info(path);
+        if (!info.isFile())
+            continue;
+
+        if (m_db && (m_db->m_path == path) && (m_db->m_modified == info.lastModified()))
+            return m_db;
+
+        qDebug() << "SL DB path:" << path;
+        std::shared_ptr<songLengthDb> db(new songLengthDb(path, path.endsWith(".md5")));
+        if (db->load())
+        {
+            m_db = db;
+            return m_db;
+        }
+
+        qWarning() << "Cannot load songlength DB" << path;
+    }
+
+    m_db.reset();
+    return nullptr;
+}
+
+QString hvscCache::stilInfo(const QString& hvscPath, const QString& fileName)
+{
+#ifdef HAVE_STILVIEW
+    if (hvscPath.isEmpty())
+        return QString();
+
+    QMutexLocker locker(&m_stilMutex);
+
+    const QDateTime modified = QFileInfo(QString(hvscPath).append(HVSC_STIL)).lastModified();
+    if (!m_stil || (m_stilPath != hvscPath) || (m_stilModified != modified))
+    {
+        m_stilPath = hvscPath;
+        m_stilModified = modified;
+        m_stil.reset(new STIL(HVSC_STIL, HVSC_BUGLIST));
+        if (!m_stil->setBaseDir(hvscPath.toLocal8Bit().constData()))
+        {
+            qWarning() << m_stil->getErrorStr();
+            m_stil.reset();
+        }
+    }
+
+    if (!m_stil)
+        return QString();
+
+    // returned strings point to STIL internal buffers, copy them while locked
+    const QByteArray fName = fileName.toUtf8();
+    qDebug() << "Retrieving STIL info";
+    QString comment = QString::fromLatin1(m_stil->getAbsGlobalComment(fName.constData()));
+    if (!comment.isEmpty())
+        comment.append('\n');
+
+    comment.append(QString::fromLatin1(m_stil->getAbsEntry(fName.constData())));
+
+    QString bug = QString::fromLatin1(m_stil->getAbsBug(fName.constData()));
+    if (!bug.isEmpty())
+    {
+        comment.append('\n');
+        comment.append(bug);
+    }
+    return comment;
+#else
+    Q_UNUSED(hvscPath)
+    Q_UNUSED(fileName)
+    return QString();
+#endif
+}
+
+QByteArray hvscCache::rom(const QString& romPath)
+{
+    if (romPath.isEmpty())
+        return QByteArray();
+
+    const QFileInfo info(romPath);
+
+    QMutexLocker locker(&m_romMutex);
+
+    auto it = m_roms.find(romPath);
+    if ((it != m_roms.end()) && (it->modified == info.lastModified()))
+        return it->data;
+
+    QFile f(romPath);
+    if (!f.open(QIODevice::ReadOnly))
+    {
+        m_roms.remove(romPath);
+        return QByteArray();
+    }
+
+    rom_t rom;
+    rom.modified = info.lastModified();
+    rom.data = f.readAll();
+    m_roms.insert(romPath, rom);
+    return rom.data;
+}
@@ -0,0 +1,124 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef HVSCCACHE_H
+#define HVSCCACHE_H
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+#include <memory>
+
+#ifdef HAVE_STILVIEW
+class STIL;
+#endif
+
+/**
+ * Parsed Songlengths database, immutable once loaded
+ * so it can be queried from any thread
+ */
+class songLengthDb
+{
+    friend class hvscCache;
+
+private:
+    // binary md5 -> subtune lengths in milliseconds
+    QHash<QByteArray, QVector<int>> m_lengths;
+
+    QString m_path;
+    QDateTime m_modified;
+    bool m_newFormat;
+
+private:
+    songLengthDb(const QString& path, bool newFormat) :
+        m_path(path),
+        m_newFormat(newFormat)
+    {}
+
+    bool load();
+
+    static int parseTime(const QByteArray& time);
+
+public:
+    /// True for Songlengths.md5, which uses the new md5 algorithm
+    bool newFormat() const { return m_newFormat; }
+
+    /// Get song length in milliseconds, -1 if not found
+    int lengthMs(const char* md5, unsigned int song) const;
+};
+
+/*****************************************************************/
+
+#define HVSCCACHE hvscCache::instance()
+
+/**
+ * Process-wide cache of HVSC documents and C64 ROMs,
+ * entries are reloaded when the underlying file changes
+ */
+class hvscCache
+{
+private:
+    struct rom_t
+    {
+        QDateTime modified;
+        QByteArray data;
+    };
+
+private:
+    QMutex m_dbMutex;
+    std::shared_ptr<const songLengthDb> m_db;
+
+#ifdef HAVE_STILVIEW
+    QMutex m_stilMutex;
+    std::unique_ptr<STIL> m_stil;
+    QString m_stilPath;
+    QDateTime m_stilModified;
+#endif
+
+    QMutex m_romMutex;
+    QHash<QString, rom_t> m_roms;
+
+private:
+    hvscCache() = default;
+    hvscCache(const hvscCache&) = delete;
+    hvscCache& operator=(const hvscCache&) = delete;
+    ~hvscCache();
+
+public:
+    /// Get singleton instance
+    static hvscCache* instance();
+
+    /// Get the Songlengths database for the given HVSC path, null if not available
+    std::shared_ptr<const songLengthDb> songLengths(const QString& hvscPath);
+
+    /// Get STIL comments and bugs for the given file
+    QString stilInfo(const QString& hvscPath, const QString& fileName);
+
+    /// Get ROM content, empty if not available
+    QByteArray rom(const QString& romPath);
+};
+
+#endif
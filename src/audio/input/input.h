@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2006-2025 Leandro Nini
+ *  Copyright (C) 2006-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -80,6 +80,12 @@ public:
     /// Get precision
     virtual sample_t precision() const =0;
 
+    /// Render at the given samplerate, for synthesized formats
+    virtual bool setSamplerate([[maybe_unused]] unsigned int rate) { return false; }
+
+    /// Decode to float for the processing bus, if natively supported
+    virtual bool setFloat([[maybe_unused]] bool enable) { return false; }
+
     /// Get fractional scale for fixed point types
     virtual unsigned int fract() const { return 0; }
 
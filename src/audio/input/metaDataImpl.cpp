@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2010-2021 Leandro Nini
+ *  Copyright (C) 2010-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -20,6 +20,9 @@
 
 #include <QDebug>
 
+// Loudness of the ReplayGain reference relative to the EBU R128 one
+constexpr float R128_TO_REPLAYGAIN = 5.f;
+
 #define gettext(x) x
 
 const char* metaDataImpl::mprisTags[LAST_ID] =
@@ -88,3 +91,51 @@ QString metaDataImpl::getInfo(const char* info) const
     auto it = m_infos.find(info);
     return it != m_infos.end() ? it.value() : QString();
 }
+
+bool metaDataImpl::addReplayGain(const QString& tag, const QString& value)
+{
+    float* dest;
+    bool r128 = false;
+    if (!tag.compare("REPLAYGAIN_TRACK_GAIN", Qt::CaseInsensitive))
+        dest = &m_replayGain.trackGain;
+    else if (!tag.compare("REPLAYGAIN_TRACK_PEAK", Qt::CaseInsensitive))
+        dest = &m_replayGain.trackPeak;
+    else if (!tag.compare("REPLAYGAIN_ALBUM_GAIN", Qt::CaseInsensitive))
+        dest = &m_replayGain.albumGain;
+    else if (!tag.compare("REPLAYGAIN_ALBUM_PEAK", Qt::CaseInsensitive))
+        dest = &m_replayGain.albumPeak;
+    else if (!tag.compare("R128_TRACK_GAIN", Qt::CaseInsensitive))
+    {
+        dest = &m_replayGain.trackGain;
+        r128 = true;
+    }
+    else if (!tag.compare("R128_ALBUM_GAIN", Qt::CaseInsensitive))
+    {
+        dest = &m_replayGain.albumGain;
+        r128 = true;
+    }
+    else
+        return false;
+
+    bool ok;
+    if (r128)
+    {
+        // Q7.8 fixed point dB relative to -23 LUFS
+        const int gain = value.trimmed().toInt(&ok);
+        if (ok)
+            *dest = gain / 256.f + R128_TO_REPLAYGAIN;
+    }
+    else
+    {
+        // gains are usually written as "-6.20 dB"
+        QString val = value.trimmed();
+        if (val.endsWith("dB", Qt::CaseInsensitive))
+            val.chop(2);
+        const float num = val.trimmed().toFloat(&ok);
+        if (ok)
+            *dest = num;
+    }
+
+    qDebug().nospace() << "replaygain: " << tag << ", value: " << value << (ok ? "" : " (invalid)");
+    return true;
+}
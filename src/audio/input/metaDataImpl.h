@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2010-2021 Leandro Nini
+ *  Copyright (C) 2010-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -38,6 +38,8 @@ private:
 
     QByteArray *m_img;
 
+    replayGain_t m_replayGain;
+
 public:
     metaDataImpl() : m_img(nullptr) {}
     ~metaDataImpl() { delete m_img; }
@@ -53,8 +55,17 @@ public:
     void addInfo(const mpris_t type, unsigned int info);
     void addInfo(QByteArray* img) { m_img = img; }
 
+    /// Set ReplayGain values
+    void setReplayGain(const replayGain_t& replayGain) { m_replayGain = replayGain; }
+
+    /**
+     * Parse a REPLAYGAIN_* or R128_* tag,
+     * returns false if the tag is not recognized.
+     */
+    bool addReplayGain(const QString& tag, const QString& value);
+
     /// Remove all info
-    void clearInfo() { m_infos.clear(); utils::delPtr(m_img); }
+    void clearInfo() { m_infos.clear(); utils::delPtr(m_img); m_replayGain = replayGain_t(); }
 
     /// Get song info
     int moreInfo(int i) const override;
@@ -65,6 +76,7 @@ public:
     QString getInfo(const mpris_t info) const override { return getInfo(mprisTags[info]); }
     QString getInfo(const char* info) const override;
     QByteArray* getImage() const override { return m_img; }
+    const replayGain_t& getReplayGain() const override { return m_replayGain; }
 };
 
 #endif
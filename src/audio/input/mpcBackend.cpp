@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2006-2022 Leandro Nini
+ *  Copyright (C) 2006-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -18,17 +18,13 @@
 
 #include "mpcBackend.h"
 
-#include "settings.h"
 #include "utils.h"
 #include "tag.h"
 
-#ifndef MPCDEC_SV8
-#  include <math.h>
-#endif
-
 #include <QDebug>
 #include <QLabel>
 
+#include <cmath>
 #include <cstring>
 
 // created by reswrap from file musepack.gif
@@ -176,28 +172,32 @@ mpcBackend::mpcBackend(const QString& fileName) :
     qDebug("FLOAT");
 #endif
 
-    if (SETTINGS->replayGain())
     {
-        // Replaygain reference level (is this correct?)
-        const double referenceLevel = 89.0;
+        replayGain_t replayGain;
 #ifdef MPCDEC_SV8
-        mpc_set_replay_level(m_demux, referenceLevel, MPC_TRUE,
-                (SETTINGS->replayGainMode() == settings::rg_t::Track) ? MPC_FALSE : MPC_TRUE,
-                MPC_TRUE);
+        // gains are stored as 256*dB below the 89 dB reference
+        // and peaks as 256*20*log10 of the 16 bit amplitude
+        constexpr float referenceLevel = 89.f;
+        if (m_si.gain_title)
+            replayGain.trackGain = referenceLevel - m_si.gain_title / 256.f;
+        if (m_si.peak_title)
+            replayGain.trackPeak = std::pow(10.f, m_si.peak_title / (20.f * 256.f)) / 32768.f;
+        if (m_si.gain_album)
+            replayGain.albumGain = referenceLevel - m_si.gain_album / 256.f;
+        if (m_si.peak_album)
+            replayGain.albumPeak = std::pow(10.f, m_si.peak_album / (20.f * 256.f)) / 32768.f;
 #else
-        float peak = SETTINGS->replayGainMode() ? m_si.peak_album : m_si.peak_title;
-        float gain = SETTINGS->replayGainMode() ? m_si.gain_album : m_si.gain_title;
-
-        peak = peak == 0. ? 1. : (1<<15) / pow(10, peak/(20*256));
-        gain = gain == 0. ? 1. : pow(10, (referenceLevel-gain/256)/20);
-
-        qDebug() << "peak:" << peak << "- gain:" << gain;
-
-        if (peak < gain)
-            gain = peak;
-
-        mpc_decoder_scale_output(&m_decoder, gain);
+        // gains are stored in hundredths of dB and peaks as 16 bit amplitude
+        if (m_si.gain_title)
+            replayGain.trackGain = m_si.gain_title / 100.f;
+        if (m_si.peak_title)
+            replayGain.trackPeak = m_si.peak_title / 32768.f;
+        if (m_si.gain_album)
+            replayGain.albumGain = m_si.gain_album / 100.f;
+        if (m_si.peak_album)
+            replayGain.albumPeak = m_si.peak_album / 32768.f;
 #endif
+        m_metaData.setReplayGain(replayGain);
     }
 
     m_bufIndex = 0;
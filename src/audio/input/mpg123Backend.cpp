@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2009-2023 Leandro Nini
+ *  Copyright (C) 2009-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -18,7 +18,6 @@
 
 #include "mpg123Backend.h"
 
-#include "settings.h"
 #include "genres.h"
 
 #include <algorithm>
@@ -194,12 +193,6 @@ mpg123Backend::mpg123Backend(const QString& fileName) :
             setDuration((err*1000LL)/m_samplerate);
         }
 
-        err = mpg123_param(m_handle, MPG123_RVA,
-            SETTINGS->replayGain()
-                ? (SETTINGS->replayGainMode() == settings::rg_t::Track) ? MPG123_RVA_ALBUM : MPG123_RVA_MIX
-                : MPG123_RVA_OFF,
-            0.);
-
         // Get metadata
         mpg123_id3v1* id3v1;
         mpg123_id3v2* id3v2;
@@ -368,6 +361,17 @@ mpg123Backend::mpg123Backend(const QString& fileName) :
                 }
             }
 
+            // ReplayGain
+            if (id3v2)
+            {
+                for (unsigned int i=0; i<id3v2->extras; i++)
+                {
+                    mpg123_text *entry = &id3v2->extra[i];
+                    if (entry->description.fill && entry->text.fill)
+                        m_metaData.addReplayGain(QString::fromUtf8(entry->description.p), QString::fromUtf8(entry->text.p));
+                }
+            }
+
             // Cover art
             if (id3v2 && id3v2->pictures)
             {
@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2006-2021 Leandro Nini
+ *  Copyright (C) 2006-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -91,6 +91,9 @@ inputConfig* oggBackend::cFactory() { return new oggConfig(name, iconOgg, 523);
 
 size_t oggBackend::fillBuffer(void* buffer, const size_t bufferSize)
 {
+    if (m_float)
+        return fillBufferFloat((float*)buffer, bufferSize);
+
     size_t n = 0;
     long read;
     do {
@@ -109,6 +112,35 @@ size_t oggBackend::fillBuffer(void* buffer, const size_t bufferSize)
     return n;
 }
 
+size_t oggBackend::fillBufferFloat(float* buffer, const size_t bufferSize)
+{
+    const size_t maxFrames = bufferSize / (m_channels * sizeof(float));
+    size_t frames = 0;
+    while (frames < maxFrames)
+    {
+        float **pcm;
+        int current_section;
+        const long read = ov_read_float(m_vf, &pcm, maxFrames - frames, &current_section);
+        if (read < 0)
+        {
+            qWarning() << "Decoding error:" << read;
+            return 0;
+        }
+        if (read == 0)
+            break;
+
+        // interleave
+        for (long i=0; i<read; i++)
+        {
+            for (unsigned int c=0; c<m_channels; c++)
+                *buffer++ = pcm[c][i];
+        }
+        frames += read;
+    }
+
+    return frames * m_channels * sizeof(float);
+}
+
 /*****************************************************************/
 
 void oggConfig::loadSettings()
@@ -127,6 +159,7 @@ QStringList oggBackend::ext() { return QString(EXT).split("|"); }
 
 oggBackend::oggBackend(const QString& fileName) :
     input(name),
+    m_float(false),
     m_config(name, iconOgg, 523)
 {
     m_file.setFileName(fileName);
@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2006-2021 Leandro Nini
+ *  Copyright (C) 2006-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -89,6 +89,8 @@ private:
 
     bool m_seekable;
 
+    bool m_float;
+
     oggConfig m_config;
 
 private:
@@ -102,6 +104,8 @@ private:
 private:
     oggBackend(const QString& fileName);
 
+    size_t fillBufferFloat(float* buffer, const size_t bufferSize);
+
 public:
     ~oggBackend() override;
 
@@ -127,7 +131,10 @@ public:
     unsigned int channels() const override { return m_channels; }
 
     /// Get precision
-    sample_t precision() const override { return m_config.precision(); }
+    sample_t precision() const override { return m_float ? sample_t::SAMPLE_FLOAT : m_config.precision(); }
+
+    /// Decode to float
+    bool setFloat(bool enable) override { m_float = enable; return true; }
 
     /// Callback function
     size_t fillBuffer(void* buffer, const size_t bufferSize) override;
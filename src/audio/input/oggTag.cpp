@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2006-2021 Leandro Nini
+ *  Copyright (C) 2006-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -22,6 +22,8 @@
 #include <QByteArray>
 #include <QString>
 
+#include <cstring>
+
 bool isTag(const char* orig, const char* tagName)
 {
     const int n = qstrlen(tagName);
@@ -60,6 +62,15 @@ bool getMetadata(const char* orig, QString* dest, const char* tagName)
     return false;
 }
 
+bool getReplayGain(const char* orig, metaDataImpl& data)
+{
+    const char* value = std::strchr(orig, '=');
+    if (value == nullptr)
+        return false;
+
+    return data.addReplayGain(QString::fromLatin1(orig, value-orig), QString::fromUtf8(value+1));
+}
+
 //METADATA_BLOCK_PICTURE
 /*
 <32>   The picture type according to the ID3v2 APIC frame:
@@ -113,6 +124,7 @@ void oggTag::parseTags(char **ptr, metaDataImpl& data)
         if (!getMetadata(*ptr, &album, "album"))
         if (!getMetadata(*ptr, &genre, "genre"))
         if (!getMetadata(*ptr, &comment, "comment"))
+        if (!getReplayGain(*ptr, data))
         {
             if (isTag(*ptr, "tracknumber"))
             {
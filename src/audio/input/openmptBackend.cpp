@@ -130,8 +130,15 @@ size_t openmptBackend::fillBuffer(void* buffer, const size_t bufferSize)
     const size_t frameSize = sizeof(float) * m_config.channels();
     size_t bufSize = bufferSize/frameSize;
     return frameSize * (m_config.channels() == 2
-        ? m_module->read_interleaved_stereo(m_config.samplerate(), bufSize, (float*)buffer)
-        : m_module->read(m_config.samplerate(), bufSize, (float*)buffer));
+        ? m_module->read_interleaved_stereo(m_samplerate, bufSize, (float*)buffer)
+        : m_module->read(m_samplerate, bufSize, (float*)buffer));
+}
+
+bool openmptBackend::setSamplerate(unsigned int rate)
+{
+    // rate is passed on each read
+    m_samplerate = rate;
+    return true;
 }
 
 /*****************************************************************/
@@ -176,7 +183,8 @@ bool openmptBackend::init()
 
 openmptBackend::openmptBackend(const QString& fileName) :
     input(name),
-    m_config(name, iconOpenmpt, 990)
+    m_config(name, iconOpenmpt, 990),
+    m_samplerate(m_config.samplerate())
 {
     bool tmpFile = false;
     QString fName;
@@ -105,6 +105,8 @@ private:
 
     openmptConfig m_config;
 
+    unsigned int m_samplerate;
+
 private:
     openmptBackend(const QString& fileName);
 
@@ -142,7 +144,10 @@ public:
     bool subtune(unsigned int i) override;
 
     /// Get samplerate
-    unsigned int samplerate() const override { return m_config.samplerate(); }
+    unsigned int samplerate() const override { return m_samplerate; }
+
+    /// Render at the given samplerate
+    bool setSamplerate(unsigned int rate) override;
 
     /// Get channels
     unsigned int channels() const override { return m_config.channels(); }
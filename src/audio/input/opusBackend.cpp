@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2006-2021 Leandro Nini
+ *  Copyright (C) 2006-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -116,14 +116,18 @@ size_t opusBackend::fillBuffer(void* buffer, const size_t bufferSize)
 {
     size_t n = 0;
     int read;
+    // the decoder works in float internally
+    const size_t frameSize = m_float ? 2*sizeof(float) : 2*sizeof(opus_int16);
     do {
-        read = op_read_stereo(m_of, (opus_int16*)buffer+n/2, (bufferSize-n)/2);
+        read = m_float
+            ? op_read_float_stereo(m_of, (float*)buffer+n/sizeof(float), (bufferSize-n)/sizeof(float))
+            : op_read_stereo(m_of, (opus_int16*)buffer+n/2, (bufferSize-n)/2);
         if (read < 0)
         {
             qWarning() << "Decoding error:" << read;
             return 0;
         }
-        n += read*4;
+        n += read*frameSize;
     } while (read && (n < bufferSize));
 
     return n;
@@ -135,7 +139,8 @@ QStringList opusBackend::ext() { return QStringList(EXT); }
 
 opusBackend::opusBackend(const QString& fileName) :
     input(name),
-    m_config(name, iconOpus, 952)
+    m_config(name, iconOpus, 952),
+    m_float(false)
 {
     m_file.setFileName(fileName);
     if (!m_file.open(QIODevice::ReadOnly))
@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2006-2021 Leandro Nini
+ *  Copyright (C) 2006-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -70,6 +70,8 @@ private:
 
     bool m_seekable;
 
+    bool m_float;
+
 private:
     static OpusFileCallbacks opus_callbacks;
 
@@ -106,7 +108,10 @@ public:
     unsigned int channels() const override { return 2; }
 
     /// Get precision
-    sample_t precision() const override { return sample_t::S16; }
+    sample_t precision() const override { return m_float ? sample_t::SAMPLE_FLOAT : sample_t::S16; }
+
+    /// Decode to float
+    bool setFloat(bool enable) override { m_float = enable; return true; }
 
     /// Callback function
     size_t fillBuffer(void* buffer, const size_t bufferSize) override;
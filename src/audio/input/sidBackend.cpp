@@ -18,6 +18,7 @@
 
 #include "sidBackend.h"
 
+#include "hvscCache.h"
 #include "settings.h"
 #include "utils.h"
 
@@ -66,12 +67,6 @@ extern const unsigned char iconSid[126] =
 //sid|dat
 #define EXT "sid|mus|prg|p00"
 
-// HVSC path to STIL.
-#define HVSC_STIL "/DOCUMENTS/STIL.txt"
-
-// HVSC path to BUGlist.
-#define HVSC_BUGLIST "/DOCUMENTS/BUGlist.txt"
-
 #define CREDITS "Sidplayfp<br>Copyright \u00A9 Simon White, Dag Lem, Antti Lankila, Leandro Nini"
 #define LINK    "https://github.com/libsidplayfp/libsidplayfp/"
 
@@ -254,12 +249,8 @@ QStringList sidBackend::ext() { return QString(EXT).split("|"); }
 
 sidBackend::sidBackend(const QString& fileName) :
     input(name),
-#ifdef HAVE_STILVIEW
-    m_stil(nullptr),
-#endif
-    m_db(nullptr),
-    m_newSonglengthDB(false),
-    m_config(name, iconSid, 126)
+    m_config(name, iconSid, 126),
+    m_samplerate(m_config.samplerate())
 {
     createEmu();
 
@@ -271,7 +262,7 @@ sidBackend::sidBackend(const QString& fileName) :
         throw loadError(error);
     }
 
-    openHvsc(m_config.hvscPath());
+    m_db = HVSCCACHE->songLengths(m_config.hvscPath());
 
     if (fileName.endsWith(".mus"))
     {
@@ -294,23 +285,10 @@ sidBackend::sidBackend(const QString& fileName) :
     getInfo(m_tune->getInfo());
 
 #ifdef HAVE_STILVIEW
-    if (m_stil != nullptr)
     {
-        const char* fName = fileName.toUtf8().constData();
-        qDebug() << "Retrieving STIL info";
-        QString comment = QString::fromLatin1(m_stil->getAbsGlobalComment(fName));
+        const QString comment = HVSCCACHE->stilInfo(m_config.hvscPath(), fileName);
         if (!comment.isEmpty())
-            comment.append('\n');
-
-        comment.append(QString::fromLatin1(m_stil->getAbsEntry(fName)));
-
-        QString bug = QString::fromLatin1(m_stil->getAbsBug(fName));
-        if (!bug.isEmpty())
-        {
-            comment.append('\n');
-            comment.append(bug);
-        }
-        m_metaData.addInfo(metaData::COMMENT, comment);
+            m_metaData.addInfo(metaData::COMMENT, comment);
     }
 #endif
 
@@ -325,11 +303,6 @@ sidBackend::~sidBackend()
     deleteEmu();
 
     delete m_tune;
-
-    delete m_db;
-#ifdef HAVE_STILVIEW
-    delete m_stil;
-#endif
 }
 
 void sidBackend::deleteEmu()
@@ -344,13 +317,14 @@ void sidBackend::createEmu()
     std::unique_ptr<sidplayfp> emu(new sidplayfp());
 
     {
-        const unsigned char* kernal = loadRom(m_config.kernalPath());
-        const unsigned char* basic = loadRom(m_config.basicPath());
-        const unsigned char* chargen = loadRom(m_config.chargenPath());
-        emu->setRoms(kernal, basic, chargen);
-        delete [] kernal;
-        delete [] basic;
-        delete [] chargen;
+        // ROMs are copied by the emulator, cached data can be shared
+        const QByteArray kernal = HVSCCACHE->rom(m_config.kernalPath());
+        const QByteArray basic = HVSCCACHE->rom(m_config.basicPath());
+        const QByteArray chargen = HVSCCACHE->rom(m_config.chargenPath());
+        emu->setRoms(
+            kernal.isEmpty() ? nullptr : (const unsigned char*)kernal.constData(),
+            basic.isEmpty() ? nullptr : (const unsigned char*)basic.constData(),
+            chargen.isEmpty() ? nullptr : (const unsigned char*)chargen.constData());
     }
 
     sidbuilder *emuSid = nullptr;
@@ -427,7 +401,7 @@ void sidBackend::createEmu()
     cfg.defaultSidModel = m_config.sidModel();
     cfg.forceSidModel = m_config.forceSidModel();
     cfg.playback = (m_config.channels() == 2) ? SidConfig::STEREO : SidConfig::MONO;
-    cfg.frequency = m_config.samplerate();
+    cfg.frequency = m_samplerate;
     cfg.secondSidAddress = m_config.secondSidAddress();
 #ifdef FEAT_THIRD_SID
     cfg.thirdSidAddress = m_config.thirdSidAddress();
@@ -453,23 +427,6 @@ void sidBackend::createEmu()
     m_sidplayfp = emu.release();
 }
 
-const unsigned char* sidBackend::loadRom(const QString& romPath)
-{
-    if (romPath.isEmpty())
-        return nullptr;
-
-    QFile f;
-    f.setFileName(romPath);
-    if (!f.open(QIODevice::ReadOnly))
-        return nullptr;
-
-    const long size = f.size();
-    char* data = new char[size];
-    f.read(data, size);
-    f.close();
-    return (const unsigned char*)data;
-}
-
 bool sidBackend::rewind()
 {
 #ifdef FEAT_NEW_PLAY_API
@@ -481,6 +438,24 @@ bool sidBackend::rewind()
     return true;
 }
 
+bool sidBackend::setSamplerate(unsigned int rate)
+{
+    SidConfig cfg = m_sidplayfp->config();
+    cfg.frequency = rate;
+    if (!m_sidplayfp->config(cfg))
+    {
+        qWarning() << m_sidplayfp->error();
+        return false;
+    }
+
+#ifdef FEAT_NEW_PLAY_API
+    m_rem_buffer.resize(0);
+    m_sidplayfp->initMixer(m_config.channels() == 2);
+#endif
+    m_samplerate = rate;
+    return true;
+}
+
 bool sidBackend::subtune(unsigned int i)
 {
     if (i <= m_tune->getInfo()->songs())
@@ -501,17 +476,17 @@ bool sidBackend::loadTune(int num)
     if (!m_sidplayfp->load(m_tune))
         return false;
 
-    if (m_db != nullptr)
+    if (m_db)
     {
-        int_least32_t songLength;
-#ifdef FEAT_NEW_SONLEGTH_DB
-        songLength = m_newSonglengthDB ? m_db->lengthMs(*m_tune) : (m_db->length(*m_tune) * 1000);
-#else
         char md5[SidTune::MD5_LENGTH+1];
-        m_tune->createMD5(md5);
-        qDebug() << "Tune md5:" << md5;
-        songLength = m_db->length(md5, m_tune->getInfo()->currentSong()) * 1000;
+#ifdef FEAT_NEW_SONLEGTH_DB
+        if (m_db->newFormat())
+            m_tune->createMD5New(md5);
+        else
 #endif
+            m_tune->createMD5(md5);
+        qDebug() << "Tune md5:" << md5;
+        const int songLength = m_db->lengthMs(md5, m_tune->getInfo()->currentSong());
         setDuration((songLength < 0) ? 0 : songLength);
     }
 
@@ -588,36 +563,6 @@ void sidBackend::getInfo(const SidTuneInfo* tuneInfo) noexcept
 #endif
 }
 
-void sidBackend::openHvsc(const QString& hvscPath)
-{
-    if (hvscPath.isEmpty())
-        return;
-
-#ifdef HAVE_STILVIEW
-    m_stil = new STIL(HVSC_STIL, HVSC_BUGLIST);
-
-    if (!m_stil->setBaseDir(hvscPath.toLocal8Bit().constData()))
-    {
-        qWarning() << m_stil->getErrorStr();
-        utils::delPtr(m_stil);
-    }
-#endif
-
-    m_db = new SidDatabase();
-
-    QString slDbPath(QString("%1%2DOCUMENTS%2Songlengths").arg(hvscPath, QDir::separator()));
-    qDebug() << "SL DB path:" << slDbPath;
-    if (m_db->open(QString(slDbPath).append(".md5").toUtf8().constData()))
-    {
-        m_newSonglengthDB = true;
-    }
-    else if (!m_db->open(QString(slDbPath).append(".txt").toUtf8().constData()))
-    {
-        qWarning() << m_db->error();
-        utils::delPtr(m_db);
-    }
-}
-
 void sidBackend::loadWDS(const QString& musFileName, const char* ext)
 {
     QString wdsFileName(musFileName);
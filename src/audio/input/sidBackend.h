@@ -24,7 +24,6 @@
 #endif
 
 #include <sidplayfp/sidplayfp.h>
-#include <sidplayfp/SidDatabase.h>
 #include <sidplayfp/SidTune.h>
 #include <sidplayfp/SidConfig.h>
 #include <sidplayfp/SidTuneInfo.h>
@@ -33,12 +32,10 @@
 #include "inputConfig.h"
 #include "sidlib_features.h"
 
-#ifdef HAVE_STILVIEW
-#  include <stilview/stil.h>
-#endif
-
+#include <memory>
 #include <vector>
 
+class songLengthDb;
 
 /*****************************************************************/
 
@@ -168,15 +165,12 @@ private:
 
     SidTune *m_tune;
 
-#ifdef HAVE_STILVIEW
-    STIL *m_stil;
-#endif
-
-    SidDatabase *m_db;
-    bool m_newSonglengthDB;
+    std::shared_ptr<const songLengthDb> m_db;
 
     sidConfig m_config;
 
+    unsigned int m_samplerate;
+
 #ifdef FEAT_NEW_PLAY_API
     std::vector<short> m_rem_buffer;
     std::vector<short> m_mix_buffer;
@@ -191,10 +185,6 @@ private:
 
     bool loadTune(int num);
 
-    void openHvsc(const QString& hvscPath);
-
-    const unsigned char* loadRom(const QString& romPath);
-
     void getInfo(const SidTuneInfo* tuneInfo) noexcept;
 
     void loadWDS(const QString& musFileName, const char* ext);
@@ -224,7 +214,10 @@ public:
     bool subtune(unsigned int i) override;
 
     /// Get samplerate
-    unsigned int samplerate() const override { return m_config.samplerate(); }
+    unsigned int samplerate() const override { return m_samplerate; }
+
+    /// Render at the given samplerate
+    bool setSamplerate(unsigned int rate) override;
 
     /// Get channels
     unsigned int channels() const override { return m_config.channels(); }
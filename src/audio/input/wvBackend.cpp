@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2007-2021 Leandro Nini
+ *  Copyright (C) 2007-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -168,6 +168,15 @@ wvBackend::wvBackend(const QString& fileName) :
             getApeTag("Comment", metaData::COMMENT);
             getApeTag("Genre", metaData::GENRE);
 
+            for (const char* tag: { "replaygain_track_gain", "replaygain_track_peak",
+                    "replaygain_album_gain", "replaygain_album_peak" })
+            {
+                char tmp[64];
+                int size = WavpackGetTagItem(m_wvContext, tag, tmp, sizeof(tmp));
+                if (size > 0)
+                    m_metaData.addReplayGain(tag, QString::fromUtf8(tmp, size));
+            }
+
             int size = WavpackGetBinaryTagItem(m_wvContext, "Cover Art", nullptr, 0);
             if (size)
             {
@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2007-2025 Leandro Nini
+ *  Copyright (C) 2007-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -61,8 +61,13 @@
 #  include "input/mpcBackend.h"
 #endif
 
-#include <QRegularExpression>
 #include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+
+#include <cstring>
+#include <memory>
 
 class nullInput : public input
 {
@@ -94,6 +99,14 @@ void iFactory::regBackend()
     temp.factory = &backend::factory;
     temp.cFactory = &backend::cFactory;
     m_inputs.append(temp);
+
+    const int idx = m_inputs.size() - 1;
+    for (const QString& ext: temp.supportedExt())
+    {
+        QVector<int>& backends = m_extMap[ext.toLower()];
+        if (!backends.contains(idx))
+            backends.append(idx);
+    }
 }
 
 iFactory::iFactory()
@@ -154,19 +167,10 @@ iFactory::iFactory()
 #endif
 }
 
-bool supports(const QStringList& ext, const QString& fileName)
-{
-    QString extPattern = ext.join("|");
-    extPattern.prepend(".*\\.(").append(")");
-
-    QRegularExpression rx(QRegularExpression::anchoredPattern(extPattern), QRegularExpression::CaseInsensitiveOption);
-    return rx.match(fileName).hasMatch();
-}
-
 QStringList iFactory::getExtensions() const
 {
     QStringList extensions;
-    for (inputs_t i: m_inputs)
+    for (const inputs_t& i: m_inputs)
     {
         extensions.append(i.supportedExt());
     }
@@ -179,23 +183,159 @@ input* iFactory::get()
     return new nullInput();
 }
 
-input* iFactory::get(const QString& fileName)
+namespace
+{
+struct signature_t
+{
+    int offset;
+    const char* magic;
+    int len;
+    const char* backends[2];
+};
+
+#define SIG(offset, magic, b1, b2) { offset, magic, sizeof(magic)-1, { b1, b2 } }
+
+// Backends are referenced by name as they may not be available
+const signature_t signatures[] =
 {
-    for (inputs_t i: m_inputs)
+    SIG(0,    "PSID",                  "Sidplayfp",  nullptr),
+    SIG(0,    "RSID",                  "Sidplayfp",  nullptr),
+    SIG(0,    "ID3",                   "Mpg123",     "Ffmpeg"),
+    SIG(0,    "fLaC",                  "Sndfile",    "Ffmpeg"),
+    SIG(0,    "wvpk",                  "Wavpack",    "Ffmpeg"),
+    SIG(0,    "MPCK",                  "Musepack",   "Ffmpeg"),
+    SIG(0,    "MP+",                   "Musepack",   "Ffmpeg"),
+    SIG(0,    "RIFF",                  "Sndfile",    "Ffmpeg"),
+    SIG(0,    "FORM",                  "Sndfile",    "Ffmpeg"),
+    SIG(0,    "MThd",                  "ADL",        nullptr),
+    SIG(0,    "HVL",                   "Hively",     nullptr),
+    SIG(0,    "THX",                   "Hively",     nullptr),
+    SIG(0,    "IMPM",                  "Openmpt",    nullptr),
+    SIG(0,    "Extended Module: ",     "Openmpt",    nullptr),
+    SIG(44,   "SCRM",                  "Openmpt",    nullptr),
+    SIG(1080, "M.K.",                  "Openmpt",    nullptr),
+    SIG(0,    "NESM\x1a",              "Gme",        nullptr),
+    SIG(0,    "NSFE",                  "Gme",        nullptr),
+    SIG(0,    "GBS",                   "Gme",        nullptr),
+    SIG(0,    "Vgm ",                  "Gme",        nullptr),
+    SIG(0,    "SNES-SPC700",           "Gme",        nullptr),
+    SIG(0,    "ZXAYEMUL",              "Gme",        nullptr),
+    // Ogg streams are told apart by the first packet
+    SIG(28,   "\x01vorbis",            "Ogg-Vorbis", "Ffmpeg"),
+    SIG(28,   "OpusHead",              "Opus",       "Ffmpeg"),
+    SIG(0,    "OggS",                  "Ffmpeg",     nullptr),
+};
+
+// Largest offset+length in the table
+constexpr int HEADER_SIZE = 1084;
+}
+
+QVector<int> iFactory::sniff(const QString& fileName) const
+{
+    QVector<int> res;
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return res;
+
+    const QByteArray header = file.read(HEADER_SIZE);
+
+    QStringList names;
+    for (const signature_t& sig: signatures)
     {
-        if (supports(i.supportedExt(), fileName))
+        if ((header.size() >= sig.offset + sig.len)
+            && (std::memcmp(header.constData() + sig.offset, sig.magic, sig.len) == 0))
         {
-            qInfo() << "Trying input backend" << i.name;
-            try
+            // Ogg first packet signatures are only valid within an Ogg page
+            if ((sig.offset == 28) && !header.startsWith("OggS"))
+                continue;
+
+            for (const char* name: sig.backends)
             {
-                std::unique_ptr<input> ib(i.factory(fileName));
-                return ib.release();
+                if (name != nullptr)
+                    names.append(name);
             }
-            catch (input::loadError const &e)
+            break;
+        }
+    }
+
+    // MPEG audio frame sync without ID3 tag
+    if (names.isEmpty() && (header.size() >= 2)
+        && (static_cast<uchar>(header[0]) == 0xff) && ((static_cast<uchar>(header[1]) & 0xe6) > 0xe0))
+    {
+        names << "Mpg123";
+    }
+
+    for (const QString& name: names)
+    {
+        for (int i=0; i<m_inputs.size(); i++)
+        {
+            if (name == m_inputs[i].name)
+                res.append(i);
+        }
+    }
+    return res;
+}
+
+QVector<int> iFactory::candidates(const QString& fileName, const QString& ext)
+{
+    QVector<int> res = sniff(fileName);
+
+    const QVector<int> backends = m_extMap.value(ext);
+
+    int last = -1;
+    {
+        QMutexLocker locker(&m_lastMutex);
+        last = m_lastBackend.value(ext, -1);
+    }
+    if ((last >= 0) && !res.contains(last))
+        res.append(last);
+
+    for (int i: backends)
+    {
+        if (!res.contains(i))
+            res.append(i);
+    }
+    return res;
+}
+
+input* iFactory::get(const QString& fileName)
+{
+    const QString ext = QFileInfo(fileName).suffix().toLower();
+
+    for (int idx: candidates(fileName, ext))
+    {
+        const inputs_t& i = m_inputs[idx];
+        qInfo() << "Trying input backend" << i.name;
+        try
+        {
+            std::unique_ptr<input> ib(i.factory(fileName));
+
+            if (m_extMap.contains(ext))
             {
-                qWarning() << e.message();
+                QMutexLocker locker(&m_lastMutex);
+                m_lastBackend.insert(ext, idx);
             }
+            return ib.release();
         }
+        catch (input::loadError const &e)
+        {
+            qWarning() << e.message();
+        }
+    }
+
+    return nullptr;
+}
+
+input* iFactory::get(const int i, const QString& fileName)
+{
+    try
+    {
+        return m_inputs[i].factory(fileName);
+    }
+    catch (input::loadError const &e)
+    {
+        qWarning() << e.message();
     }
 
     return nullptr;
@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2007-2021 Leandro Nini
+ *  Copyright (C) 2007-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -19,7 +19,10 @@
 #ifndef FACTORY_H
 #define FACTORY_H
 
+#include <QHash>
 #include <QList>
+#include <QMutex>
+#include <QVector>
 
 #define IFACTORY iFactory::instance()
 
@@ -50,6 +53,20 @@ private:
 
     QList<inputs_t> m_inputs;
 
+    // lowercase extension -> backend indexes
+    QHash<QString, QVector<int>> m_extMap;
+
+    // extension -> last backend that loaded it
+    QHash<QString, int> m_lastBackend;
+    QMutex m_lastMutex;
+
+private:
+    /// Guess backends from file content
+    QVector<int> sniff(const QString& fileName) const;
+
+    /// Backends to try, in order
+    QVector<int> candidates(const QString& fileName, const QString& ext);
+
 protected:
     iFactory();
     ~iFactory() = default;
@@ -67,12 +84,18 @@ public:
     /// Get supported extensions
     QStringList getExtensions() const;
 
+    /// Get extensions supported by backend
+    QStringList getExtensions(const int i) const { return m_inputs[i].supportedExt(); }
+
     /// Instantiate empty backend
     input* get();
 
     /// Instantiate backend
     input* get(const QString& filename);
 
+    /// Instantiate the given backend, null if it cannot load the file
+    input* get(const int i, const QString& filename);
+
     /// Instantiate backend config
     inputConfig* getConfig(const int i);
 };
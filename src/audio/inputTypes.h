@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2009-2021 Leandro Nini
+ *  Copyright (C) 2009-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -32,6 +32,29 @@ enum class sample_t
     SAMPLE_FIXED  ///< FIXED - 32 bit fixed point
 };
 
+/**
+ * Resampler quality presets
+ */
+enum class resampler_t
+{
+    Fast,
+    Medium,
+    Best
+};
+
+/// Number of equalizer bands
+constexpr int EQ_BANDS = 8;
+
+/**
+ * Parametric equalizer band
+ */
+struct eqBand_t
+{
+    float freq; ///< center or corner frequency in Hz
+    float gain; ///< gain in dB
+    float q;    ///< quality factor
+};
+
 struct audioFormat_t
 {
     unsigned int sampleRate;
@@ -0,0 +1,267 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "libraryScanner.h"
+
+#include "inputFactory.h"
+#include "metaDataStore.h"
+#include "input/input.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QThread>
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+// Files checked by a single task
+constexpr int BATCH_SIZE = 64;
+
+// Progress report interval in milliseconds
+constexpr int PROGRESS_INTERVAL = 500;
+
+// Wait for further changes before rescanning a directory, in milliseconds
+constexpr int CHANGE_DELAY = 1000;
+
+libraryScanner::libraryScanner(QObject* parent) :
+    QObject(parent),
+    // leave cores for playback
+    m_pool(std::max(1, std::min(QThread::idealThreadCount()/2, 4))),
+    m_total(0),
+    m_done(0),
+    m_indexed(0),
+    m_generation(0),
+    m_running(false)
+{
+    for (const QString& ext: IFACTORY->getExtensions())
+    {
+        m_nameFilters.append(QString("*.%1").arg(ext));
+        m_extensions.insert(ext.toLower());
+    }
+
+    m_progressTimer.setInterval(PROGRESS_INTERVAL);
+    connect(&m_progressTimer, &QTimer::timeout, this, &libraryScanner::onProgress);
+
+    m_changeTimer.setSingleShot(true);
+    m_changeTimer.setInterval(CHANGE_DELAY);
+    connect(&m_changeTimer, &QTimer::timeout, this, &libraryScanner::onDirsChanged);
+
+    connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this, &libraryScanner::onDirectoryChanged);
+}
+
+libraryScanner::~libraryScanner()
+{
+    m_pool.stop();
+}
+
+void libraryScanner::start()
+{
+    // rescans join the running scan, a cancelled one is replaced
+    if (m_running && !m_pool.isCancelled(m_generation))
+        return;
+
+    m_running = true;
+    m_generation = m_pool.generation();
+    m_total = 0;
+    m_done = 0;
+    m_indexed = 0;
+    m_elapsed.start();
+    m_progressTimer.start();
+}
+
+void libraryScanner::scan(const QStringList& dirs)
+{
+    start();
+
+    const unsigned int generation = m_generation;
+    for (const QString& dir: dirs)
+    {
+        qInfo() << "Scanning" << dir;
+        m_pool.submit(generation, [this, dir, generation]() { walk(dir, generation); });
+    }
+}
+
+void libraryScanner::cancel()
+{
+    qDebug() << "Cancelling library scan";
+    // queued tasks return immediately
+    m_pool.cancel();
+
+    const QStringList dirs = m_watcher.directories();
+    if (!dirs.isEmpty())
+        m_watcher.removePaths(dirs);
+    m_changedDirs.clear();
+    m_changeTimer.stop();
+}
+
+void libraryScanner::walk(const QString& dir, unsigned int generation)
+{
+    QStringList dirs(dir);
+    QStringList files;
+    // every song found, to drop the store entries of the others
+    QSet<QString> found;
+
+    QDirIterator it(dir, QDir::Dirs|QDir::Files|QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (it.hasNext() && !m_pool.isCancelled(generation))
+    {
+        const QString path = it.next();
+        const QFileInfo info = it.fileInfo();
+        if (info.isDir())
+        {
+            dirs.append(path);
+        }
+        else if (m_extensions.contains(info.suffix().toLower()))
+        {
+            files.append(path);
+            found.insert(path);
+            if (files.size() == BATCH_SIZE)
+            {
+                queueFiles(files, generation);
+                files.clear();
+            }
+        }
+    }
+
+    queueFiles(files, generation);
+
+    purge(dir, found, true, generation);
+
+    // watcher lives in the main thread
+    QMetaObject::invokeMethod(this, [this, dirs, generation]() { watch(dirs, generation); }, Qt::QueuedConnection);
+}
+
+void libraryScanner::purge(const QString& dir, const QSet<QString>& files, bool recursive, unsigned int generation)
+{
+    // a partial walk doesn't tell which files are gone
+    if (m_pool.isCancelled(generation))
+        return;
+
+    MDSTORE->purge(dir, files, recursive);
+}
+
+void libraryScanner::queueFiles(const QStringList& files, unsigned int generation)
+{
+    if (files.isEmpty() || m_pool.isCancelled(generation))
+        return;
+
+    m_total += files.size();
+    m_pool.submit(generation, [this, files, generation]() { index(files, generation); });
+}
+
+void libraryScanner::index(const QStringList& files, unsigned int generation)
+{
+    for (const QString& file: files)
+    {
+        if (m_pool.isCancelled(generation))
+            return;
+
+        songInfo_t info;
+        if (!MDSTORE->lookup(file, info))
+        {
+            std::unique_ptr<input> song(IFACTORY->get(file));
+            if (song.get() != nullptr)
+            {
+                MDSTORE->store(song.get());
+                m_indexed++;
+            }
+        }
+        m_done++;
+    }
+}
+
+void libraryScanner::watch(const QStringList& dirs, unsigned int generation)
+{
+    if (m_pool.isCancelled(generation))
+        return;
+
+    const QStringList failed = m_watcher.addPaths(dirs);
+    if (!failed.isEmpty())
+        qWarning() << "Cannot watch" << failed.size() << "directories";
+}
+
+void libraryScanner::onDirectoryChanged(const QString& path)
+{
+    m_changedDirs.insert(path);
+    m_changeTimer.start();
+}
+
+void libraryScanner::onDirsChanged()
+{
+    start();
+
+    const unsigned int generation = m_generation;
+    const QStringList watched = m_watcher.directories();
+
+    for (const QString& path: std::as_const(m_changedDirs))
+    {
+        qDebug() << "Rescanning" << path;
+
+        const QDir dir(path);
+        if (!dir.exists())
+        {
+            // deleted or moved away
+            m_pool.submit(generation, [this, path, generation]() { purge(path, QSet<QString>(), true, generation); });
+            continue;
+        }
+
+        // new subdirectories are scanned recursively
+        for (const QString& subDir: dir.entryList(QDir::Dirs|QDir::NoDotAndDotDot))
+        {
+            const QString subPath = dir.filePath(subDir);
+            if (!watched.contains(subPath))
+                m_pool.submit(generation, [this, subPath, generation]() { walk(subPath, generation); });
+        }
+
+        // unchanged files are skipped by the store lookup
+        QStringList files;
+        for (const QString& file: dir.entryList(m_nameFilters, QDir::Files))
+            files.append(dir.filePath(file));
+        const QSet<QString> found(files.cbegin(), files.cend());
+        m_pool.submit(generation, [this, path, found, generation]() { purge(path, found, false, generation); });
+        queueFiles(files, generation);
+    }
+    m_changedDirs.clear();
+}
+
+void libraryScanner::onProgress()
+{
+    const qint64 elapsed = m_elapsed.elapsed();
+    const int done = m_done;
+    const double filesPerSec = elapsed ? (done * 1000.) / elapsed : 0.;
+
+    // stale tasks are waited for too, they return early
+    if (m_pool.pending() > 0)
+    {
+        emit progress(done, m_total, filesPerSec);
+        return;
+    }
+
+    m_progressTimer.stop();
+    m_running = false;
+
+    qInfo() << "Library scan" << (m_pool.isCancelled(m_generation) ? "cancelled" : "completed") << "-"
+            << done << "files," << m_indexed.load() << "indexed in" << elapsed << "ms"
+            << "(" << filesPerSec << "files/s)";
+
+    MDSTORE->save();
+
+    emit finished(done, m_indexed, elapsed);
+}
@@ -0,0 +1,98 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef LIBRARYSCANNER_H
+#define LIBRARYSCANNER_H
+
+#include "scanPool.h"
+
+#include <QElapsedTimer>
+#include <QFileSystemWatcher>
+#include <QObject>
+#include <QSet>
+#include <QStringList>
+#include <QTimer>
+
+#include <atomic>
+
+/**
+ * Background music library indexer
+ *
+ * Walks the given directories on a small thread pool with low priority,
+ * feeding the metadata store with songs missing from it.
+ * Scanned directories are then watched and rescanned on change.
+ */
+class libraryScanner : public QObject
+{
+    Q_OBJECT
+
+private:
+    scanPool m_pool;
+    QFileSystemWatcher m_watcher;
+    QTimer m_progressTimer;
+    QTimer m_changeTimer;
+    QElapsedTimer m_elapsed;
+
+    QStringList m_nameFilters;
+    QSet<QString> m_extensions;
+    QSet<QString> m_changedDirs;
+
+    std::atomic<int> m_total;
+    std::atomic<int> m_done;
+    std::atomic<int> m_indexed;
+
+    unsigned int m_generation;
+    bool m_running;
+
+private:
+    libraryScanner(const libraryScanner&) = delete;
+    libraryScanner& operator=(const libraryScanner&) = delete;
+
+    void start();
+    void walk(const QString& dir, unsigned int generation);
+    void purge(const QString& dir, const QSet<QString>& files, bool recursive, unsigned int generation);
+    void queueFiles(const QStringList& files, unsigned int generation);
+    void index(const QStringList& files, unsigned int generation);
+    void watch(const QStringList& dirs, unsigned int generation);
+
+    void onDirectoryChanged(const QString& path);
+    void onDirsChanged();
+    void onProgress();
+
+signals:
+    /// Scan progress
+    void progress(int done, int total, double filesPerSec);
+
+    /// Scan completed or cancelled
+    void finished(int files, int indexed, qint64 ms);
+
+public:
+    libraryScanner(QObject* parent = nullptr);
+    ~libraryScanner() override;
+
+    /// Scan directories recursively and watch them
+    void scan(const QStringList& dirs);
+
+    /// Stop scanning and watching
+    void cancel();
+
+    /// Scan in progress
+    bool isRunning() const { return m_running; }
+};
+
+#endif
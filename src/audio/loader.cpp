@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2021 Leandro Nini
+ *  Copyright (C) 2021-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -19,14 +19,153 @@
 #include "loader.h"
 
 #include "inputFactory.h"
+#include "metaDataStore.h"
 #include "settings.h"
 #include "input/input.h"
 
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+
+#include <algorithm>
+#include <utility>
+
+loader::loader() :
+    QThread(),
+    m_loadPending(false),
+    m_preloadPending(false),
+    m_quit(false),
+    m_loadGeneration(0),
+    m_preloadGeneration(0),
+    m_openLatency(0)
+{
+    start();
+}
+
+loader::~loader()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_quit = true;
+        m_wakeUp.wakeOne();
+    }
+    wait();
+}
+
+quint64 loader::load(const QString& fileName)
+{
+    QMutexLocker locker(&m_mutex);
+    m_loadName = fileName;
+    m_loadPending = true;
+    // the preload refers to the old song
+    m_preloadPending = false;
+    m_preloadGeneration++;
+    m_wakeUp.wakeOne();
+    return ++m_loadGeneration;
+}
+
+quint64 loader::preload(const QString& fileName)
+{
+    QMutexLocker locker(&m_mutex);
+    m_preloadName = fileName;
+    m_preloadPending = true;
+    m_wakeUp.wakeOne();
+    return ++m_preloadGeneration;
+}
+
+void loader::cancel()
+{
+    QMutexLocker locker(&m_mutex);
+    m_loadPending = false;
+    m_preloadPending = false;
+    m_loadGeneration++;
+    m_preloadGeneration++;
+}
+
+input* loader::open(const QString& fileName)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    input *i = IFACTORY->get(fileName);
+    if (i != nullptr)
+    {
+        if (SETTINGS->subtunes())
+            i->subtune(1);
+
+        MDSTORE->store(i);
+
+        // moving average, the first measure is taken as is
+        const unsigned int elapsed = timer.elapsed();
+        const QString backend = i->getMetaData()->getBackendName();
+        auto it = m_latencies.find(backend);
+        if (it == m_latencies.end())
+            it = m_latencies.insert(backend, elapsed);
+        else
+            *it = (*it * 3 + elapsed) / 4;
+
+        unsigned int latency = 0;
+        for (unsigned int l: std::as_const(m_latencies))
+            latency = std::max(latency, l);
+        m_openLatency = latency;
+    }
+    return i;
+}
+
 void loader::run()
 {
-    input *i = IFACTORY->get(m_fileName);
-    if (SETTINGS->subtunes() && (i != nullptr))
-        i->subtune(1);
+    for (;;)
+    {
+        QString fileName;
+        quint64 generation;
+        bool isPreload;
+
+        {
+            QMutexLocker locker(&m_mutex);
+            while (!m_quit && !m_loadPending && !m_preloadPending)
+                m_wakeUp.wait(&m_mutex);
+
+            if (m_quit)
+                return;
+
+            isPreload = !m_loadPending;
+            if (isPreload)
+            {
+                fileName = m_preloadName;
+                generation = m_preloadGeneration;
+                m_preloadPending = false;
+            }
+            else
+            {
+                fileName = m_loadName;
+                generation = m_loadGeneration;
+                m_loadPending = false;
+            }
+        }
+
+        setPriority(isPreload ? QThread::LowPriority : QThread::NormalPriority);
+
+        input *i = open(fileName);
+
+        // drop superseded results here instead of in the main thread
+        if (isPreload)
+        {
+            if (isCurrentPreload(generation))
+            {
+                emit preloaded(i, generation);
+                continue;
+            }
+        }
+        else
+        {
+            if (isCurrentLoad(generation))
+            {
+                emit loaded(i, generation);
+                continue;
+            }
+        }
 
-    emit loaded(i);
+        qDebug() << "Discarding superseded load of" << fileName;
+        delete i;
+    }
 }
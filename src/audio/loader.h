@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2021 Leandro Nini
+ *  Copyright (C) 2021-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -19,28 +19,77 @@
 #ifndef LOADER_H
 #define LOADER_H
 
+#include <QHash>
+#include <QMutex>
 #include <QThread>
+#include <QWaitCondition>
+
+#include <atomic>
 
 class input;
 
+/**
+ * Song loading thread
+ *
+ * Only the latest load and preload requests are kept,
+ * older ones are superseded before they start.
+ * Loads take precedence over preloads.
+ */
 class loader : public QThread
 {
     Q_OBJECT
 
 private:
-    const QString m_fileName;
+    QMutex m_mutex;
+    QWaitCondition m_wakeUp;
+
+    QString m_loadName;
+    QString m_preloadName;
+    bool m_loadPending;
+    bool m_preloadPending;
+    bool m_quit;
+
+    std::atomic<quint64> m_loadGeneration;
+    std::atomic<quint64> m_preloadGeneration;
+
+    /// Smoothed open time per backend, used by the loading thread only
+    QHash<QString, unsigned int> m_latencies;
+    std::atomic<unsigned int> m_openLatency;
+
+private:
+    loader(const loader&) = delete;
+    loader& operator=(const loader&) = delete;
+
+    input* open(const QString& fileName);
 
 protected:
     void run() override;
 
 signals:
-    void loaded(input* res);
+    void loaded(input* res, quint64 generation);
+    void preloaded(input* res, quint64 generation);
 
 public:
-    loader(QString name) :
-        QThread(),
-        m_fileName(name)
-   {}
+    loader();
+    ~loader() override;
+
+    /// Request a song load, returns the request generation
+    quint64 load(const QString& fileName);
+
+    /// Request a song preload, returns the request generation
+    quint64 preload(const QString& fileName);
+
+    /// Drop pending and running requests
+    void cancel();
+
+    /// Check if the load result is still wanted
+    bool isCurrentLoad(quint64 generation) const { return generation == m_loadGeneration; }
+
+    /// Check if the preload result is still wanted
+    bool isCurrentPreload(quint64 generation) const { return generation == m_preloadGeneration; }
+
+    /// Time to open a song with the slowest backend seen, in milliseconds
+    unsigned int openLatency() const { return m_openLatency; }
 };
 
 #endif
@@ -0,0 +1,237 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "loudnessScanner.h"
+
+#include "inputFactory.h"
+#include "loudnessStore.h"
+#include "converter/converterFactory.h"
+#include "dsp/loudnessMeter.h"
+#include "input/input.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QMap>
+#include <QThread>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Frames decoded at once
+constexpr size_t CHUNK_FRAMES = 4096;
+
+// Analyzed length of songs without a known duration, in milliseconds
+constexpr unsigned int DEFAULT_LENGTH = 180000;
+
+// Progress report interval in milliseconds
+constexpr int PROGRESS_INTERVAL = 500;
+
+loudnessScanner::loudnessScanner(QObject* parent) :
+    QObject(parent),
+    // decoding is CPU bound and files are independent, leave a core for playback
+    m_pool(std::max(1, QThread::idealThreadCount()-1)),
+    m_total(0),
+    m_done(0),
+    m_analyzed(0),
+    m_audioMs(0),
+    m_generation(0),
+    m_running(false)
+{
+    for (const QString& ext: IFACTORY->getExtensions())
+        m_nameFilters.append(QString("*.%1").arg(ext));
+
+    m_progressTimer.setInterval(PROGRESS_INTERVAL);
+    connect(&m_progressTimer, &QTimer::timeout, this, &loudnessScanner::onProgress);
+}
+
+loudnessScanner::~loudnessScanner()
+{
+    m_pool.stop();
+}
+
+void loudnessScanner::scan(const QStringList& dirs)
+{
+    // a cancelled analysis is replaced
+    if (!m_running || m_pool.isCancelled(m_generation))
+    {
+        m_running = true;
+        m_generation = m_pool.generation();
+        m_total = 0;
+        m_done = 0;
+        m_analyzed = 0;
+        m_audioMs = 0;
+        m_elapsed.start();
+        m_progressTimer.start();
+    }
+
+    const unsigned int generation = m_generation;
+    for (const QString& dir: dirs)
+    {
+        qInfo() << "Analyzing loudness in" << dir;
+        m_pool.submit(generation, [this, dir, generation]() { walk(dir, generation); });
+    }
+}
+
+void loudnessScanner::cancel()
+{
+    qDebug() << "Cancelling loudness analysis";
+    // queued tasks return immediately
+    m_pool.cancel();
+}
+
+void loudnessScanner::walk(const QString& dir, unsigned int generation)
+{
+    // files are grouped by directory for the album values
+    QMap<QString, QStringList> dirs;
+
+    QDirIterator it(dir, m_nameFilters, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext() && !m_pool.isCancelled(generation))
+    {
+        const QString path = it.next();
+        dirs[it.fileInfo().path()].append(path);
+    }
+
+    for (const QStringList& files: std::as_const(dirs))
+        queueDir(files, generation);
+}
+
+void loudnessScanner::queueDir(const QStringList& files, unsigned int generation)
+{
+    if (m_pool.isCancelled(generation))
+        return;
+
+    m_total += files.size();
+
+    auto remaining = std::make_shared<std::atomic<int>>(files.size());
+    for (const QString& file: files)
+    {
+        m_pool.submit(generation,
+            [this, file, files, remaining, generation]()
+            {
+                analyze(file, generation);
+                if (m_pool.isCancelled(generation))
+                    return;
+
+                m_done++;
+
+                if (--(*remaining) == 0)
+                    LDSTORE->updateAlbums(files);
+            }
+        );
+    }
+}
+
+void loudnessScanner::analyze(const QString& file, unsigned int generation)
+{
+    if (LDSTORE->contains(file))
+        return;
+
+    std::unique_ptr<input> song(IFACTORY->get(file));
+    if (song.get() == nullptr)
+        return;
+
+    // tagged files are already covered, an empty
+    // measurement avoids reopening them on every scan
+    const metaData* data = song->getMetaData();
+    if (!std::isnan(data->getReplayGain().trackGain))
+    {
+        LDSTORE->store(file, data->getInfo(metaData::ALBUM), loudness_t());
+        return;
+    }
+
+    song->setFloat(true);
+
+    const audioFormat_t songFormat { song->samplerate(), song->channels(), song->precision() };
+    const audioFormat_t floatFormat { songFormat.sampleRate, songFormat.channels, sample_t::SAMPLE_FLOAT };
+    std::unique_ptr<converter> toFloat(CFACTORY->get(songFormat, floatFormat, song->fract(), resampler_t::Fast, false));
+    if ((toFloat.get() == nullptr) && (songFormat.sampleType != sample_t::SAMPLE_FLOAT))
+    {
+        qDebug() << "Cannot analyze" << file;
+        return;
+    }
+
+    // songs without a known end, like most emulated ones, are cut
+    unsigned int length = song->songDuration();
+    if (length == 0)
+        length = song->maxPlayTime() ? song->maxPlayTime() : DEFAULT_LENGTH;
+    const quint64 maxFrames = static_cast<quint64>(length) * songFormat.sampleRate / 1000;
+
+    loudnessMeter meter(songFormat.sampleRate, songFormat.channels);
+
+    std::vector<float> buffer(CHUNK_FRAMES * songFormat.channels);
+    const size_t frameSize = songFormat.channels * sizeof(float);
+    const size_t bufSize = buffer.size() * sizeof(float);
+    char* const out = reinterpret_cast<char*>(buffer.data());
+
+    quint64 frames = 0;
+    while (frames < maxFrames)
+    {
+        if (m_pool.isCancelled(generation))
+            return;
+
+        size_t n;
+        if (toFloat.get() != nullptr)
+        {
+            const size_t size = song->fillBuffer(toFloat->buffer(), toFloat->bufSize(bufSize));
+            n = toFloat->convert(out, size);
+        }
+        else
+        {
+            n = song->fillBuffer(out, bufSize);
+        }
+
+        if (n == 0)
+            break;
+
+        meter.process(buffer.data(), n / frameSize);
+        frames += n / frameSize;
+    }
+
+    LDSTORE->store(file, data->getInfo(metaData::ALBUM), meter.result());
+    m_analyzed++;
+    m_audioMs += frames * 1000 / songFormat.sampleRate;
+}
+
+void loudnessScanner::onProgress()
+{
+    const qint64 elapsed = m_elapsed.elapsed();
+    const int done = m_done;
+    const double filesPerSec = elapsed ? (done * 1000.) / elapsed : 0.;
+
+    if (m_pool.pending() > 0)
+    {
+        emit progress(done, m_total, filesPerSec);
+        return;
+    }
+
+    m_progressTimer.stop();
+    m_running = false;
+
+    qInfo() << "Loudness analysis" << (m_pool.isCancelled(m_generation) ? "cancelled" : "completed") << "-"
+            << done << "files," << m_analyzed.load() << "analyzed in" << elapsed << "ms"
+            << "(" << (elapsed ? m_audioMs.load() / static_cast<double>(elapsed) : 0.) << "x realtime)";
+
+    LDSTORE->save();
+
+    emit finished(done, m_analyzed, elapsed);
+}
@@ -0,0 +1,89 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef LOUDNESSSCANNER_H
+#define LOUDNESSSCANNER_H
+
+#include "scanPool.h"
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QStringList>
+#include <QTimer>
+
+#include <atomic>
+
+/**
+ * Background loudness analyzer
+ *
+ * Decodes the songs missing ReplayGain tags with one task per file
+ * on a thread pool, storing the EBU R128 measurements in the
+ * loudness store. Album values are computed once all the files
+ * of a directory are done.
+ */
+class loudnessScanner : public QObject
+{
+    Q_OBJECT
+
+private:
+    scanPool m_pool;
+    QTimer m_progressTimer;
+    QElapsedTimer m_elapsed;
+
+    QStringList m_nameFilters;
+
+    std::atomic<int> m_total;
+    std::atomic<int> m_done;
+    std::atomic<int> m_analyzed;
+    std::atomic<quint64> m_audioMs;
+
+    unsigned int m_generation;
+    bool m_running;
+
+private:
+    loudnessScanner(const loudnessScanner&) = delete;
+    loudnessScanner& operator=(const loudnessScanner&) = delete;
+
+    void walk(const QString& dir, unsigned int generation);
+    void queueDir(const QStringList& files, unsigned int generation);
+    void analyze(const QString& file, unsigned int generation);
+
+    void onProgress();
+
+signals:
+    /// Analysis progress
+    void progress(int done, int total, double filesPerSec);
+
+    /// Analysis completed or cancelled
+    void finished(int files, int analyzed, qint64 ms);
+
+public:
+    loudnessScanner(QObject* parent = nullptr);
+    ~loudnessScanner() override;
+
+    /// Analyze directories recursively
+    void scan(const QStringList& dirs);
+
+    /// Stop analyzing
+    void cancel();
+
+    /// Analysis in progress
+    bool isRunning() const { return m_running; }
+};
+
+#endif
@@ -0,0 +1,250 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "loudnessStore.h"
+
+#include "syspaths.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <cmath>
+
+#define CACHE_FILE "loudness.cache"
+
+constexpr quint32 MAGIC = 0x4d514c44; // MQLD
+constexpr quint32 VERSION = 1;
+
+// ReplayGain 2.0 reference level in LUFS
+constexpr float REFERENCE_LEVEL = -18.f;
+
+namespace
+{
+QDataStream& operator<<(QDataStream& out, const loudness_t& l)
+{
+    return out << l.integrated << l.range << l.peak << l.blocks;
+}
+
+QDataStream& operator>>(QDataStream& in, loudness_t& l)
+{
+    return in >> l.integrated >> l.range >> l.peak >> l.blocks;
+}
+}
+
+loudnessStore::loudnessStore() :
+    m_fileName(QString("%1/" CACHE_FILE).arg(syspaths::getStateDir())),
+    m_modified(false)
+{
+    load();
+}
+
+loudnessStore* loudnessStore::instance()
+{
+    static loudnessStore s;
+    return &s;
+}
+
+void loudnessStore::load()
+{
+    QFile file(m_fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    QDataStream in(&file);
+    in.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    quint32 magic, version;
+    in >> magic >> version;
+    if ((magic != MAGIC) || (version != VERSION))
+    {
+        qWarning() << "Invalid loudness cache, ignoring";
+        return;
+    }
+
+    quint32 count;
+    in >> count;
+    for (quint32 i=0; (i<count) && (in.status() == QDataStream::Ok); i++)
+    {
+        QString path;
+        track_t track;
+        in >> path >> track.size >> track.mtime >> track.album >> track.loudness;
+        m_tracks.insert(path, track);
+    }
+
+    in >> count;
+    for (quint32 i=0; (i<count) && (in.status() == QDataStream::Ok); i++)
+    {
+        QString key;
+        loudness_t loudness;
+        in >> key >> loudness;
+        m_albums.insert(key, loudness);
+    }
+
+    if (in.status() != QDataStream::Ok)
+    {
+        qWarning() << "Truncated loudness cache, ignoring";
+        m_tracks.clear();
+        m_albums.clear();
+        return;
+    }
+
+    qDebug() << "Loudness cache entries:" << m_tracks.size() << "tracks," << m_albums.size() << "albums";
+}
+
+QString loudnessStore::albumKey(const QString& path, const QString& album)
+{
+    return QString("%1\n%2").arg(QFileInfo(path).absolutePath(), album);
+}
+
+const loudnessStore::track_t* loudnessStore::find(const QString& path) const
+{
+    auto it = m_tracks.constFind(path);
+    if (it == m_tracks.constEnd())
+        return nullptr;
+
+    const QFileInfo fileInfo(path);
+    if ((it->size != fileInfo.size()) || (it->mtime != fileInfo.lastModified().toMSecsSinceEpoch()))
+        return nullptr;
+
+    return &(*it);
+}
+
+bool loudnessStore::contains(const QString& path)
+{
+    QMutexLocker locker(&m_mutex);
+    return find(path) != nullptr;
+}
+
+void loudnessStore::store(const QString& path, const QString& album, const loudness_t& loudness)
+{
+    const QFileInfo fileInfo(path);
+    if (!fileInfo.isFile())
+        return;
+
+    track_t track;
+    track.size = fileInfo.size();
+    track.mtime = fileInfo.lastModified().toMSecsSinceEpoch();
+    track.album = album;
+    track.loudness = loudness;
+
+    QMutexLocker locker(&m_mutex);
+    m_tracks.insert(path, track);
+    m_modified = true;
+}
+
+void loudnessStore::updateAlbums(const QStringList& paths)
+{
+    struct sum_t
+    {
+        double energy = 0.;
+        loudness_t loudness;
+    };
+
+    QMutexLocker locker(&m_mutex);
+
+    // the gating is done per track, the album loudness is approximated
+    // by the mean energy of the tracks weighted by their gated blocks
+    QHash<QString, sum_t> albums;
+    for (const QString& path: paths)
+    {
+        const track_t* track = find(path);
+        if ((track == nullptr) || std::isnan(track->loudness.integrated))
+            continue;
+
+        const loudness_t& l = track->loudness;
+        sum_t& sum = albums[albumKey(path, track->album)];
+        sum.energy += l.blocks * std::pow(10., l.integrated / 10.);
+        sum.loudness.blocks += l.blocks;
+        sum.loudness.range = std::max(sum.loudness.range, l.range);
+        sum.loudness.peak = std::max(sum.loudness.peak, l.peak);
+    }
+
+    for (auto it = albums.begin(); it != albums.end(); ++it)
+    {
+        loudness_t& loudness = it->loudness;
+        loudness.integrated = 10. * std::log10(it->energy / loudness.blocks);
+        m_albums.insert(it.key(), loudness);
+    }
+
+    if (!albums.isEmpty())
+        m_modified = true;
+}
+
+bool loudnessStore::lookup(const QString& path, replayGain_t& rg)
+{
+    QMutexLocker locker(&m_mutex);
+
+    const track_t* track = find(path);
+    if ((track == nullptr) || std::isnan(track->loudness.integrated))
+        return false;
+
+    rg.trackGain = REFERENCE_LEVEL - track->loudness.integrated;
+    rg.trackPeak = track->loudness.peak;
+
+    auto it = m_albums.constFind(albumKey(path, track->album));
+    if ((it != m_albums.constEnd()) && !std::isnan(it->integrated))
+    {
+        rg.albumGain = REFERENCE_LEVEL - it->integrated;
+        rg.albumPeak = it->peak;
+    }
+    return true;
+}
+
+void loudnessStore::save()
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (!m_modified)
+        return;
+
+    QSaveFile file(m_fileName);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qWarning() << "Cannot write loudness cache:" << file.errorString();
+        return;
+    }
+
+    QDataStream out(&file);
+    out.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    out << MAGIC << VERSION;
+
+    out << static_cast<quint32>(m_tracks.size());
+    for (auto it = m_tracks.constBegin(); it != m_tracks.constEnd(); ++it)
+        out << it.key() << it->size << it->mtime << it->album << it->loudness;
+
+    out << static_cast<quint32>(m_albums.size());
+    for (auto it = m_albums.constBegin(); it != m_albums.constEnd(); ++it)
+        out << it.key() << *it;
+
+    if (file.commit())
+    {
+        m_modified = false;
+        qDebug() << "Saved" << m_tracks.size() << "loudness cache entries";
+    }
+    else
+    {
+        qWarning() << "Cannot write loudness cache:" << file.errorString();
+    }
+}
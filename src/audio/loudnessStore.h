@@ -0,0 +1,92 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef LOUDNESSSTORE_H
+#define LOUDNESSSTORE_H
+
+#include "metaData.h"
+#include "dsp/loudnessMeter.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+
+#define LDSTORE loudnessStore::instance()
+
+/**
+ * Persistent cache of loudness measurements
+ *
+ * Tracks are keyed by path, size and modification time,
+ * albums by directory and album name.
+ * The whole cache is loaded in memory at startup.
+ */
+class loudnessStore
+{
+private:
+    struct track_t
+    {
+        qint64 size;
+        qint64 mtime;
+        QString album;
+        loudness_t loudness;
+    };
+
+private:
+    QMutex m_mutex;
+
+    QString m_fileName;
+
+    QHash<QString, track_t> m_tracks;
+    QHash<QString, loudness_t> m_albums;
+
+    bool m_modified;
+
+private:
+    loudnessStore();
+    loudnessStore(const loudnessStore&) = delete;
+    loudnessStore& operator=(const loudnessStore&) = delete;
+    ~loudnessStore() = default;
+
+    void load();
+
+    const track_t* find(const QString& path) const;
+
+    static QString albumKey(const QString& path, const QString& album);
+
+public:
+    /// Get singleton instance
+    static loudnessStore* instance();
+
+    /// Check if the file has an up to date entry, measured or not
+    bool contains(const QString& path);
+
+    /// Store the measurement of a file
+    void store(const QString& path, const QString& album, const loudness_t& loudness);
+
+    /// Combine the measurements of the given files into their albums
+    void updateAlbums(const QStringList& paths);
+
+    /// Get ReplayGain values from the measurements, false if missing
+    bool lookup(const QString& path, replayGain_t& rg);
+
+    /// Write to disk if modified
+    void save();
+};
+
+#endif
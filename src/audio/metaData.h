@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2010-2021 Leandro Nini
+ *  Copyright (C) 2010-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -22,6 +22,21 @@
 #include <QByteArray>
 #include <QString>
 
+#include <cmath>
+
+/**
+ * ReplayGain values, gains in dB relative to the
+ * ReplayGain reference, peaks as linear amplitude.
+ * Missing gains are NaN, missing peaks are zero.
+ */
+struct replayGain_t
+{
+    float trackGain = NAN;
+    float trackPeak = 0.f;
+    float albumGain = NAN;
+    float albumPeak = 0.f;
+};
+
 class metaData
 {
 public:
@@ -64,6 +79,7 @@ public:
     virtual QString getInfo(const char* info) const =0;
     virtual QByteArray* getImage() const =0;
     virtual QString getBackendName() const =0;
+    virtual const replayGain_t& getReplayGain() const =0;
 
 protected:
     ~metaData() = default;
@@ -0,0 +1,416 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "metaDataStore.h"
+
+#include "input/input.h"
+#include "syspaths.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QVector>
+
+#include <algorithm>
+#include <cstring>
+
+#define CACHE_FILE "metadata.cache"
+
+constexpr char MAGIC[4] = { 'M', 'Q', 'M', 'D' };
+constexpr quint32 VERSION = 1;
+
+/*
+ * File layout, native byte order:
+ *   header
+ *   entries, sorted by path hash
+ *   strings, each one a 32 bit length followed by UTF-8 data
+ */
+struct metaDataStore::header_t
+{
+    char magic[4];
+    quint32 version;
+    quint32 count;
+    quint32 stringsSize;
+};
+
+struct metaDataStore::entry_t
+{
+    quint64 pathHash;
+    qint64 size;
+    qint64 mtime;
+    quint32 path;
+    quint32 title;
+    quint32 artist;
+    quint32 album;
+    quint32 backend;
+    quint32 duration;
+    quint32 sampleRate;
+    quint16 channels;
+    quint16 subtunes;
+    quint32 coverHash;
+    quint32 reserved;
+};
+
+namespace
+{
+// 64 bit FNV-1a, must be stable across runs
+quint64 fnv1a(const char* data, int len)
+{
+    quint64 hash = 0xcbf29ce484222325ULL;
+    for (int i=0; i<len; i++)
+    {
+        hash ^= static_cast<uchar>(data[i]);
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+class stringPool
+{
+private:
+    QByteArray m_data;
+    QHash<QString, quint32> m_offsets;
+
+public:
+    quint32 add(const QString& str)
+    {
+        auto it = m_offsets.constFind(str);
+        if (it != m_offsets.constEnd())
+            return *it;
+
+        const quint32 offset = m_data.size();
+        const QByteArray utf8 = str.toUtf8();
+        const quint32 len = utf8.size();
+        m_data.append(reinterpret_cast<const char*>(&len), sizeof(len));
+        m_data.append(utf8);
+        m_offsets.insert(str, offset);
+        return offset;
+    }
+
+    const QByteArray& data() const { return m_data; }
+};
+}
+
+metaDataStore::metaDataStore() :
+    m_map(nullptr),
+    m_mapSize(0),
+    m_entries(nullptr),
+    m_count(0),
+    m_strings(nullptr),
+    m_stringsSize(0)
+{
+    m_file.setFileName(QString("%1/" CACHE_FILE).arg(syspaths::getStateDir()));
+    open();
+}
+
+metaDataStore::~metaDataStore()
+{
+    unmap();
+}
+
+metaDataStore* metaDataStore::instance()
+{
+    static metaDataStore s;
+    return &s;
+}
+
+void metaDataStore::open()
+{
+    static_assert(sizeof(entry_t) == 64, "Unexpected entry size");
+
+    if (!m_file.open(QIODevice::ReadOnly))
+        return;
+
+    const qint64 fileSize = m_file.size();
+    if (fileSize < static_cast<qint64>(sizeof(header_t)))
+    {
+        m_file.close();
+        return;
+    }
+
+    m_map = m_file.map(0, fileSize);
+    if (m_map == nullptr)
+    {
+        qWarning() << "Cannot map metadata cache:" << m_file.errorString();
+        m_file.close();
+        return;
+    }
+    m_mapSize = fileSize;
+
+    header_t header;
+    std::memcpy(&header, m_map, sizeof(header_t));
+    const qint64 expected = sizeof(header_t) + static_cast<qint64>(header.count) * sizeof(entry_t) + header.stringsSize;
+    if ((std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+        || (header.version != VERSION)
+        || (expected != fileSize))
+    {
+        qWarning() << "Invalid metadata cache, ignoring";
+        unmap();
+        return;
+    }
+
+    m_entries = reinterpret_cast<const entry_t*>(m_map + sizeof(header_t));
+    m_count = header.count;
+    m_strings = m_map + sizeof(header_t) + m_count * sizeof(entry_t);
+    m_stringsSize = header.stringsSize;
+
+    qDebug() << "Metadata cache entries:" << m_count;
+}
+
+void metaDataStore::unmap()
+{
+    if (m_map != nullptr)
+        m_file.unmap(const_cast<uchar*>(m_map));
+    m_file.close();
+
+    m_map = nullptr;
+    m_mapSize = 0;
+    m_entries = nullptr;
+    m_count = 0;
+    m_strings = nullptr;
+    m_stringsSize = 0;
+}
+
+quint64 metaDataStore::pathHash(const QString& path)
+{
+    const QByteArray utf8 = path.toUtf8();
+    return fnv1a(utf8.constData(), utf8.size());
+}
+
+QString metaDataStore::string(quint32 offset) const
+{
+    if ((static_cast<quint64>(offset) + sizeof(quint32)) > m_stringsSize)
+        return QString();
+
+    quint32 len;
+    std::memcpy(&len, m_strings + offset, sizeof(len));
+    if ((static_cast<quint64>(offset) + sizeof(quint32) + len) > m_stringsSize)
+        return QString();
+
+    return QString::fromUtf8(reinterpret_cast<const char*>(m_strings + offset + sizeof(quint32)), len);
+}
+
+const metaDataStore::entry_t* metaDataStore::find(const QString& path) const
+{
+    if (m_entries == nullptr)
+        return nullptr;
+
+    const quint64 hash = pathHash(path);
+    const entry_t* end = m_entries + m_count;
+    const entry_t* it = std::lower_bound(m_entries, end, hash,
+        [](const entry_t& e, quint64 h) { return e.pathHash < h; });
+
+    // handle hash collisions
+    for (; (it != end) && (it->pathHash == hash); ++it)
+    {
+        if (string(it->path) == path)
+            return it;
+    }
+    return nullptr;
+}
+
+bool metaDataStore::lookup(const QString& path, songInfo_t& info)
+{
+    const QFileInfo fileInfo(path);
+    if (!fileInfo.isFile())
+        return false;
+
+    const qint64 size = fileInfo.size();
+    const qint64 mtime = fileInfo.lastModified().toMSecsSinceEpoch();
+
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_added.constFind(path);
+    if (it != m_added.constEnd())
+    {
+        if ((it->size != size) || (it->mtime != mtime))
+            return false;
+        info = it->info;
+        return true;
+    }
+
+    const entry_t* entry = find(path);
+    if ((entry == nullptr) || (entry->size != size) || (entry->mtime != mtime))
+        return false;
+
+    info.title = string(entry->title);
+    info.artist = string(entry->artist);
+    info.album = string(entry->album);
+    info.backend = string(entry->backend);
+    info.duration = entry->duration;
+    info.sampleRate = entry->sampleRate;
+    info.channels = entry->channels;
+    info.subtunes = entry->subtunes;
+    info.coverHash = entry->coverHash;
+    return true;
+}
+
+void metaDataStore::store(const input* song)
+{
+    const QString path = song->songLoaded();
+    const QFileInfo fileInfo(path);
+    if (!fileInfo.isFile())
+        return;
+
+    const metaData* data = song->getMetaData();
+
+    record_t record;
+    record.size = fileInfo.size();
+    record.mtime = fileInfo.lastModified().toMSecsSinceEpoch();
+    record.info.title = data->getInfo(metaData::TITLE);
+    record.info.artist = data->getInfo(metaData::ARTIST);
+    record.info.album = data->getInfo(metaData::ALBUM);
+    record.info.backend = data->getBackendName();
+    record.info.duration = song->songDuration();
+    record.info.sampleRate = song->samplerate();
+    record.info.channels = song->channels();
+    record.info.subtunes = song->subtunes();
+
+    const QByteArray* image = data->getImage();
+    if ((image != nullptr) && !image->isEmpty())
+    {
+        const quint64 hash = fnv1a(image->constData(), image->size());
+        record.info.coverHash = static_cast<quint32>(hash ^ (hash >> 32)) | 1;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_added.insert(path, record);
+    m_removed.remove(path);
+}
+
+void metaDataStore::purge(const QString& dir, const QSet<QString>& keep, bool recursive)
+{
+    const QString prefix = dir.endsWith('/') ? dir : dir + '/';
+    const auto stale = [&prefix, &keep, recursive](const QString& path)
+    {
+        if (!path.startsWith(prefix) || keep.contains(path))
+            return false;
+        return recursive || (path.indexOf('/', prefix.size()) < 0);
+    };
+
+    QMutexLocker locker(&m_mutex);
+
+    for (quint32 i=0; i<m_count; i++)
+    {
+        const QString path = string(m_entries[i].path);
+        if (stale(path))
+            m_removed.insert(path);
+    }
+
+    for (auto it = m_added.begin(); it != m_added.end(); )
+    {
+        if (stale(it.key()))
+            it = m_added.erase(it);
+        else
+            ++it;
+    }
+
+    if (!m_removed.isEmpty())
+        qDebug() << "Stale metadata cache entries:" << m_removed.size();
+}
+
+void metaDataStore::save()
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_added.isEmpty() && m_removed.isEmpty())
+        return;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    stringPool strings;
+    QVector<entry_t> entries;
+    entries.reserve(m_count + m_added.size());
+
+    // keep existing entries not replaced by new ones
+    for (quint32 i=0; i<m_count; i++)
+    {
+        const entry_t& old = m_entries[i];
+        const QString path = string(old.path);
+        if (m_added.contains(path) || m_removed.contains(path))
+            continue;
+
+        entry_t e = old;
+        e.path = strings.add(path);
+        e.title = strings.add(string(old.title));
+        e.artist = strings.add(string(old.artist));
+        e.album = strings.add(string(old.album));
+        e.backend = strings.add(string(old.backend));
+        entries.append(e);
+    }
+
+    for (auto it = m_added.constBegin(); it != m_added.constEnd(); ++it)
+    {
+        const songInfo_t& info = it->info;
+
+        entry_t e;
+        e.pathHash = pathHash(it.key());
+        e.size = it->size;
+        e.mtime = it->mtime;
+        e.path = strings.add(it.key());
+        e.title = strings.add(info.title);
+        e.artist = strings.add(info.artist);
+        e.album = strings.add(info.album);
+        e.backend = strings.add(info.backend);
+        e.duration = info.duration;
+        e.sampleRate = info.sampleRate;
+        e.channels = info.channels;
+        e.subtunes = info.subtunes;
+        e.coverHash = info.coverHash;
+        e.reserved = 0;
+        entries.append(e);
+    }
+
+    std::sort(entries.begin(), entries.end(),
+        [](const entry_t& a, const entry_t& b) { return a.pathHash < b.pathHash; });
+
+    header_t header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.count = entries.size();
+    header.stringsSize = strings.data().size();
+
+    const QString fileName = m_file.fileName();
+
+    // the old file must be unmapped before being replaced
+    unmap();
+
+    QSaveFile file(fileName);
+    if (file.open(QIODevice::WriteOnly))
+    {
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(entries.constData()), entries.size() * sizeof(entry_t));
+        file.write(strings.data());
+        if (file.commit())
+        {
+            m_added.clear();
+            m_removed.clear();
+            qDebug() << "Saved" << header.count << "metadata cache entries in" << timer.elapsed() << "ms";
+        }
+        else
+        {
+            qWarning() << "Cannot write metadata cache:" << file.errorString();
+        }
+    }
+
+    open();
+}
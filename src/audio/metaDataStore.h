@@ -0,0 +1,113 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef METADATASTORE_H
+#define METADATASTORE_H
+
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+
+class input;
+
+/// Cached song info
+struct songInfo_t
+{
+    QString title;
+    QString artist;
+    QString album;
+    QString backend;
+    unsigned int duration = 0;      // milliseconds
+    unsigned int sampleRate = 0;
+    unsigned int channels = 0;
+    unsigned int subtunes = 0;
+    quint32 coverHash = 0;          // 0 if no cover art
+};
+
+#define MDSTORE metaDataStore::instance()
+
+/**
+ * Persistent song metadata cache
+ *
+ * Entries are keyed by path, size and modification time.
+ * The cache file is memory mapped and looked up in place,
+ * new entries are kept in memory until saved.
+ */
+class metaDataStore
+{
+private:
+    struct record_t
+    {
+        qint64 size;
+        qint64 mtime;
+        songInfo_t info;
+    };
+
+    struct header_t;
+    struct entry_t;
+
+private:
+    QMutex m_mutex;
+
+    QFile m_file;
+    const uchar* m_map;
+    qint64 m_mapSize;
+
+    const entry_t* m_entries;
+    quint32 m_count;
+    const uchar* m_strings;
+    quint32 m_stringsSize;
+
+    QHash<QString, record_t> m_added;
+    // entries of files no longer there, dropped on save
+    QSet<QString> m_removed;
+
+private:
+    metaDataStore();
+    metaDataStore(const metaDataStore&) = delete;
+    metaDataStore& operator=(const metaDataStore&) = delete;
+    ~metaDataStore();
+
+    void open();
+    void unmap();
+
+    QString string(quint32 offset) const;
+    const entry_t* find(const QString& path) const;
+
+    static quint64 pathHash(const QString& path);
+
+public:
+    /// Get singleton instance
+    static metaDataStore* instance();
+
+    /// Look up info for the given file, false if missing or stale
+    bool lookup(const QString& path, songInfo_t& info);
+
+    /// Store info from a loaded song
+    void store(const input* song);
+
+    /// Drop entries under dir, in its subdirectories too if recursive, whose file is not in keep
+    void purge(const QString& dir, const QSet<QString>& keep, bool recursive);
+
+    /// Write new entries to disk
+    void save();
+};
+
+#endif
@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2021 Leandro Nini
+ *  Copyright (C) 2021-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -36,24 +36,53 @@ private:
     QAudioSink *m_audioOutput;
 
 public slots:
-    void init(QAudioDevice audioDevice, QAudioFormat format)
+    void init(QAudioDevice audioDevice, QAudioFormat format, int bufferSize)
     {
         m_audioOutput = new QAudioSink(audioDevice, format, this);
+        if (bufferSize > 0)
+            m_audioOutput->setBufferSize(bufferSize);
         connect(m_audioOutput, SIGNAL(stateChanged(QAudio::State)), this, SLOT(onStateChange(QAudio::State)));
     }
     QAudio::Error error() const { return m_audioOutput->error(); }
     void suspend() { m_audioOutput->suspend(); }
     void resume() { m_audioOutput->resume(); }
-    void start(QIODevice *device) { m_audioOutput->start(device); }
+    void start(QIODevice *device)
+    {
+        // the device counts from the start of the sink
+        device->reset();
+        m_audioOutput->start(device);
+    }
     void stop() { m_audioOutput->stop(); }
+    void resize(QIODevice *device, int bufferSize)
+    {
+        // the buffer size is only applied when the sink starts
+        m_audioOutput->stop();
+        m_audioOutput->setBufferSize(bufferSize);
+        start(device);
+    }
+    void flush(QIODevice *device)
+    {
+        // drop what the sink has buffered, restart pulling if that stopped it
+        m_audioOutput->reset();
+        if (m_audioOutput->state() == QAudio::StoppedState)
+            start(device);
+        else
+            device->reset();
+    }
     qsizetype bufferSize() const { return m_audioOutput->bufferSize(); }
     void setVolume(qreal volume) { m_audioOutput->setVolume(volume); }
     qreal volume() const { return m_audioOutput->volume(); }
+    /// Bytes played since start, called from the audio thread only
+    qint64 processedBytes() const
+    {
+        const QAudioFormat format = m_audioOutput->format();
+        return ((m_audioOutput->processedUSecs() * format.sampleRate()) / 1000000) * format.bytesPerFrame();
+    }
 
-    void onStateChange(QAudio::State state) { emit stateChanged(state); }
+    void onStateChange(QAudio::State state) { emit stateChanged(state, m_audioOutput->error()); }
 
 signals:
-    void stateChanged(QAudio::State state);
+    void stateChanged(QAudio::State state, QAudio::Error error);
 
 public:
     AudioOutputWrapper() :
@@ -76,24 +105,53 @@ private:
     QAudioOutput *m_audioOutput;
 
 public slots:
-    void init(QAudioDeviceInfo audioDevice, QAudioFormat format)
+    void init(QAudioDeviceInfo audioDevice, QAudioFormat format, int bufferSize)
     {
         m_audioOutput = new QAudioOutput(audioDevice, format, this);
+        if (bufferSize > 0)
+            m_audioOutput->setBufferSize(bufferSize);
         connect(m_audioOutput, SIGNAL(stateChanged(QAudio::State)), this, SLOT(onStateChange(QAudio::State)));
     }
     QAudio::Error error() const { return m_audioOutput->error(); }
     void suspend() { m_audioOutput->suspend(); }
     void resume() { m_audioOutput->resume(); }
-    void start(QIODevice *device) { m_audioOutput->start(device); }
+    void start(QIODevice *device)
+    {
+        // the device counts from the start of the sink
+        device->reset();
+        m_audioOutput->start(device);
+    }
     void stop() { m_audioOutput->stop(); }
+    void resize(QIODevice *device, int bufferSize)
+    {
+        // the buffer size is only applied when the sink starts
+        m_audioOutput->stop();
+        m_audioOutput->setBufferSize(bufferSize);
+        start(device);
+    }
+    void flush(QIODevice *device)
+    {
+        // drop what the sink has buffered, restart pulling if that stopped it
+        m_audioOutput->reset();
+        if (m_audioOutput->state() == QAudio::StoppedState)
+            start(device);
+        else
+            device->reset();
+    }
     int bufferSize() const { return m_audioOutput->bufferSize(); }
     void setVolume(qreal volume) { m_audioOutput->setVolume(volume); }
     qreal volume() const { return m_audioOutput->volume(); }
+    /// Bytes played since start, called from the audio thread only
+    qint64 processedBytes() const
+    {
+        const QAudioFormat format = m_audioOutput->format();
+        return ((m_audioOutput->processedUSecs() * format.sampleRate()) / 1000000) * format.bytesPerFrame();
+    }
 
-    void onStateChange(QAudio::State state) { emit stateChanged(state); }
+    void onStateChange(QAudio::State state) { emit stateChanged(state, m_audioOutput->error()); }
 
 signals:
-    void stateChanged(QAudio::State state);
+    void stateChanged(QAudio::State state, QAudio::Error error);
 
 public:
     AudioOutputWrapper() :
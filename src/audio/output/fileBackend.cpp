@@ -0,0 +1,126 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "fileBackend.h"
+
+#include <QByteArray>
+#include <QDebug>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+// WAVE format tags
+constexpr quint16 WAVE_FORMAT_PCM = 1;
+constexpr quint16 WAVE_FORMAT_IEEE_FLOAT = 3;
+
+constexpr int WAV_HEADER_SIZE = 44;
+
+void putLE16(char* dst, quint16 val) { qToLittleEndian(val, dst); }
+void putLE32(char* dst, quint32 val) { qToLittleEndian(val, dst); }
+}
+
+fileBackend::fileBackend(const QString& fileName) :
+    nullBackend(false),
+    m_file(fileName),
+    m_wav(fileName.endsWith(".wav", Qt::CaseInsensitive)),
+    m_fileFormat{ 0, 0, sample_t::S16 },
+    m_dataSize(0)
+{}
+
+fileBackend::~fileBackend()
+{
+    close();
+    m_file.close();
+}
+
+audioFormat_t fileBackend::openSink(audioFormat_t format)
+{
+    if (m_fileFormat.sampleRate != 0)
+    {
+        // songs are resampled and requantized to the file format but not remixed
+        if (format.channels != m_fileFormat.channels)
+            throw initError(QString("Cannot write %1 channels to a %2 channels file").arg(format.channels).arg(m_fileFormat.channels));
+        return m_fileFormat;
+    }
+
+    if (!m_file.open(QIODevice::WriteOnly|QIODevice::Truncate))
+        throw initError(QString("Cannot open %1: %2").arg(m_file.fileName(), m_file.errorString()));
+
+    qInfo() << "Writing output to" << m_file.fileName();
+
+    m_fileFormat = format;
+    m_dataSize = 0;
+    if (m_wav)
+        writeHeader();
+
+    return m_fileFormat;
+}
+
+void fileBackend::write(const char* data, qint64 size)
+{
+    if (m_file.write(data, size) != size)
+        qWarning() << "Error writing output:" << m_file.errorString();
+    m_dataSize += size;
+}
+
+void fileBackend::closeSink()
+{
+    if (!m_file.isOpen())
+        return;
+
+    // keep the file valid, writing goes on at the end if opened again
+    if (m_wav)
+    {
+        const qint64 pos = m_file.pos();
+        m_file.seek(0);
+        writeHeader();
+        m_file.seek(pos);
+    }
+    m_file.flush();
+}
+
+void fileBackend::writeHeader()
+{
+    const unsigned int sampleSize = bytesPerSample(m_fileFormat.sampleType);
+
+    const quint32 blockAlign = m_fileFormat.channels * sampleSize;
+    // sizes saturate past 4 GiB
+    const quint32 dataSize = static_cast<quint32>(std::min<quint64>(m_dataSize,
+        std::numeric_limits<quint32>::max() - WAV_HEADER_SIZE));
+
+    QByteArray header(WAV_HEADER_SIZE, 0);
+    char* h = header.data();
+    std::memcpy(h, "RIFF", 4);
+    putLE32(h + 4, dataSize + WAV_HEADER_SIZE - 8);
+    std::memcpy(h + 8, "WAVEfmt ", 8);
+    putLE32(h + 16, 16);
+    putLE16(h + 20, (m_fileFormat.sampleType == sample_t::SAMPLE_FLOAT) ? WAVE_FORMAT_IEEE_FLOAT : WAVE_FORMAT_PCM);
+    putLE16(h + 22, m_fileFormat.channels);
+    putLE32(h + 24, m_fileFormat.sampleRate);
+    putLE32(h + 28, m_fileFormat.sampleRate * blockAlign);
+    putLE16(h + 32, blockAlign);
+    putLE16(h + 34, sampleSize * 8);
+    std::memcpy(h + 36, "data", 4);
+    putLE32(h + 40, dataSize);
+
+    m_file.write(header);
+}
@@ -0,0 +1,65 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef FILEBACKEND_H
+#define FILEBACKEND_H
+
+#include "nullBackend.h"
+
+#include <QFile>
+
+/**
+ * Output to a file
+ *
+ * Everything played until the backend is destroyed goes to the same
+ * file, in the format of the first stream; later ones are converted,
+ * streams with a different channel count are refused.
+ * Files ending in .wav get a RIFF header, otherwise raw little endian
+ * samples are written.
+ */
+class fileBackend : public nullBackend
+{
+    Q_OBJECT
+
+private:
+    QFile m_file;
+
+    bool m_wav;
+
+    // format of the file, samplerate is 0 until opened
+    audioFormat_t m_fileFormat;
+
+    quint64 m_dataSize;
+
+private:
+    /// Write the WAV header for the data written so far
+    void writeHeader();
+
+protected:
+    audioFormat_t openSink(audioFormat_t format) override;
+
+    void write(const char* data, qint64 size) override;
+
+    void closeSink() override;
+
+public:
+    explicit fileBackend(const QString& fileName);
+    ~fileBackend() override;
+};
+
+#endif
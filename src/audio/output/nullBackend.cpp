@@ -0,0 +1,194 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "nullBackend.h"
+
+#include <QByteArray>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QIODevice>
+#include <QMutexLocker>
+#include <QThread>
+
+// Max time the output thread waits for a stream, in milliseconds
+constexpr unsigned long IDLE_TIMEOUT = 10;
+
+nullBackend::nullBackend(bool realtime) :
+    m_thread(nullptr),
+    m_device(nullptr),
+    m_reading(false),
+    m_stop(false),
+    m_paused(false),
+    m_started(false),
+    m_realtime(realtime),
+    m_format{ 0, 0, sample_t::S16 },
+    m_frameSize(0),
+    m_frames(0),
+    m_volume(0)
+{}
+
+nullBackend::~nullBackend()
+{
+    // subclasses close their sink on their own
+    if (m_thread != nullptr)
+    {
+        m_stop = true;
+        m_wakeUp.wakeAll();
+        m_thread->wait();
+        delete m_thread;
+    }
+}
+
+unsigned int nullBackend::bytesPerSample(sample_t sampleType)
+{
+    switch (sampleType)
+    {
+    case sample_t::U8:
+        return 1;
+    case sample_t::S16:
+        return 2;
+    case sample_t::S24:
+        return 3;
+    default:
+        return 4;
+    }
+}
+
+audioFormat_t nullBackend::init(int card, audioFormat_t format)
+{
+    Q_UNUSED(card);
+
+    m_format = openSink(format);
+
+    const unsigned int sampleSize = bytesPerSample(m_format.sampleType);
+    m_frameSize = m_format.channels * sampleSize;
+    m_frames = 0;
+
+    m_stop = false;
+    m_paused = false;
+    m_thread = QThread::create([this]() { pullLoop(); });
+    m_thread->start();
+
+    return m_format;
+}
+
+void nullBackend::pullLoop()
+{
+    // 10 ms at a time, like a device period
+    QByteArray buffer((m_format.sampleRate / 100) * m_frameSize, 0);
+
+    QElapsedTimer clock;
+    clock.start();
+    // frames read since the clock started
+    quint64 played = 0;
+
+    while (!m_stop)
+    {
+        qint64 n = 0;
+        if (!m_paused)
+        {
+            // a blocking stream may wait for its decoder, the lock is not held meanwhile
+            QIODevice* device;
+            {
+                QMutexLocker locker(&m_mutex);
+                device = m_device;
+                m_reading = (device != nullptr);
+            }
+            if (device != nullptr)
+            {
+                n = device->read(buffer.data(), buffer.size());
+                QMutexLocker locker(&m_mutex);
+                m_reading = false;
+                m_readDone.wakeAll();
+            }
+        }
+
+        if (n <= 0)
+        {
+            // No stream, time doesn't run
+            QMutexLocker locker(&m_mutex);
+            if (!m_stop)
+                m_wakeUp.wait(&m_mutex, IDLE_TIMEOUT);
+            clock.restart();
+            played = 0;
+            continue;
+        }
+
+        write(buffer.constData(), n);
+
+        const quint64 frames = n / m_frameSize;
+        m_frames += frames;
+
+        if (m_realtime)
+        {
+            played += frames;
+            const qint64 ahead = static_cast<qint64>((played * 1000) / m_format.sampleRate) - clock.elapsed();
+            if (ahead > 0)
+                QThread::msleep(ahead);
+        }
+    }
+}
+
+void nullBackend::start(QIODevice* device)
+{
+    device->open(QIODevice::ReadOnly|QIODevice::Unbuffered);
+
+    QMutexLocker locker(&m_mutex);
+    m_device = device;
+    m_started = true;
+    m_wakeUp.wakeAll();
+}
+
+void nullBackend::detach()
+{
+    QMutexLocker locker(&m_mutex);
+    m_device = nullptr;
+
+    // the stream can be released once a pending read is over
+    while (m_reading)
+        m_readDone.wait(&m_mutex);
+}
+
+void nullBackend::close()
+{
+    detach();
+    m_started = false;
+
+    if (m_thread == nullptr)
+        return;
+
+    m_stop = true;
+    m_wakeUp.wakeAll();
+    m_thread->wait();
+    delete m_thread;
+    m_thread = nullptr;
+
+    qInfo() << "Output frames:" << m_frames.load();
+    closeSink();
+}
+
+void nullBackend::pause()
+{
+    m_paused = true;
+}
+
+void nullBackend::unpause()
+{
+    m_paused = false;
+    m_wakeUp.wakeAll();
+}
@@ -0,0 +1,121 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef NULLBACKEND_H
+#define NULLBACKEND_H
+
+#include "outputBackend.h"
+
+#include <QMutex>
+#include <QWaitCondition>
+
+#include <atomic>
+
+class QThread;
+
+/**
+ * Output without a device
+ *
+ * A thread pulls the stream and drops it, as fast as the decoder
+ * can go or at the pace of a real device. Subclasses can store it.
+ */
+class nullBackend : public outputBackend
+{
+    Q_OBJECT
+
+private:
+    // pulls the stream
+    QThread *m_thread;
+
+    QMutex m_mutex;
+    QWaitCondition m_wakeUp;
+
+    // stream being read, guarded by m_mutex
+    QIODevice *m_device;
+    // a read is in progress outside the lock
+    bool m_reading;
+    QWaitCondition m_readDone;
+
+    std::atomic<bool> m_stop;
+    std::atomic<bool> m_paused;
+
+    bool m_started;
+    const bool m_realtime;
+
+    audioFormat_t m_format;
+    unsigned int m_frameSize;
+
+    std::atomic<quint64> m_frames;
+
+    int m_volume;
+
+private:
+    nullBackend(const nullBackend&) = delete;
+    nullBackend& operator=(const nullBackend&) = delete;
+
+    /// Output thread main loop
+    void pullLoop();
+
+protected:
+    /// Size in bytes of a sample
+    static unsigned int bytesPerSample(sample_t sampleType);
+
+    /// Open the sink, returns the format it takes
+    /// @throws initError
+    virtual audioFormat_t openSink(audioFormat_t format) { return format; }
+
+    /// Store a chunk of the stream, called from the output thread
+    virtual void write(const char* /*data*/, qint64 /*size*/) {}
+
+    /// Complete what was written, the sink may be opened again
+    virtual void closeSink() {}
+
+public:
+    /// With realtime the stream is read at the rate of a real device
+    explicit nullBackend(bool realtime);
+    ~nullBackend() override;
+
+    bool isRealtime() const override { return m_realtime; }
+
+    audioFormat_t init(int card, audioFormat_t format) override;
+
+    void start(QIODevice* device) override;
+
+    void detach() override;
+
+    bool isStarted() const override { return m_started; }
+
+    void close() override;
+
+    void pause() override;
+    void unpause() override;
+
+    void stop() override { detach(); }
+
+    void setVolume(int vol) override { m_volume = vol; }
+
+    int getVolume() override { return m_volume; }
+
+    /// Frames read since init
+    quint64 frames() const { return m_frames.load(); }
+
+    /// Format the stream is read in
+    audioFormat_t format() const { return m_format; }
+};
+
+#endif
@@ -0,0 +1,102 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef OUTPUTBACKEND_H
+#define OUTPUTBACKEND_H
+
+#include "inputTypes.h"
+#include "exceptions.h"
+
+#include <QObject>
+#include <QString>
+
+class QIODevice;
+
+/**
+ * Output backend interface
+ *
+ * The backend pulls the stream from the device given to start()
+ * and keeps running across streams until closed.
+ */
+class outputBackend : public QObject
+{
+    Q_OBJECT
+
+public:
+    class initError : public error { using error::error; };
+
+signals:
+    void songEnded();
+    void audioError(const QString&);
+
+public:
+    ~outputBackend() override = default;
+
+    /// Get the index of the named card, -1 for the default one
+    virtual int findCard(const QString& /*name*/) const { return -1; }
+
+    /// Get the card preferred samplerate, 0 if unknown
+    virtual unsigned int cardSamplerate(int /*card*/) const { return 0; }
+
+    /// Check if the output plays at the rate of a real device,
+    /// otherwise it waits for the decoder instead of playing silence
+    virtual bool isRealtime() const { return true; }
+
+    /// init audio, returns the format actually used
+    /// @throws initError
+    virtual audioFormat_t init(int card, audioFormat_t format) = 0;
+
+    /// Set the bounds of the buffer length in milliseconds, applied at the next init
+    virtual void setBufferTime(unsigned int /*minMs*/, unsigned int /*maxMs*/) {}
+
+    /// Number of times the output ran out of data
+    virtual unsigned int underruns() const { return 0; }
+
+    /// Start audio, or switch to a new stream if already started
+    virtual void start(QIODevice* device) = 0;
+
+    /// Detach the stream keeping the output open
+    virtual void detach() = 0;
+
+    /// Check if the output is open and running
+    virtual bool isStarted() const = 0;
+
+    /// Close
+    virtual void close() = 0;
+
+    /// Pause
+    virtual void pause() = 0;
+    virtual void unpause() = 0;
+
+    /// Stop
+    virtual void stop() = 0;
+
+    /// Drop the audio buffered in the output
+    virtual void flush() {}
+
+    /// Frames handed to the output and not played yet
+    virtual unsigned int latency() const { return 0; }
+
+    /// Set volume
+    virtual void setVolume(int vol) = 0;
+
+    /// Get volume
+    virtual int getVolume() = 0;
+};
+
+#endif
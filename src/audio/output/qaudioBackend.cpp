@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2006-2025 Leandro Nini
+ *  Copyright (C) 2006-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -31,6 +31,11 @@
 #include <QDebug>
 #include <QThreadPool>
 
+#include <algorithm>
+
+// Time without underruns before the sink buffer is shrunk, in milliseconds
+constexpr qint64 SHRINK_TIME = 30000;
+
 /*****************************************************************/
 
 void deviceLoader::run()
@@ -100,7 +105,17 @@ deviceList_t qaudioBackend::getDevices()
 #endif
 
 qaudioBackend::qaudioBackend() :
-    m_thread(new QThread())
+    m_thread(new QThread()),
+    m_proxy(nullptr),
+    m_started(false),
+    m_frameSize(0),
+    m_sampleRate(0),
+    m_bufferTime(0),
+    m_minBufferTime(0),
+    m_maxBufferTime(0),
+    m_sinkBufferTime(0),
+    m_underruns(0),
+    m_volume(0)
 {
     // Preload available devices in a separate thread
     deviceLoader* loader = new deviceLoader();
@@ -108,7 +123,12 @@ qaudioBackend::qaudioBackend() :
     QThreadPool::globalInstance()->start(loader);
 }
 
-qaudioBackend::~qaudioBackend() { delete m_thread; }
+qaudioBackend::~qaudioBackend()
+{
+    m_thread->quit();
+    m_thread->wait();
+    delete m_thread;
+}
 
 const char* getErrorString(QAudio::Error error)
 {
@@ -121,25 +141,31 @@ const char* getErrorString(QAudio::Error error)
     }
 }
 
-void qaudioBackend::onStateChange(QAudio::State newState)
+void qaudioBackend::onStateChange(QAudio::State newState, QAudio::Error error)
 {
     qDebug() << "onStateChange: " << newState;
     switch (newState)
     {
     case QAudio::IdleState:
         //emit songEnded();
+        if (m_started && (error == QAudio::UnderrunError))
+        {
+            // The sink ran dry, so nothing is lost restarting it with a larger buffer
+            m_underruns++;
+            m_bufferTime = std::min(m_bufferTime * 2, m_maxBufferTime);
+            m_steadyTime.restart();
+            qDebug() << "Output underrun, buffer:" << m_bufferTime << "ms";
+            if (m_bufferTime != m_sinkBufferTime)
+                resizeSink();
+        }
         break;
     case QAudio::StoppedState:
-        if (m_thread->isRunning())
+        // the error comes with the state so the audio thread is not queried
+        if (m_started && (error != QAudio::NoError))
         {
-            QAudio::Error error;
-            QMetaObject::invokeMethod(m_audioOutput, "error", Qt::BlockingQueuedConnection, Q_RETURN_ARG(QAudio::Error, error));
-            if (error != QAudio::NoError)
-            {
-                QString errorMsg = getErrorString(error);
-                qDebug() << "errorMsg: " << errorMsg;
-                emit audioError(errorMsg);
-            }
+            QString errorMsg = getErrorString(error);
+            qDebug() << "errorMsg: " << errorMsg;
+            emit audioError(errorMsg);
         }
         break;
     default:
@@ -147,6 +173,17 @@ void qaudioBackend::onStateChange(QAudio::State newState)
     }
 }
 
+unsigned int qaudioBackend::preferredSamplerate(int card)
+{
+#if QT_VERSION >= 0x060000
+    const QAudioDevice deviceInfo = card != -1 ? devices[card] : QMediaDevices::defaultAudioOutput();
+#else
+    const QAudioDeviceInfo deviceInfo = card != -1 ? devices[card] : QAudioDeviceInfo::defaultOutputDevice();
+#endif
+    const int rate = deviceInfo.preferredFormat().sampleRate();
+    return rate > 0 ? rate : 0;
+}
+
 audioFormat_t qaudioBackend::init(int card, audioFormat_t format)
 {
 #if QT_VERSION >= 0x060000
@@ -265,15 +302,49 @@ audioFormat_t qaudioBackend::init(int card, audioFormat_t format)
     }
 #endif
 
+    unsigned int sampleSize;
+    switch (outputFormat.sampleType)
+    {
+    case sample_t::U8:
+        sampleSize = 1;
+        break;
+    case sample_t::S16:
+        sampleSize = 2;
+        break;
+    case sample_t::S24:
+        sampleSize = 3;
+        break;
+    default:
+        sampleSize = 4;
+        break;
+    }
+    // 10 ms of silence at a time
+    m_proxy = new streamProxy();
+    m_proxy->setSilence((outputFormat.sampleType == sample_t::U8) ? static_cast<char>(0x80) : 0,
+        (outputFormat.sampleRate / 100) * outputFormat.channels * sampleSize);
+
     m_audioOutput = new AudioOutputWrapper();
+    m_proxy->setOutput(m_audioOutput);
+    m_frameSize = outputFormat.channels * sampleSize;
+
+    m_sampleRate = outputFormat.sampleRate;
+
+    // the period is chosen by the platform from the buffer size
+    shrinkBufferTime();
+    m_sinkBufferTime = m_bufferTime;
+    const int bufferSize = ((m_bufferTime * m_sampleRate) / 1000) * m_frameSize;
+    qDebug() << "Output buffer:" << m_bufferTime << "ms";
 
     m_audioOutput->moveToThread(m_thread);
-    m_thread->start();
+    m_proxy->moveToThread(m_thread);
+    // the thread is kept running across sessions
+    if (!m_thread->isRunning())
+        m_thread->start();
 
 #if QT_VERSION >= 0x060000
-    QMetaObject::invokeMethod(m_audioOutput, "init", Q_ARG(QAudioDevice, deviceInfo), Q_ARG(QAudioFormat, qFormat));
+    QMetaObject::invokeMethod(m_audioOutput, "init", Q_ARG(QAudioDevice, deviceInfo), Q_ARG(QAudioFormat, qFormat), Q_ARG(int, bufferSize));
 #else
-    QMetaObject::invokeMethod(m_audioOutput, "init", Q_ARG(QAudioDeviceInfo, deviceInfo), Q_ARG(QAudioFormat, qFormat));
+    QMetaObject::invokeMethod(m_audioOutput, "init", Q_ARG(QAudioDeviceInfo, deviceInfo), Q_ARG(QAudioFormat, qFormat), Q_ARG(int, bufferSize));
 #endif
 
     connect(m_audioOutput, &AudioOutputWrapper::stateChanged, this, &qaudioBackend::onStateChange);
@@ -283,16 +354,77 @@ audioFormat_t qaudioBackend::init(int card, audioFormat_t format)
 
 void qaudioBackend::start(QIODevice* device)
 {
-    device->open(QIODevice::ReadOnly);
-    QMetaObject::invokeMethod(m_audioOutput, "start", Q_ARG(QIODevice*, device));
+    // Unbuffered so no data is left behind when the stream is swapped
+    device->open(QIODevice::ReadOnly|QIODevice::Unbuffered);
+    m_proxy->setSource(device);
+
+    if (m_started)
+    {
+        // After a halt the sink only holds silence, it can be resized
+        shrinkBufferTime();
+        if (m_bufferTime != m_sinkBufferTime)
+            resizeSink();
+        return;
+    }
+
+    m_proxy->open(QIODevice::ReadOnly|QIODevice::Unbuffered);
+    QMetaObject::invokeMethod(m_audioOutput, "start", Q_ARG(QIODevice*, m_proxy));
+    m_started = true;
+}
+
+void qaudioBackend::shrinkBufferTime()
+{
+    if (!m_steadyTime.isValid())
+        m_steadyTime.start();
+
+    if ((m_bufferTime > m_minBufferTime) && (m_steadyTime.elapsed() > SHRINK_TIME))
+    {
+        m_bufferTime = std::max(m_bufferTime / 2, m_minBufferTime);
+        m_steadyTime.restart();
+        qDebug() << "No output underruns, buffer:" << m_bufferTime << "ms";
+    }
+}
+
+void qaudioBackend::resizeSink()
+{
+    if (m_proxy == nullptr)
+        return;
+
+    m_sinkBufferTime = m_bufferTime;
+    const int bufferSize = ((m_bufferTime * m_sampleRate) / 1000) * m_frameSize;
+    QMetaObject::invokeMethod(m_audioOutput, "resize", Q_ARG(QIODevice*, m_proxy), Q_ARG(int, bufferSize));
+}
+
+void qaudioBackend::setBufferTime(unsigned int minMs, unsigned int maxMs)
+{
+    // keeps the length grown by underruns if still within bounds
+    m_minBufferTime = minMs;
+    m_maxBufferTime = std::max(minMs, maxMs);
+    m_bufferTime = std::clamp(m_bufferTime, m_minBufferTime, m_maxBufferTime);
+}
+
+void qaudioBackend::detach()
+{
+    if (m_proxy != nullptr)
+        m_proxy->setSource(nullptr);
 }
 
 void qaudioBackend::close()
 {
-    QMetaObject::invokeMethod(m_audioOutput, "deleteLater");
+    if (m_proxy == nullptr)
+        return;
 
-    m_thread->quit();
-    m_thread->wait();
+    // Once detached the stream is no longer read, the sink
+    // and the proxy are released in order by the audio thread
+    m_proxy->setSource(nullptr);
+    m_started = false;
+
+    qInfo() << "Output underruns:" << m_underruns;
+
+    QMetaObject::invokeMethod(m_audioOutput, "stop");
+    QMetaObject::invokeMethod(m_audioOutput, "deleteLater");
+    QMetaObject::invokeMethod(m_proxy, "deleteLater");
+    m_proxy = nullptr;
 }
 
 void qaudioBackend::pause()
@@ -307,11 +439,31 @@ void qaudioBackend::unpause()
 
 void qaudioBackend::stop()
 {
-    QMetaObject::invokeMethod(m_audioOutput, "stop", Qt::BlockingQueuedConnection);
+    // No blocking, the stream is detached so it can be released right away
+    detach();
+    QMetaObject::invokeMethod(m_audioOutput, "stop");
+}
+
+void qaudioBackend::flush()
+{
+    if (m_proxy == nullptr)
+        return;
+
+    QMetaObject::invokeMethod(m_audioOutput, "flush", Q_ARG(QIODevice*, m_proxy));
+}
+
+unsigned int qaudioBackend::latency() const
+{
+    if ((m_proxy == nullptr) || (m_frameSize == 0))
+        return 0;
+
+    return m_proxy->queued() / m_frameSize;
 }
 
 void qaudioBackend::setVolume(int vol)
 {
+    m_volume = vol;
+
     if (m_audioOutput.isNull())
         return;
 
@@ -324,12 +476,5 @@ void qaudioBackend::setVolume(int vol)
 
 int qaudioBackend::getVolume()
 {
-    if (m_audioOutput.isNull())
-        return 0;
-
-    qreal volume;
-    QMetaObject::invokeMethod(m_audioOutput, "volume", Qt::BlockingQueuedConnection, Q_RETURN_ARG(qreal, volume));
-    return QAudio::convertVolume(volume,
-                                 QAudio::LinearVolumeScale,
-                                 QAudio::LogarithmicVolumeScale) * 100;
+    return m_volume;
 }
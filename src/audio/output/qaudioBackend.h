@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2006-2025 Leandro Nini
+ *  Copyright (C) 2006-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -19,16 +19,19 @@
 #ifndef QAUDIOBACKEND_H
 #define QAUDIOBACKEND_H
 
-#include "inputTypes.h"
+#include "outputBackend.h"
 #include "AudioOutputWrapper.h"
-#include "exceptions.h"
+#include "streamProxy.h"
 
 #include <QAudio>
+#include <QElapsedTimer>
 #include <QPointer>
 #include <QRunnable>
 #include <QThread>
 #include <QVariant>
 
+#include <atomic>
+
 /*****************************************************************/
 
 class deviceLoader : public QRunnable
@@ -64,25 +67,49 @@ using deviceList_t = QList<device_t>;
 /**
  * QAudio output backend
  */
-class qaudioBackend : public QObject
+class qaudioBackend : public outputBackend
 {
     Q_OBJECT
 
-public:
-    class initError : public error { using error::error; };
-
 private:
     QPointer<AudioOutputWrapper> m_audioOutput;
 
     // audio thread
     QThread *m_thread;
 
-signals:
-    void songEnded();
-    void audioError(const QString&);
+    // device read by the sink, the stream is swapped behind it,
+    // lives in the audio thread and is released with the sink
+    streamProxy* m_proxy;
+
+    bool m_started;
+
+    unsigned int m_frameSize;
+
+    unsigned int m_sampleRate;
+
+    // sink buffer length in milliseconds, doubled on underruns up to the max
+    // and halved back toward the min after a while without them
+    unsigned int m_bufferTime;
+    unsigned int m_minBufferTime;
+    unsigned int m_maxBufferTime;
+    // length the running sink was started with
+    unsigned int m_sinkBufferTime;
+    // time since the last change of the length
+    QElapsedTimer m_steadyTime;
+
+    unsigned int m_underruns;
+
+    // last volume set, read without asking the audio thread
+    std::atomic<int> m_volume;
 
 private:
-    void onStateChange(QAudio::State newState);
+    void onStateChange(QAudio::State newState, QAudio::Error error);
+
+    /// Lower the buffer length if no underrun happened for a while
+    void shrinkBufferTime();
+
+    /// Restart the sink with the current buffer length, dropping what it holds
+    void resizeSink();
 
 public:
     qaudioBackend();
@@ -91,28 +118,53 @@ public:
 
     static deviceList_t getDevices();
 
+    /// Get the device preferred samplerate, 0 if unknown
+    static unsigned int preferredSamplerate(int card);
+
+    int findCard(const QString& name) const override { return getDevices().indexOf(name); }
+
+    unsigned int cardSamplerate(int card) const override { return preferredSamplerate(card); }
+
     /// init audio
     /// @throws initError
-    audioFormat_t init(int card, audioFormat_t format);
+    audioFormat_t init(int card, audioFormat_t format) override;
+
+    /// Set the bounds of the sink buffer length in milliseconds
+    void setBufferTime(unsigned int minMs, unsigned int maxMs) override;
 
-    /// Start audio
-    void start(QIODevice* device);
+    /// Number of times the sink ran out of data
+    unsigned int underruns() const override { return m_underruns; }
+
+    /// Start audio, or switch to a new stream if already started
+    void start(QIODevice* device) override;
+
+    /// Detach the stream keeping the output open, silence is played
+    void detach() override;
+
+    /// Check if the output is open and running
+    bool isStarted() const override { return m_started; }
 
     /// Close
-    void close();
+    void close() override;
 
     /// Pause
-    void pause();
-    void unpause();
+    void pause() override;
+    void unpause() override;
 
     /// Stop
-    void stop();
+    void stop() override;
+
+    /// Drop the audio buffered in the sink
+    void flush() override;
+
+    /// Frames handed to the sink and not played yet
+    unsigned int latency() const override;
 
     /// Set volume
-    void setVolume(int vol);
+    void setVolume(int vol) override;
 
     /// Get volume
-    int getVolume();
+    int getVolume() override;
 };
 
 #endif
@@ -0,0 +1,111 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "streamProxy.h"
+
+#include "AudioOutputWrapper.h"
+
+#include <QMutexLocker>
+
+#include <algorithm>
+#include <cstring>
+
+streamProxy::streamProxy() :
+    m_source(nullptr),
+    m_silence(0),
+    m_silenceSize(0),
+    m_output(nullptr),
+    m_read(0),
+    m_queued(0)
+{}
+
+void streamProxy::setSilence(char value, qint64 size)
+{
+    QMutexLocker locker(&m_mutex);
+    m_silence = value;
+    m_silenceSize = size;
+}
+
+void streamProxy::setSource(QIODevice* source)
+{
+    QMutexLocker locker(&m_mutex);
+    m_source = source;
+}
+
+void streamProxy::setOutput(const AudioOutputWrapper* output)
+{
+    QMutexLocker locker(&m_mutex);
+    m_output = output;
+}
+
+bool streamProxy::reset()
+{
+    QMutexLocker locker(&m_mutex);
+    m_read = 0;
+    m_queued = 0;
+    return true;
+}
+
+bool streamProxy::hasSource()
+{
+    QMutexLocker locker(&m_mutex);
+    return m_source != nullptr;
+}
+
+qint64 streamProxy::readData(char *data, qint64 maxSize)
+{
+    QMutexLocker locker(&m_mutex);
+
+    qint64 n = (m_source != nullptr) ? m_source->read(data, maxSize) : 0;
+    if (n <= 0)
+    {
+        // Keep the sink running until the next song is attached,
+        // an idle sink may not resume pulling on its own
+        n = std::min(maxSize, m_silenceSize);
+        std::memset(data, m_silence, n);
+    }
+
+    // the output lives in this thread so it can be queried here
+    m_read += n;
+    if (m_output != nullptr)
+        m_queued = std::clamp(m_read - m_output->processedBytes(), qint64(0), qint64(m_output->bufferSize()));
+
+    return n;
+}
+
+qint64 streamProxy::writeData(const char *data, qint64 maxSize)
+{
+    Q_UNUSED(data);
+    Q_UNUSED(maxSize);
+
+    return 0;
+}
+
+qint64 streamProxy::bytesAvailable() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_source != nullptr)
+    {
+        const qint64 n = m_source->bytesAvailable();
+        if (n > 0)
+            return n;
+    }
+
+    return m_silenceSize + QIODevice::bytesAvailable();
+}
@@ -0,0 +1,84 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef STREAMPROXY_H
+#define STREAMPROXY_H
+
+#include <QIODevice>
+#include <QMutex>
+
+#include <atomic>
+
+class AudioOutputWrapper;
+
+/**
+ * Device read by the audio sink, forwarding to the current source.
+ * Sources can be swapped while the sink is running so the output
+ * stays open across songs; without data from the source silence is played.
+ */
+class streamProxy : public QIODevice
+{
+private:
+    mutable QMutex m_mutex;
+
+    QIODevice* m_source;
+
+    char m_silence;
+
+    qint64 m_silenceSize;
+
+    const AudioOutputWrapper* m_output;
+
+    // bytes handed to the sink since it started and how many of them it has not played yet
+    qint64 m_read;
+    std::atomic<qint64> m_queued;
+
+private:
+    streamProxy(const streamProxy&) = delete;
+    streamProxy& operator=(const streamProxy&) = delete;
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+public:
+    streamProxy();
+    ~streamProxy() override = default;
+
+    qint64 bytesAvailable() const override;
+
+    /// Restart counting the data read, called when the sink starts
+    bool reset() override;
+
+    /// Set the silence played without a source
+    void setSilence(char value, qint64 size);
+
+    /// Replace the source, waits for a pending read to complete
+    void setSource(QIODevice* source);
+
+    /// Check if a source is set
+    bool hasSource();
+
+    /// Set the output reading the stream, used to track its delay
+    void setOutput(const AudioOutputWrapper* output);
+
+    /// Bytes read by the output and not played yet
+    qint64 queued() const { return m_queued.load(); }
+};
+
+#endif
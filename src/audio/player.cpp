@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2021-2025 Leandro Nini
+ *  Copyright (C) 2021-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -28,8 +28,11 @@
 player::player() :
     m_input(IFACTORY->get()),
     m_audio(new audio),
-    m_preload(IFACTORY->get())
+    m_preload(IFACTORY->get()),
+    m_loader(new loader)
 {
+    connect(m_loader.get(), &loader::loaded,    this, &player::onLoaded);
+    connect(m_loader.get(), &loader::preloaded, this, &player::onPreloaded);
     connect(m_audio.get(), &audio::updateTime,  this, &player::updateTime);
     connect(m_audio.get(), &audio::songEnded,   this, &player::songEnded);
     connect(m_audio.get(), &audio::preloadSong, this, &player::preloadSong);
@@ -63,6 +66,12 @@ void player::stop()
         emit stateChanged();
 }
 
+void player::halt()
+{
+    if (m_audio->halt())
+        emit stateChanged();
+}
+
 void player::pause()
 {
     m_audio->pause();
@@ -71,7 +80,9 @@ void player::pause()
 
 state_t player::state() const { return m_audio->state(); }
 
-int player::seconds() const { return m_audio->getPosition()/1000; }
+int player::seconds() const { return elapsed()/1000; }
+
+int player::elapsed() const { return m_audio->getPosition(); }
 
 void player::setPosition(double pos)
 {
@@ -102,7 +113,13 @@ bool player::tryPreload(const QString& song)
     bool res = false;
     if (!songPreloaded.compare(song))
     {
-        m_input.reset(m_preload.release());
+        // Songs selected before the end play from their lookahead,
+        // the output may still be reading the previous one for a while
+        if (m_audio->skipToPreload())
+            m_skipped = std::move(m_input);
+        else
+            m_skipped.reset();
+        m_input = std::move(m_preload);
         emit songChanged();
         res = true;
     }
@@ -113,16 +130,37 @@ bool player::tryPreload(const QString& song)
 
 void player::load(const QString& filename)
 {
-    loader* fileLoader = new loader(filename);
-    connect(fileLoader, &loader::loaded, this, &player::loaded);
-    connect(fileLoader, &loader::finished, fileLoader, &loader::deleteLater);
-    fileLoader->start();
+    m_loader->load(filename);
+}
+
+void player::onLoaded(input* res, quint64 generation)
+{
+    // a newer request may have been issued in the meantime
+    if (!m_loader->isCurrentLoad(generation))
+    {
+        delete res;
+        return;
+    }
+
+    m_audio->setOpenLatency(m_loader->openLatency());
+    loaded(res);
+}
+
+void player::unload()
+{
+    m_loader->cancel();
+    loaded(nullptr);
 }
 
 void player::loaded(input* res)
 {
     state_t state = m_audio->state();
-    stop();
+    // the output stays open for the new song if it's playing
+    if ((res != nullptr) && (state == state_t::PLAY))
+        halt();
+    else
+        stop();
+    m_skipped.reset();
 
     bool loaded;
     if (res != nullptr)
@@ -146,10 +184,7 @@ void player::loaded(input* res)
 
 void player::preload(const QString& filename)
 {
-    loader* fileLoader = new loader(filename);
-    connect(fileLoader, &loader::loaded, this, &player::preloaded);
-    connect(fileLoader, &loader::finished, fileLoader, &loader::deleteLater);
-    fileLoader->start();
+    m_loader->preload(filename);
 }
 
 const metaData* player::getMetaData() const { return m_input->getMetaData(); }
@@ -166,11 +201,20 @@ QString player::loadedSong() const { return m_input->songLoaded(); }
 
 unsigned int player::songDuration() const { return m_input->songDuration(); }
 
-void player::preloaded(input* res)
+void player::onPreloaded(input* res, quint64 generation)
 {
-    if ((res != nullptr) && m_audio->gapless(res))
+    if (!m_loader->isCurrentPreload(generation))
+    {
+        delete res;
+        return;
+    }
+
+    m_audio->setOpenLatency(m_loader->openLatency());
+
+    std::shared_ptr<input> song(res);
+    if ((res != nullptr) && m_audio->gapless(song))
     {
-        m_preload.reset(res);
+        m_preload = std::move(song);
 
         qDebug() << "Song preloaded";
     }
@@ -214,7 +258,7 @@ void player::changeSubtune(dir_t dir)
 
     bool const isPlaying = (state() == state_t::PLAY);
     if (isPlaying)
-        pause();
+        halt();
     if (m_input->subtune(i))
     {
         emit subtunechanged();
@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2021-2025 Leandro Nini
+ *  Copyright (C) 2021-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -28,6 +28,7 @@
 
 class audio;
 class input;
+class loader;
 
 enum class dir_t
 {
@@ -42,9 +43,13 @@ class player : public QObject
     Q_OBJECT
 
 private:
-    std::unique_ptr<input> m_input;
+    // songs are shared with the decoder thread
+    std::shared_ptr<input> m_input;
+    // song skipped from, kept until the output is done with it
+    std::shared_ptr<input> m_skipped;
     std::unique_ptr<audio> m_audio;
-    std::unique_ptr<input> m_preload;
+    std::shared_ptr<input> m_preload;
+    std::unique_ptr<loader> m_loader;
 
 private:
     player(const player&) = delete;
@@ -52,10 +57,15 @@ private:
 
     void loaded(input* res);
 
-    void preloaded(input* res);
+    void onLoaded(input* res, quint64 generation);
+
+    void onPreloaded(input* res, quint64 generation);
 
     void onError(const QString& error);
 
+    /// Stop playback keeping the output open
+    void halt();
+
 signals:
     void stateChanged();
     void songChanged();
@@ -91,6 +101,9 @@ public:
     /// Get current position in seconds
     int seconds() const;
 
+    /// Get current position in milliseconds
+    int elapsed() const;
+
     /// Set current position [0,1]
     void setPosition(double pos);
 
@@ -137,7 +150,7 @@ public:
     void playOnLoad();
 
     /// Unload song
-    void unload() { loaded(nullptr); }
+    void unload();
 
     /// Preload song
     void preload(const QString& filename);
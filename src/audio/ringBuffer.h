@@ -0,0 +1,125 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+#include <QtGlobal>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+/**
+ * Lock-free single-producer/single-consumer byte ring buffer
+ *
+ * Read and write positions are free running 64 bit counters,
+ * so they can also be used to mark positions in the stream.
+ */
+class ringBuffer
+{
+private:
+    std::vector<char> m_buffer;
+
+    const size_t m_mask;
+
+    std::atomic<quint64> m_readPos;
+    std::atomic<quint64> m_writePos;
+
+private:
+    ringBuffer() = delete;
+    ringBuffer(const ringBuffer&) = delete;
+    ringBuffer& operator=(const ringBuffer&) = delete;
+
+    static size_t roundUp(size_t size)
+    {
+        size_t res = 1;
+        while (res < size)
+            res <<= 1;
+        return res;
+    }
+
+public:
+    /// Create a buffer of at least size bytes
+    ringBuffer(size_t size) :
+        m_buffer(roundUp(size)),
+        m_mask(m_buffer.size()-1),
+        m_readPos(0),
+        m_writePos(0)
+    {}
+
+    /// Buffer capacity in bytes
+    size_t capacity() const { return m_buffer.size(); }
+
+    /// Total bytes read so far
+    quint64 readPos() const { return m_readPos.load(std::memory_order_acquire); }
+
+    /// Total bytes written so far
+    quint64 writePos() const { return m_writePos.load(std::memory_order_acquire); }
+
+    /// Bytes available for reading
+    size_t size() const { return writePos() - readPos(); }
+
+    /// Bytes available for writing
+    size_t space() const { return capacity() - size(); }
+
+    /// Write data, producer side
+    size_t write(const char* data, size_t len)
+    {
+        const quint64 w = m_writePos.load(std::memory_order_relaxed);
+        const quint64 r = m_readPos.load(std::memory_order_acquire);
+
+        len = std::min(len, capacity() - static_cast<size_t>(w - r));
+
+        const size_t pos = w & m_mask;
+        const size_t first = std::min(len, capacity() - pos);
+        std::memcpy(m_buffer.data() + pos, data, first);
+        std::memcpy(m_buffer.data(), data + first, len - first);
+
+        m_writePos.store(w + len, std::memory_order_release);
+        return len;
+    }
+
+    /// Read data, consumer side
+    size_t read(char* data, size_t len)
+    {
+        const quint64 r = m_readPos.load(std::memory_order_relaxed);
+        const quint64 w = m_writePos.load(std::memory_order_acquire);
+
+        len = std::min(len, static_cast<size_t>(w - r));
+
+        const size_t pos = r & m_mask;
+        const size_t first = std::min(len, capacity() - pos);
+        std::memcpy(data, m_buffer.data() + pos, first);
+        std::memcpy(data + first, m_buffer.data(), len - first);
+
+        m_readPos.store(r + len, std::memory_order_release);
+        return len;
+    }
+
+    /// Drop data up to the given stream position, consumer side
+    void skipTo(quint64 pos)
+    {
+        const quint64 r = m_readPos.load(std::memory_order_relaxed);
+        if (pos > r)
+            m_readPos.store(std::min(pos, writePos()), std::memory_order_release);
+    }
+};
+
+#endif
@@ -0,0 +1,57 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include "scanPool.h"
+
+#include "utils.h"
+
+#include <utility>
+
+scanPool::scanPool(int maxThreads) :
+    m_generation(0),
+    m_pending(0)
+{
+    m_pool.setMaxThreadCount(maxThreads);
+}
+
+scanPool::~scanPool()
+{
+    stop();
+}
+
+void scanPool::submit(unsigned int generation, std::function<void()> task)
+{
+    m_pending++;
+    m_pool.start(
+        [this, generation, task=std::move(task)]()
+        {
+            utils::lowPriority();
+            if (!isCancelled(generation))
+                task();
+            m_pending--;
+        }
+    );
+}
+
+void scanPool::stop()
+{
+    cancel();
+    m_pool.clear();
+    m_pool.waitForDone();
+}
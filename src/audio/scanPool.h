@@ -0,0 +1,71 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef SCANPOOL_H
+#define SCANPOOL_H
+
+#include <QThreadPool>
+
+#include <atomic>
+#include <functional>
+
+/**
+ * Thread pool for the background scanners
+ *
+ * Tasks run with low priority and are tagged with the generation
+ * they were submitted for. Cancelling starts a new generation so
+ * stale tasks, including the ones still queued, can drop out
+ * while the next scan is already being fed.
+ */
+class scanPool
+{
+private:
+    QThreadPool m_pool;
+
+    std::atomic<unsigned int> m_generation;
+    std::atomic<int> m_pending;
+
+private:
+    scanPool(const scanPool&) = delete;
+    scanPool& operator=(const scanPool&) = delete;
+
+public:
+    scanPool(int maxThreads);
+    ~scanPool();
+
+    /// Generation of the tasks of a new scan
+    unsigned int generation() const { return m_generation; }
+
+    /// Check if tasks of the given generation were cancelled
+    bool isCancelled(unsigned int generation) const { return generation != m_generation; }
+
+    /// Queue a task, skipped if cancelled before running
+    void submit(unsigned int generation, std::function<void()> task);
+
+    /// Cancel the queued and running tasks
+    void cancel() { m_generation++; }
+
+    /// Cancel and wait for the running tasks to return
+    void stop();
+
+    /// Tasks queued or running, including the cancelled ones
+    int pending() const { return m_pending; }
+};
+
+#endif
@@ -0,0 +1,832 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "fixtures.h"
+
+#include "audio.h"
+#include "inputFactory.h"
+#include "input/input.h"
+#include "converter/converterFactory.h"
+#include "dsp/crossfeed.h"
+#include "dsp/dspChain.h"
+#include "dsp/equalizer.h"
+#include "dsp/limiter.h"
+#include "dsp/loudnessMeter.h"
+#include "dsp/preamp.h"
+#include "output/fileBackend.h"
+#include "output/nullBackend.h"
+#include "settings.h"
+
+#include <QCommandLineParser>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QFileInfo>
+#include <QGuiApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLoggingCategory>
+#include <QSettings>
+#include <QTemporaryDir>
+#include <QTextStream>
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#if defined(_WIN32)
+#  include <windows.h>
+#  include <psapi.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#  include <sys/resource.h>
+#endif
+
+/*
+ * Standalone benchmark for the audio engine.
+ *
+ * Every registered input backend decodes the files it supports into a null sink
+ * and every converter built by the converter factory and DSP node runs on synthetic data.
+ * The pipeline run plays all the files back to back through the engine into a null or file sink.
+ * Without arguments only the generated fixtures are used, so it runs offline.
+ */
+
+namespace
+{
+// same chunk the InputWrapper decodes at a time
+constexpr size_t CHUNK_FRAMES = 2048;
+
+// fractional bits used for fixed point input
+constexpr unsigned int FIXED_FRACT = 28;
+
+// samplerate of the DSP benchmark
+constexpr unsigned int DSP_RATE = 48000;
+
+struct options_t
+{
+    unsigned int seconds;
+    bool inputs;
+    bool converters;
+    bool dsp;
+    bool pipeline;
+    bool realtime;
+    QString outputFile;
+};
+
+struct inputResult_t
+{
+    QString backend;
+    QString file;
+    double audioSecs;
+    double xRealtime;
+    double firstSampleMs;
+    double p50Us;
+    double p99Us;
+    double maxUs;
+    long peakRssKiB;
+};
+
+struct pipelineResult_t
+{
+    int songs;
+    int gapless;
+    double audioSecs;
+    double xRealtime;
+    unsigned int underruns;
+    unsigned int minFillMs;
+};
+
+struct converterResult_t
+{
+    QString name;
+    double xRealtime;
+    double nsPerFrame;
+};
+
+unsigned int sampleSize(sample_t type)
+{
+    switch (type)
+    {
+    case sample_t::U8:
+        return 1;
+    case sample_t::S16:
+        return 2;
+    case sample_t::S24:
+        return 3;
+    default:
+        return 4;
+    }
+}
+
+const char* sampleName(sample_t type)
+{
+    switch (type)
+    {
+    case sample_t::U8:
+        return "U8";
+    case sample_t::S16:
+        return "S16";
+    case sample_t::S24:
+        return "S24";
+    case sample_t::S32:
+        return "S32";
+    case sample_t::SAMPLE_FLOAT:
+        return "FLOAT";
+    case sample_t::SAMPLE_FIXED:
+        return "FIXED";
+    default:
+        return "?";
+    }
+}
+
+const char* qualityName(resampler_t quality)
+{
+    switch (quality)
+    {
+    case resampler_t::Fast:
+        return "fast";
+    case resampler_t::Best:
+        return "best";
+    default:
+        return "medium";
+    }
+}
+
+/// Reset the peak resident set size, where supported
+void resetPeakRss()
+{
+#ifdef __linux__
+    // since Linux 4.0 writing 5 resets VmHWM
+    QFile f("/proc/self/clear_refs");
+    if (f.open(QIODevice::WriteOnly))
+        f.write("5");
+#endif
+}
+
+/// Peak resident set size in KiB
+long peakRss()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        return static_cast<long>(pmc.PeakWorkingSetSize / 1024);
+    return 0;
+#else
+#  ifdef __linux__
+    QFile f("/proc/self/status");
+    if (f.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        while (!f.atEnd())
+        {
+            const QByteArray line = f.readLine();
+            if (line.startsWith("VmHWM:"))
+                return line.mid(6).trimmed().split(' ').first().toLong();
+        }
+    }
+#  endif
+#  if defined(__unix__) || defined(__APPLE__)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+#    ifdef __APPLE__
+        return usage.ru_maxrss / 1024;
+#    else
+        return usage.ru_maxrss;
+#    endif
+#  endif
+    return 0;
+#endif
+}
+
+/// Value at the given percentile of a sorted sample
+double percentile(const std::vector<qint64>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0.;
+
+    const size_t idx = std::min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()));
+    return sorted[idx];
+}
+
+/*****************************************************************/
+
+/// Decode up to opt.seconds of file through the given backend
+bool benchInput(int backend, const QString& file, const options_t& opt, inputResult_t& result)
+{
+    resetPeakRss();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    std::unique_ptr<input> song(IFACTORY->get(backend, file));
+    if (!song)
+        return false;
+
+    const qint64 openNs = timer.nsecsElapsed();
+
+    const unsigned int frameSize = song->channels() * sampleSize(song->precision());
+    if ((frameSize == 0) || (song->samplerate() == 0))
+        return false;
+
+    QByteArray buffer(CHUNK_FRAMES * frameSize, 0);
+    const quint64 maxBytes = static_cast<quint64>(song->samplerate()) * frameSize * opt.seconds;
+
+    std::vector<qint64> calls;
+    calls.reserve(maxBytes / buffer.size() + 1);
+
+    quint64 total = 0;
+    qint64 firstSampleNs = -1;
+    QElapsedTimer call;
+    while (total < maxBytes)
+    {
+        call.start();
+        const size_t n = song->fillBuffer(buffer.data(), buffer.size());
+        const qint64 elapsed = call.nsecsElapsed();
+        if (n == 0)
+            break;
+
+        calls.push_back(elapsed);
+        if (firstSampleNs < 0)
+            firstSampleNs = timer.nsecsElapsed();
+        total += n;
+    }
+
+    const qint64 decodeNs = timer.nsecsElapsed() - openNs;
+
+    std::sort(calls.begin(), calls.end());
+
+    result.backend = IFACTORY->name(backend);
+    result.file = QFileInfo(file).fileName();
+    result.audioSecs = static_cast<double>(total) / frameSize / song->samplerate();
+    result.xRealtime = (decodeNs > 0) ? result.audioSecs * 1e9 / decodeNs : 0.;
+    result.firstSampleMs = (firstSampleNs < 0) ? -1. : firstSampleNs / 1e6;
+    result.p50Us = percentile(calls, 0.50) / 1e3;
+    result.p99Us = percentile(calls, 0.99) / 1e3;
+    result.maxUs = calls.empty() ? 0. : calls.back() / 1e3;
+    result.peakRssKiB = peakRss();
+    return true;
+}
+
+/// Convert a float sweep to the given input sample type
+QByteArray makeSource(sample_t type, unsigned int sampleRate, unsigned int channels)
+{
+    std::vector<float> sweep(sampleRate * channels);
+    fixtures::sweep(sweep.data(), sampleRate, channels, sampleRate);
+
+    QByteArray data(sweep.size() * sampleSize(type), 0);
+    for (size_t i = 0; i < sweep.size(); i++)
+    {
+        const float s = sweep[i];
+        switch (type)
+        {
+        case sample_t::U8:
+            reinterpret_cast<unsigned char*>(data.data())[i] = static_cast<unsigned char>(s * 127.f + 128.f);
+            break;
+        case sample_t::S16:
+            reinterpret_cast<short*>(data.data())[i] = static_cast<short>(s * 32767.f);
+            break;
+        case sample_t::SAMPLE_FLOAT:
+            reinterpret_cast<float*>(data.data())[i] = s;
+            break;
+        case sample_t::SAMPLE_FIXED:
+            reinterpret_cast<int*>(data.data())[i] = static_cast<int>(s * (1 << FIXED_FRACT));
+            break;
+        default:
+            break;
+        }
+    }
+    return data;
+}
+
+/// Run a single converter for opt.seconds of output audio
+bool benchConverter(audioFormat_t in, audioFormat_t out, resampler_t quality, bool noiseShaping,
+    const options_t& opt, converterResult_t& result)
+{
+    std::unique_ptr<converter> conv(CFACTORY->get(in, out, FIXED_FRACT, quality, noiseShaping));
+    if (!conv)
+        return false;
+
+    const QByteArray data = makeSource(in.sampleType, in.sampleRate, in.channels);
+    const std::string_view source(data.constData(), data.size());
+    const size_t outFrameSize = out.channels * sampleSize(out.sampleType);
+    QByteArray buffer(CHUNK_FRAMES * outFrameSize, 0);
+
+    const quint64 target = static_cast<quint64>(out.sampleRate) * outFrameSize * opt.seconds;
+    quint64 produced = 0;
+    qint64 convertNs = 0;
+    size_t srcPos = 0;
+    int stalls = 0;
+
+    QElapsedTimer timer;
+    while (produced < target)
+    {
+        const size_t size = conv->bufSize(buffer.size());
+
+        // feed the converter cycling over the source
+        char* dst = conv->buffer();
+        size_t left = size;
+        while (left > 0)
+        {
+            const size_t chunk = std::min(left, source.size() - srcPos);
+            std::memcpy(dst, source.data() + srcPos, chunk);
+            dst += chunk;
+            left -= chunk;
+            srcPos = (srcPos + chunk) % source.size();
+        }
+
+        timer.start();
+        const size_t n = conv->convert(buffer.data(), size);
+        convertNs += timer.nsecsElapsed();
+        if (n == 0)
+        {
+            // a resampler may need more than one chunk to prime
+            if (++stalls > 16)
+                return false;
+            continue;
+        }
+
+        stalls = 0;
+        produced += n;
+    }
+
+    const double frames = static_cast<double>(produced) / outFrameSize;
+
+    result.name = QString("%1 %2 -> %3 %4")
+        .arg(sampleName(in.sampleType)).arg(in.sampleRate)
+        .arg(sampleName(out.sampleType)).arg(out.sampleRate);
+    if (in.sampleRate != out.sampleRate)
+        result.name.append(' ').append(qualityName(quality));
+    if (noiseShaping)
+        result.name.append(" shaped");
+    result.xRealtime = (convertNs > 0) ? frames / out.sampleRate * 1e9 / convertNs : 0.;
+    result.nsPerFrame = convertNs / frames;
+    return true;
+}
+
+/// Run every DSP node on opt.seconds of stereo float audio
+std::vector<dspChain::stats_t> benchDsp(const options_t& opt, quint64& frames)
+{
+    constexpr unsigned int rate = DSP_RATE;
+
+    equalizer::bands_t bands;
+    static const float freqs[EQ_BANDS] = { 62.f, 125.f, 250.f, 500.f, 1000.f, 2000.f, 4000.f, 12000.f };
+    for (int i=0; i<EQ_BANDS; i++)
+        bands[i] = { freqs[i], (i % 2) ? 3.f : -3.f, 1.f };
+
+    dspChain chain;
+    chain.add(new preamp(-3.f));
+    chain.add(new equalizer(bands));
+    chain.add(new crossfeed());
+    chain.add(new limiter(-1.f));
+    chain.init(rate, 2);
+
+    const QByteArray data = makeSource(sample_t::SAMPLE_FLOAT, rate, 2);
+    const size_t sourceFrames = data.size() / (2 * sizeof(float));
+    std::vector<float> buffer(CHUNK_FRAMES * 2);
+
+    const quint64 target = static_cast<quint64>(rate) * opt.seconds;
+    size_t srcPos = 0;
+    while (chain.frames() < target)
+    {
+        const size_t chunk = std::min(CHUNK_FRAMES, sourceFrames - srcPos);
+        std::memcpy(buffer.data(), data.constData() + srcPos * 2 * sizeof(float), chunk * 2 * sizeof(float));
+        srcPos = (srcPos + chunk) % sourceFrames;
+
+        chain.process(buffer.data(), chunk);
+    }
+
+    frames = chain.frames();
+    std::vector<dspChain::stats_t> stats = chain.stats();
+
+    // the loudness meter only reads the signal, it is timed on its own
+    loudnessMeter meter(rate, 2);
+    QElapsedTimer timer;
+    timer.start();
+    for (quint64 done=0; done<frames; )
+    {
+        const size_t chunk = std::min<quint64>(sourceFrames, frames - done);
+        meter.process(reinterpret_cast<const float*>(data.constData()), chunk);
+        done += chunk;
+    }
+    stats.push_back({ "Loudness meter", 0, static_cast<quint64>(timer.nsecsElapsed()) });
+
+    return stats;
+}
+
+/*****************************************************************/
+
+/// Play the files in order through the engine as the player does
+bool benchPipeline(const QStringList& files, const options_t& opt, pipelineResult_t& result)
+{
+    std::vector<std::shared_ptr<input>> songs;
+    for (const QString& file: files)
+    {
+        std::shared_ptr<input> song(IFACTORY->get(file));
+        if (song && !song->songLoaded().isEmpty())
+            songs.push_back(std::move(song));
+    }
+    if (songs.empty())
+        return false;
+
+    // the engine owns the sink
+    nullBackend* sink = opt.outputFile.isEmpty()
+        ? new nullBackend(opt.realtime)
+        : new fileBackend(opt.outputFile);
+    audio engine(sink);
+
+    result.songs = 0;
+    result.gapless = 0;
+    result.audioSecs = 0.;
+    result.underruns = 0;
+    result.minFillMs = UINT_MAX;
+
+    size_t current = 0;
+    bool preloaded = false;
+    QEventLoop loop;
+
+    // counters are lost when the engine stops
+    auto collect = [&]() {
+        result.underruns += engine.underruns();
+        result.minFillMs = std::min(result.minFillMs, engine.minFill());
+    };
+    auto stop = [&]() {
+        collect();
+        engine.stop();
+        result.audioSecs += static_cast<double>(sink->frames()) / sink->format().sampleRate;
+    };
+    auto play = [&]() {
+        try
+        {
+            engine.play(songs[current].get());
+            result.songs++;
+            return true;
+        }
+        catch (audio::initError const &e)
+        {
+            qWarning() << "Cannot play" << songs[current]->songLoaded() << e.message();
+            return false;
+        }
+    };
+
+    QObject::connect(&engine, &audio::preloadSong, [&]() {
+        preloaded = (current + 1 < songs.size()) && engine.gapless(songs[current + 1]);
+        if (!preloaded)
+            engine.unload();
+    });
+    QObject::connect(&engine, &audio::songEnded, [&]() {
+        current++;
+        if (preloaded && (current < songs.size()))
+        {
+            preloaded = false;
+            result.songs++;
+            result.gapless++;
+            return;
+        }
+
+        stop();
+        // a song that fails to open is skipped like in the playlist
+        while ((current < songs.size()) && !play())
+            current++;
+        if (current >= songs.size())
+            loop.quit();
+    });
+
+    QElapsedTimer timer;
+    timer.start();
+
+    while ((current < songs.size()) && !play())
+        current++;
+    if (current < songs.size())
+        loop.exec();
+    if (engine.state() != state_t::STOP)
+        stop();
+
+    const double wallSecs = timer.nsecsElapsed() / 1e9;
+    result.xRealtime = result.audioSecs / wallSecs;
+    if (result.minFillMs == UINT_MAX)
+        result.minFillMs = 0;
+
+    return result.songs > 0;
+}
+
+/*****************************************************************/
+
+QStringList collectFiles(const QStringList& paths)
+{
+    QStringList files;
+    for (const QString& path: paths)
+    {
+        const QFileInfo info(path);
+        if (info.isDir())
+        {
+            QDirIterator it(path, QDir::Files, QDirIterator::Subdirectories);
+            while (it.hasNext())
+                files.append(it.next());
+        }
+        else if (info.isFile())
+        {
+            files.append(info.absoluteFilePath());
+        }
+        else
+        {
+            qWarning() << "Skipping" << path;
+        }
+    }
+    return files;
+}
+} // namespace
+
+/*****************************************************************/
+
+int main(int argc, char *argv[])
+{
+    // no windows are ever shown, don't require a display
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QGuiApplication app(argc, argv);
+
+    // separate application name so backends run with default settings
+    app.setOrganizationName("MusiQt");
+    app.setApplicationName("musiqt-bench");
+    app.setApplicationVersion(PACKAGE_VERSION);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Benchmark musiqt input backends and converters");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("paths", "Additional files or directories to decode", "[paths...]");
+
+    const QCommandLineOption secondsOption(QStringList() << "s" << "seconds",
+        "Seconds of audio to process per run (default 30).", "seconds", "30");
+    const QCommandLineOption noFixturesOption("no-fixtures", "Don't generate synthetic fixtures.");
+    const QCommandLineOption noInputsOption("no-inputs", "Skip the input backends benchmark.");
+    const QCommandLineOption noConvertersOption("no-converters", "Skip the converters benchmark.");
+    const QCommandLineOption noDspOption("no-dsp", "Skip the DSP benchmark.");
+    const QCommandLineOption noPipelineOption("no-pipeline", "Skip the playback pipeline benchmark.");
+    const QCommandLineOption realtimeOption("realtime", "Read the pipeline output at the rate of a sound card.");
+    const QCommandLineOption outputOption(QStringList() << "o" << "output",
+        "Write the pipeline output to a file, WAV if it ends in .wav or raw otherwise.", "file");
+    const QCommandLineOption jsonOption("json", "Print results as JSON.");
+    const QCommandLineOption verboseOption(QStringList() << "v" << "verbose", "Show engine log messages.");
+    parser.addOption(secondsOption);
+    parser.addOption(noFixturesOption);
+    parser.addOption(noInputsOption);
+    parser.addOption(noConvertersOption);
+    parser.addOption(noDspOption);
+    parser.addOption(noPipelineOption);
+    parser.addOption(realtimeOption);
+    parser.addOption(outputOption);
+    parser.addOption(jsonOption);
+    parser.addOption(verboseOption);
+    parser.process(app);
+
+    if (!parser.isSet(verboseOption))
+        QLoggingCategory::setFilterRules("*.debug=false\n*.info=false");
+
+    options_t opt;
+    opt.seconds = std::max(1u, parser.value(secondsOption).toUInt());
+    opt.inputs = !parser.isSet(noInputsOption);
+    opt.converters = !parser.isSet(noConvertersOption);
+    opt.dsp = !parser.isSet(noDspOption);
+    opt.pipeline = !parser.isSet(noPipelineOption);
+    opt.realtime = parser.isSet(realtimeOption);
+    opt.outputFile = parser.value(outputOption);
+
+    {
+        QSettings appSettings;
+        SETTINGS->load(appSettings);
+    }
+
+    QTemporaryDir fixtureDir;
+    QStringList corpus;
+    if ((opt.inputs || opt.pipeline) && !parser.isSet(noFixturesOption))
+    {
+        if (fixtureDir.isValid())
+            corpus.append(fixtures::create(fixtureDir.path(), opt.seconds));
+        else
+            qWarning() << "Cannot create fixtures directory";
+    }
+    corpus.append(collectFiles(parser.positionalArguments()));
+
+    QTextStream out(stdout);
+    QJsonArray jsonInputs;
+    QJsonArray jsonConverters;
+    QJsonArray jsonDsp;
+    QJsonObject jsonPipeline;
+    QStringList untested;
+
+    const bool json = parser.isSet(jsonOption);
+
+    if (opt.inputs)
+    {
+        if (!json)
+        {
+            out << QString("%1 %2 %3 %4 %5 %6 %7 %8\n")
+                .arg("backend", -10).arg("file", -24).arg("audio s", 8).arg("x rt", 9)
+                .arg("first ms", 9).arg("p50 us", 9).arg("p99 us", 9).arg("peak KiB", 9);
+            out.flush();
+        }
+
+        for (int i = 0; i < IFACTORY->num(); i++)
+        {
+            QStringList exts = IFACTORY->getExtensions(i);
+            for (QString& ext: exts)
+                ext = ext.toLower();
+
+            bool tested = false;
+            for (const QString& file: corpus)
+            {
+                if (!exts.contains(QFileInfo(file).suffix().toLower()))
+                    continue;
+
+                inputResult_t r;
+                if (!benchInput(i, file, opt, r))
+                    continue;
+
+                tested = true;
+                if (json)
+                {
+                    QJsonObject o;
+                    o.insert("backend", r.backend);
+                    o.insert("file", r.file);
+                    o.insert("audioSeconds", r.audioSecs);
+                    o.insert("xRealtime", r.xRealtime);
+                    o.insert("firstSampleMs", r.firstSampleMs);
+                    o.insert("p50Us", r.p50Us);
+                    o.insert("p99Us", r.p99Us);
+                    o.insert("maxUs", r.maxUs);
+                    o.insert("peakRssKiB", static_cast<qint64>(r.peakRssKiB));
+                    jsonInputs.append(o);
+                }
+                else
+                {
+                    out << QString("%1 %2 %3 %4 %5 %6 %7 %8\n")
+                        .arg(r.backend, -10).arg(r.file.left(24), -24)
+                        .arg(r.audioSecs, 8, 'f', 1).arg(r.xRealtime, 9, 'f', 1)
+                        .arg(r.firstSampleMs, 9, 'f', 2).arg(r.p50Us, 9, 'f', 1)
+                        .arg(r.p99Us, 9, 'f', 1).arg(r.peakRssKiB, 9);
+                    out.flush();
+                }
+            }
+
+            if (!tested)
+                untested.append(IFACTORY->name(i));
+        }
+
+        if (!json && !untested.isEmpty())
+            out << "\nNo file decoded by: " << untested.join(", ") << "\n";
+    }
+
+    if (opt.converters)
+    {
+        static const sample_t inTypes[] = { sample_t::U8, sample_t::S16, sample_t::SAMPLE_FLOAT, sample_t::SAMPLE_FIXED };
+        static const sample_t outTypes[] = { sample_t::U8, sample_t::S16, sample_t::SAMPLE_FLOAT };
+        static const unsigned int rates[][2] = { { 44100, 44100 }, { 44100, 48000 }, { 48000, 44100 } };
+        static const resampler_t qualities[] = { resampler_t::Fast, resampler_t::Medium, resampler_t::Best };
+
+        if (!json)
+        {
+            out << QString("\n%1 %2 %3\n").arg("converter", -34).arg("x rt", 10).arg("ns/frame", 9);
+            out.flush();
+        }
+
+        for (const sample_t inType: inTypes)
+        {
+            for (const sample_t outType: outTypes)
+            {
+                for (const auto& rate: rates)
+                {
+                    const audioFormat_t in { rate[0], 2, inType };
+                    const audioFormat_t outFormat { rate[1], 2, outType };
+
+                    for (const resampler_t quality: qualities)
+                    for (const bool noiseShaping: { false, true })
+                    {
+                        // quality only matters when resampling
+                        if ((rate[0] == rate[1]) && (quality != resampler_t::Medium))
+                            continue;
+                        // noise shaping only when reducing bitdepth, once per pair
+                        if (noiseShaping && ((quality != resampler_t::Medium) || (outType == sample_t::SAMPLE_FLOAT)
+                                || (inType == sample_t::U8) || (inType == sample_t::S16)))
+                            continue;
+
+                        converterResult_t r;
+                        if (!benchConverter(in, outFormat, quality, noiseShaping, opt, r))
+                            continue;
+
+                        if (json)
+                        {
+                            QJsonObject o;
+                            o.insert("converter", r.name);
+                            o.insert("xRealtime", r.xRealtime);
+                            o.insert("nsPerFrame", r.nsPerFrame);
+                            jsonConverters.append(o);
+                        }
+                        else
+                        {
+                            out << QString("%1 %2 %3\n")
+                                .arg(r.name, -34).arg(r.xRealtime, 10, 'f', 1).arg(r.nsPerFrame, 9, 'f', 2);
+                            out.flush();
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if (opt.dsp)
+    {
+        if (!json)
+        {
+            out << QString("\n%1 %2 %3 %4\n").arg("dsp node", -34).arg("% cpu", 10).arg("ns/frame", 9).arg("latency", 8);
+            out.flush();
+        }
+
+        quint64 frames;
+        const std::vector<dspChain::stats_t> stats = benchDsp(opt, frames);
+        const double audioNs = frames * 1e9 / DSP_RATE;
+        for (const dspChain::stats_t& s: stats)
+        {
+            const double cpu = 100. * s.nanoSeconds / audioNs;
+            const double nsPerFrame = static_cast<double>(s.nanoSeconds) / frames;
+            if (json)
+            {
+                QJsonObject o;
+                o.insert("node", s.name);
+                o.insert("cpuPercent", cpu);
+                o.insert("nsPerFrame", nsPerFrame);
+                o.insert("latency", static_cast<int>(s.latency));
+                jsonDsp.append(o);
+            }
+            else
+            {
+                out << QString("%1 %2 %3 %4\n")
+                    .arg(s.name, -34).arg(cpu, 10, 'f', 3).arg(nsPerFrame, 9, 'f', 2).arg(s.latency, 8);
+            }
+        }
+        out.flush();
+    }
+
+    if (opt.pipeline)
+    {
+        pipelineResult_t r;
+        if (benchPipeline(corpus, opt, r))
+        {
+            if (json)
+            {
+                jsonPipeline.insert("songs", r.songs);
+                jsonPipeline.insert("gapless", r.gapless);
+                jsonPipeline.insert("audioSeconds", r.audioSecs);
+                jsonPipeline.insert("xRealtime", r.xRealtime);
+                jsonPipeline.insert("underruns", static_cast<int>(r.underruns));
+                jsonPipeline.insert("minFillMs", static_cast<int>(r.minFillMs));
+            }
+            else
+            {
+                out << QString("\n%1 %2 %3 %4 %5 %6\n").arg("pipeline", -10).arg("songs", 6).arg("gapless", 8)
+                    .arg("audio s", 8).arg("x rt", 9).arg("underruns", 10);
+                out << QString("%1 %2 %3 %4 %5 %6\n").arg(opt.realtime ? "realtime" : "fast", -10)
+                    .arg(r.songs, 6).arg(r.gapless, 8).arg(r.audioSecs, 8, 'f', 1)
+                    .arg(r.xRealtime, 9, 'f', 1).arg(r.underruns, 10);
+                out.flush();
+            }
+        }
+    }
+
+    if (json)
+    {
+        QJsonObject root;
+        root.insert("seconds", static_cast<int>(opt.seconds));
+        root.insert("inputs", jsonInputs);
+        root.insert("converters", jsonConverters);
+        root.insert("dsp", jsonDsp);
+        root.insert("pipeline", jsonPipeline);
+        root.insert("untested", QJsonArray::fromStringList(untested));
+        out << QJsonDocument(root).toJson();
+    }
+
+    return 0;
+}
@@ -0,0 +1,359 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "fixtures.h"
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#ifdef HAVE_SNDFILE
+#  include <sndfile.h>
+#endif
+
+#include <QByteArray>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+constexpr unsigned int CHANNELS = 2;
+
+constexpr double PI = 3.14159265358979323846;
+
+void put8(QByteArray& data, quint8 val)
+{
+    data.append(static_cast<char>(val));
+}
+
+void put16le(QByteArray& data, quint16 val)
+{
+    char buf[2];
+    qToLittleEndian(val, buf);
+    data.append(buf, 2);
+}
+
+void put32le(QByteArray& data, quint32 val)
+{
+    char buf[4];
+    qToLittleEndian(val, buf);
+    data.append(buf, 4);
+}
+
+void put16be(QByteArray& data, quint16 val)
+{
+    char buf[2];
+    qToBigEndian(val, buf);
+    data.append(buf, 2);
+}
+
+void put32be(QByteArray& data, quint32 val)
+{
+    char buf[4];
+    qToBigEndian(val, buf);
+    data.append(buf, 4);
+}
+
+void putString(QByteArray& data, const char* str, int len)
+{
+    QByteArray s(str);
+    s.resize(len);
+    data.append(s);
+}
+
+bool writeFile(const QString& fileName, const QByteArray& data)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        qWarning() << "Cannot write" << fileName;
+        return false;
+    }
+    return file.write(data) == data.size();
+}
+
+/*****************************************************************/
+
+/// Canonical RIFF WAVE, 16 bit integer or 32 bit float
+bool writeWav(const QString& fileName, unsigned int sampleRate, unsigned int seconds, bool isFloat)
+{
+    const unsigned int frames = sampleRate * seconds;
+    std::vector<float> samples(frames * CHANNELS);
+    fixtures::sweep(samples.data(), frames, CHANNELS, sampleRate);
+
+    const quint16 bytesPerSample = isFloat ? 4 : 2;
+    const quint32 dataSize = samples.size() * bytesPerSample;
+
+    QByteArray data;
+    data.reserve(44 + dataSize);
+    data.append("RIFF");
+    put32le(data, 36 + dataSize);
+    data.append("WAVE");
+    data.append("fmt ");
+    put32le(data, 16);
+    put16le(data, isFloat ? 3 : 1); // WAVE_FORMAT_IEEE_FLOAT : WAVE_FORMAT_PCM
+    put16le(data, CHANNELS);
+    put32le(data, sampleRate);
+    put32le(data, sampleRate * CHANNELS * bytesPerSample);
+    put16le(data, CHANNELS * bytesPerSample);
+    put16le(data, bytesPerSample * 8);
+    data.append("data");
+    put32le(data, dataSize);
+
+    for (float sample: samples)
+    {
+        if (isFloat)
+        {
+            quint32 bits;
+            std::memcpy(&bits, &sample, sizeof(bits));
+            put32le(data, bits);
+        }
+        else
+        {
+            put16le(data, static_cast<qint16>(std::lround(sample * 32767.f)));
+        }
+    }
+
+    return writeFile(fileName, data);
+}
+
+#ifdef HAVE_SNDFILE
+/// Encode the sweep through libsndfile, if the format is available
+bool writeSnd(const QString& fileName, int format, unsigned int sampleRate, unsigned int seconds)
+{
+    SF_INFO si;
+    si.samplerate = sampleRate;
+    si.channels = CHANNELS;
+    si.format = format;
+    if (!sf_format_check(&si))
+        return false;
+
+    SNDFILE* sf = sf_open(QFile::encodeName(fileName).constData(), SFM_WRITE, &si);
+    if (sf == nullptr)
+    {
+        qWarning() << "Cannot write" << fileName << sf_strerror(nullptr);
+        return false;
+    }
+
+    const unsigned int frames = sampleRate * seconds;
+    std::vector<float> samples(frames * CHANNELS);
+    fixtures::sweep(samples.data(), frames, CHANNELS, sampleRate);
+
+    const bool ok = sf_writef_float(sf, samples.data(), frames) == static_cast<sf_count_t>(frames);
+    sf_close(sf);
+    return ok;
+}
+#endif
+
+/// Standard MIDI file, format 0, chromatic scale
+bool writeMidi(const QString& fileName, unsigned int seconds)
+{
+    // 480 ppq at the default 120 bpm, eighth notes last 0.25 seconds
+    constexpr quint16 PPQ = 480;
+    const unsigned int notes = seconds * 4;
+
+    QByteArray track;
+    // program change, acoustic grand piano
+    put8(track, 0x00);
+    put8(track, 0xC0);
+    put8(track, 0x00);
+    for (unsigned int i = 0; i < notes; i++)
+    {
+        const quint8 note = 36 + (i % 61);
+        put8(track, 0x00);
+        put8(track, 0x90);
+        put8(track, note);
+        put8(track, 100);
+        // delta time 240 as variable length quantity
+        put8(track, 0x81);
+        put8(track, 0x70);
+        put8(track, 0x80);
+        put8(track, note);
+        put8(track, 0x00);
+    }
+    // end of track
+    put8(track, 0x00);
+    put8(track, 0xFF);
+    put8(track, 0x2F);
+    put8(track, 0x00);
+
+    QByteArray data;
+    data.append("MThd");
+    put32be(data, 6);
+    put16be(data, 0);
+    put16be(data, 1);
+    put16be(data, PPQ);
+    data.append("MTrk");
+    put32be(data, track.size());
+    data.append(track);
+
+    return writeFile(fileName, data);
+}
+
+/// ProTracker module, one looped sine sample playing a scale
+bool writeMod(const QString& fileName, unsigned int seconds)
+{
+    static const quint16 periods[] =
+    {
+        856, 808, 762, 720, 678, 640, 604, 570, 538, 508, 480, 453,
+        428, 404, 381, 360, 339, 320, 302, 285, 269, 254, 240, 226,
+        214, 202, 190, 180, 170, 160, 151, 143, 135, 127, 120, 113
+    };
+    constexpr int NUM_PERIODS = sizeof(periods)/sizeof(periods[0]);
+    constexpr int SAMPLE_LEN = 32;
+    constexpr int ROWS = 64;
+
+    QByteArray data;
+    putString(data, "musiqt-bench", 20);
+
+    putString(data, "sine", 22);
+    put16be(data, SAMPLE_LEN / 2);
+    put8(data, 0);  // finetune
+    put8(data, 64); // volume
+    put16be(data, 0);
+    put16be(data, SAMPLE_LEN / 2);
+    for (int i = 1; i < 31; i++)
+    {
+        putString(data, "", 22);
+        put16be(data, 0);
+        put8(data, 0);
+        put8(data, 0);
+        put16be(data, 0);
+        put16be(data, 1);
+    }
+
+    // at speed 6 and 125 bpm a pattern lasts 7.68 seconds
+    const int orders = std::clamp(static_cast<int>(std::ceil(seconds / 7.68)), 1, 128);
+    put8(data, orders);
+    put8(data, 127);
+    for (int i = 0; i < 128; i++)
+        put8(data, 0);
+    data.append("M.K.");
+
+    for (int row = 0; row < ROWS; row++)
+    {
+        const quint16 period = periods[row % NUM_PERIODS];
+        put8(data, period >> 8);
+        put8(data, period & 0xFF);
+        put8(data, 1 << 4);
+        put8(data, 0);
+        for (int ch = 1; ch < 4; ch++)
+            put32be(data, 0);
+    }
+
+    for (int i = 0; i < SAMPLE_LEN; i++)
+        put8(data, static_cast<qint8>(std::lround(std::sin(2. * PI * i / SAMPLE_LEN) * 127.)));
+
+    return writeFile(fileName, data);
+}
+
+/// PSID v2, a triangle wave sweeping up every frame
+bool writeSid(const QString& fileName)
+{
+    static const quint8 code[] =
+    {
+        // init at $1000
+        0xA9, 0x0F, 0x8D, 0x18, 0xD4, // lda #$0f, sta $d418 ; volume
+        0xA9, 0x00, 0x8D, 0x05, 0xD4, // lda #$00, sta $d405 ; attack/decay
+        0xA9, 0xF0, 0x8D, 0x06, 0xD4, // lda #$f0, sta $d406 ; sustain/release
+        0xA9, 0x25, 0x8D, 0x00, 0xD4, // lda #$25, sta $d400 ; freq lo
+        0xA9, 0x11, 0x8D, 0x01, 0xD4, // lda #$11, sta $d401 ; freq hi
+        0xA9, 0x11, 0x8D, 0x04, 0xD4, // lda #$11, sta $d404 ; triangle, gate
+        0x60,                         // rts
+        // play at $101f
+        0xEE, 0x01, 0xD4,             // inc $d401
+        0x60                          // rts
+    };
+    constexpr quint16 INIT = 0x1000;
+    constexpr quint16 PLAY = 0x101F;
+
+    QByteArray data;
+    data.append("PSID");
+    put16be(data, 2);      // version
+    put16be(data, 0x7C);   // data offset
+    put16be(data, 0);      // load address from data
+    put16be(data, INIT);
+    put16be(data, PLAY);
+    put16be(data, 1);      // songs
+    put16be(data, 1);      // start song
+    put32be(data, 0);      // speed, vblank
+    putString(data, "Sweep", 32);
+    putString(data, "musiqt-bench", 32);
+    putString(data, "2026", 32);
+    put16be(data, 0);      // flags
+    put8(data, 0);         // start page
+    put8(data, 0);         // page length
+    put8(data, 0);         // second SID
+    put8(data, 0);         // third SID
+    put16le(data, INIT);   // load address
+    data.append(reinterpret_cast<const char*>(code), sizeof(code));
+
+    return writeFile(fileName, data);
+}
+} // namespace
+
+/*****************************************************************/
+
+void fixtures::sweep(float* buffer, unsigned int frames, unsigned int channels,
+    unsigned int sampleRate)
+{
+    constexpr double F0 = 20.;
+    constexpr double F1 = 20000.;
+    const double duration = static_cast<double>(frames) / sampleRate;
+    const double k = std::log(F1 / F0);
+
+    for (unsigned int i = 0; i < frames; i++)
+    {
+        const double t = static_cast<double>(i) / sampleRate;
+        const double phase = 2. * PI * F0 * duration / k * (std::exp(t * k / duration) - 1.);
+        const float sample = static_cast<float>(0.5 * std::sin(phase));
+        for (unsigned int ch = 0; ch < channels; ch++)
+            *buffer++ = sample;
+    }
+}
+
+QStringList fixtures::create(const QString& dir, unsigned int seconds)
+{
+    const QDir d(dir);
+    QStringList files;
+
+    auto add = [&files, &d](const char* name, bool ok)
+    {
+        if (ok)
+            files.append(d.filePath(name));
+    };
+
+    add("sweep-s16-44100.wav", writeWav(d.filePath("sweep-s16-44100.wav"), 44100, seconds, false));
+    add("sweep-f32-48000.wav", writeWav(d.filePath("sweep-f32-48000.wav"), 48000, seconds, true));
+#ifdef HAVE_SNDFILE
+    add("sweep-44100.flac", writeSnd(d.filePath("sweep-44100.flac"), SF_FORMAT_FLAC | SF_FORMAT_PCM_16, 44100, seconds));
+    add("sweep-44100.ogg", writeSnd(d.filePath("sweep-44100.ogg"), SF_FORMAT_OGG | SF_FORMAT_VORBIS, 44100, seconds));
+#endif
+    add("scale.mid", writeMidi(d.filePath("scale.mid"), seconds));
+    add("scale.mod", writeMod(d.filePath("scale.mod"), seconds));
+    add("sweep.sid", writeSid(d.filePath("sweep.sid")));
+
+    return files;
+}
@@ -0,0 +1,38 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef FIXTURES_H
+#define FIXTURES_H
+
+#include <QStringList>
+
+/**
+ * Synthetic test files, generated on the fly
+ * so the benchmark can run without a music corpus
+ */
+namespace fixtures
+{
+    /// Fill buffer with a 20Hz-20kHz logarithmic sweep at -6dBFS
+    void sweep(float* buffer, unsigned int frames, unsigned int channels,
+        unsigned int sampleRate);
+
+    /// Write all the fixtures into dir, return the created files
+    QStringList create(const QString& dir, unsigned int seconds);
+}
+
+#endif
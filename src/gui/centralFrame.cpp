@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2013-2023 Leandro Nini
+ *  Copyright (C) 2013-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -25,6 +25,9 @@
 #include "proxymodel.h"
 #include "inputConfig.h"
 #include "inputFactory.h"
+#include "libraryScanner.h"
+#include "loudnessScanner.h"
+#include "metaDataStore.h"
 #include "settings.h"
 #include "trackListFactory.h"
 #include "utils.h"
@@ -96,6 +99,24 @@ centralFrame::centralFrame(player* p, QWidget *parent) :
     m_playlist->setDragDropMode(QAbstractItemView::DropOnly);
 
     m_playlistModel = new playlistModel(this);
+    m_playlistModel->setMetaFetcher(
+        [this](int row, const QString& path)
+        {
+            // Don't change the model while it's being queried
+            QMetaObject::invokeMethod(this,
+                [this, row, path]()
+                {
+                    songInfo_t info;
+                    if ((row < m_playlistModel->rowCount())
+                        && (m_playlistModel->path(row) == path)
+                        && MDSTORE->lookup(path, info))
+                    {
+                        m_playlistModel->setMetaData(row, info.title, info.artist, info.duration, info.backend);
+                    }
+                },
+                Qt::QueuedConnection);
+        }
+    );
 
     m_proxyModel = new proxymodel(this);
     m_proxyModel->setSourceModel(m_playlistModel);
@@ -106,7 +127,7 @@ centralFrame::centralFrame(player* p, QWidget *parent) :
     m_proxyModel->setFilterRegularExpression(QRegularExpression(
         QRegularExpression::anchoredPattern(getFilter()),
         QRegularExpression::CaseInsensitiveOption));
-    m_proxyModel->setFilterRole(Qt::UserRole+1);
+    m_proxyModel->setFilterRole(playlistModel::FileNameRole);
 
     selectionModel = m_playlist->selectionModel();
     connect(selectionModel, &QItemSelectionModel::currentRowChanged, this, &centralFrame::onCmdSongSelected);
@@ -115,6 +136,37 @@ centralFrame::centralFrame(player* p, QWidget *parent) :
     connect(m_proxyModel, &proxymodel::rowsInserted, this, &centralFrame::updateSongs);
     connect(m_proxyModel, &proxymodel::rowsRemoved, this, &centralFrame::updateSongs);
 
+    m_scanner = new libraryScanner(this);
+    connect(m_scanner, &libraryScanner::progress,
+        [this](int done, int total, double filesPerSec)
+        {
+            emit statusMessage(tr("Indexing library: %1/%2 (%3 files/s)")
+                .arg(done).arg(total).arg(filesPerSec, 0, 'f', 1), 1000);
+        }
+    );
+    connect(m_scanner, &libraryScanner::finished,
+        [this](int files)
+        {
+            emit statusMessage(tr("Library indexed: %1 files").arg(files), 5000);
+            m_playlistModel->refreshMetaData();
+        }
+    );
+
+    m_analyzer = new loudnessScanner(this);
+    connect(m_analyzer, &loudnessScanner::progress,
+        [this](int done, int total, double filesPerSec)
+        {
+            emit statusMessage(tr("Analyzing loudness: %1/%2 (%3 files/s)")
+                .arg(done).arg(total).arg(filesPerSec, 0, 'f', 1), 1000);
+        }
+    );
+    connect(m_analyzer, &loudnessScanner::finished,
+        [this](int, int analyzed)
+        {
+            emit statusMessage(tr("Loudness analyzed: %1 files").arg(analyzed), 5000);
+        }
+    );
+
     m_playlist->setContextMenuPolicy(Qt::CustomContextMenu);
     connect(m_playlist, &playlist::customContextMenuRequested, this, &centralFrame::onRgtClkPlayList);
 
@@ -208,8 +260,13 @@ centralFrame::centralFrame(player* p, QWidget *parent) :
     m_slider->setTracking(false);
     m_slider->setDisabled(true);
     connect(m_slider, &QSlider::actionTriggered,
-        [this]()
+        [this](int action)
         {
+            // While dragging only the release position is sought,
+            // each seek drops the buffered audio.
+            // The release itself triggers a last SliderMove
+            if ((action == QAbstractSlider::SliderMove) && m_slider->isSliderDown())
+                return;
             double pos = static_cast<double>(m_slider->sliderPosition())/100.;
             qDebug() << "seek:" << pos;
             m_player->setPosition(pos);
@@ -301,16 +358,11 @@ bool centralFrame::isPlaylistDirSelected()
 
 QModelIndex centralFrame::findItem(const QFileInfo& file)
 {
-    QModelIndexList items = m_proxyModel->match(
-        m_proxyModel->index(0, 0),
-        Qt::DisplayRole,
-        QVariant::fromValue(file.completeBaseName()),
-        1,
-        Qt::MatchExactly|Qt::MatchCaseSensitive);
-    if (!items.empty())
-        return items.at(0);
+    const int row = m_playlistModel->find(file.completeBaseName());
+    if (row < 0)
+        return QModelIndex();
 
-    return QModelIndex();
+    return m_proxyModel->mapFromSource(m_playlistModel->index(row, 0));
 }
 
 void centralFrame::onDirSelected(const QModelIndex& idx)
@@ -336,7 +388,7 @@ void centralFrame::onDirSelected(const QModelIndex& idx)
     if (tracklist.get() != nullptr)
         files = tracklist->load();
 
-    m_playlistModel->setStringList(files);
+    m_playlistModel->setFiles(files);
 
     if (m_proxyModel->rowCount() == 0)
     {
@@ -495,7 +547,7 @@ void centralFrame::onCmdSongLoaded(bool res)
         emit updateSlider(0);
 
         QString songLoaded = m_player->loadedSong();
-        const QString songSelected = m_proxyModel->data(m_playlist->currentIndex(), Qt::UserRole).toString();
+        const QString songSelected = m_proxyModel->data(m_playlist->currentIndex(), playlistModel::PathRole).toString();
         if (songLoaded != songSelected)
         {
             QFileInfo fileInfo(songLoaded);
@@ -529,12 +581,14 @@ void centralFrame::onCmdSongSelected(const QModelIndex& currentRow)
         return;
 
     QString songLoaded = m_player->loadedSong();
-    const QString song = m_proxyModel->data(currentRow, Qt::UserRole).toString();
+    const QString song = m_proxyModel->data(currentRow, playlistModel::PathRole).toString();
     if (!songLoaded.isEmpty() && (song == songLoaded))
         return;
 
     m_playlist->scrollTo(currentRow);
 
+    m_proxyModel->played(m_proxyModel->mapToSource(currentRow).row());
+
     if (m_player->tryPreload(song))
     {
         emit setDisplay();
@@ -572,7 +626,7 @@ void centralFrame::onPreloadSong()
         QModelIndex index = m_proxyModel->index(nextSong, 0);
         if (index.isValid())
         {
-            m_player->preload(m_proxyModel->data(index, Qt::UserRole).toString());
+            m_player->preload(m_proxyModel->data(index, playlistModel::PathRole).toString());
         }
     }
 }
@@ -608,6 +662,8 @@ void centralFrame::onSongEnded()
 void centralFrame::onSettingsChanged()
 {
     createHomeMenu();
+    updateLibraryScan();
+    updateLoudnessScan();
 
     QString songLoaded = m_player->loadedSong();
     if (!songLoaded.isEmpty())
@@ -668,7 +724,7 @@ void centralFrame::onRgtClkPlayList(const QPoint& pos)
         const int itemRow = item.row();
 
         QWidgetAction *wa = new QWidgetAction(&pane);
-        QLabel *label = new QLabel(utils::shrink(m_proxyModel->data(item, Qt::UserRole).toString()));
+        QLabel *label = new QLabel(utils::shrink(m_proxyModel->data(item, playlistModel::PathRole).toString()));
         label->setAlignment(Qt::AlignCenter);
         wa->setDefaultWidget(label);
         pane.addAction(wa);
@@ -769,10 +825,11 @@ void centralFrame::onCmdPlSave()
         return;
 
     tracks_t tracks;
-    for(int r = 0; r < m_proxyModel->rowCount(); ++r)
+    tracks.reserve(n);
+    for(int r = 0; r < n; ++r)
     {
-        QModelIndex idx = m_proxyModel->index(r, 0);
-        tracks.append(m_proxyModel->data(idx, Qt::UserRole+1).toString());
+        const int row = m_proxyModel->mapToSource(m_proxyModel->index(r, 0)).row();
+        tracks.append(m_playlistModel->fileName(row));
     }
     if (!tracklist->save(tracks))
         QMessageBox::critical(this, tr("Error"), tr("Error saving playlist"));
@@ -826,6 +883,50 @@ void centralFrame::init()
     m_fsm->setRootPath(QDir::rootPath());
 
     m_bookmarkList->load();
+
+    updateLibraryScan();
+    updateLoudnessScan();
+}
+
+QStringList centralFrame::musicDirs() const
+{
+    QStringList dirs = xdg::getMusicDirs();
+
+    for (int i=0; i<IFACTORY->num(); i++)
+    {
+        std::unique_ptr<inputConfig> ic(IFACTORY->getConfig(i));
+
+        QString musicDir = ic->getMusicDir();
+        if (!musicDir.isEmpty())
+            dirs.append(musicDir);
+    }
+
+    dirs.removeDuplicates();
+    return dirs;
+}
+
+void centralFrame::updateLibraryScan()
+{
+    const QStringList dirs = SETTINGS->scanLibrary() ? musicDirs() : QStringList();
+    if (dirs == m_scannedDirs)
+        return;
+
+    m_scanner->cancel();
+    m_scannedDirs = dirs;
+    if (!dirs.isEmpty())
+        m_scanner->scan(dirs);
+}
+
+void centralFrame::updateLoudnessScan()
+{
+    const QStringList dirs = (SETTINGS->replayGain() && SETTINGS->replayGainAnalyze()) ? musicDirs() : QStringList();
+    if (dirs == m_analyzedDirs)
+        return;
+
+    m_analyzer->cancel();
+    m_analyzedDirs = dirs;
+    if (!dirs.isEmpty())
+        m_analyzer->scan(dirs);
 }
 
 QString centralFrame::getFilter() const
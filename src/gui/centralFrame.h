@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2013-2025 Leandro Nini
+ *  Copyright (C) 2013-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -24,6 +24,8 @@
 #include <QWidget>
 
 class bookmark;
+class libraryScanner;
+class loudnessScanner;
 class playlist;
 class playlistModel;
 class proxymodel;
@@ -62,6 +64,7 @@ signals:
     void updateTime(int);
     void updateSlider(int);
     void songUpdated(const QString&);
+    void statusMessage(const QString&, int);
 
 public slots:
     void onCmdPlayPauseSong();
@@ -86,6 +89,9 @@ private:
     void updateSongs();
 
     void createHomeMenu();
+    QStringList musicDirs() const;
+    void updateLibraryScan();
+    void updateLoudnessScan();
     void onCmdChangeSong(dir_t);
     QString getFilter() const;
     QStringList getPattern() const;
@@ -111,6 +117,10 @@ private:
     QPushButton *m_editMode;
     QPushButton *m_home;
     QSlider *m_slider;
+    libraryScanner *m_scanner;
+    QStringList m_scannedDirs;
+    loudnessScanner *m_analyzer;
+    QStringList m_analyzedDirs;
 };
 
 #endif
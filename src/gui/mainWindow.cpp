@@ -28,6 +28,7 @@
 #include "infoDialog.h"
 #include "infoLabel.h"
 #include "settings.h"
+#include "settingsWindow.h"
 #include "timeDisplay.h"
 #include "centralFrame.h"
 #include "player.h"
@@ -100,6 +101,7 @@ mainWindow::mainWindow(player* p, QWidget *parent) :
 
     connect(m_cFrame, &centralFrame::setDisplay,   this, &mainWindow::setDisplay);
     connect(m_cFrame, &centralFrame::clearDisplay, this, &mainWindow::clearDisplay);
+    connect(m_cFrame, &centralFrame::statusMessage, statusBar(), &QStatusBar::showMessage);
 
     addToolBar(createControlBar());
     addToolBarBreak();
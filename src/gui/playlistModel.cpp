@@ -0,0 +1,293 @@
+/*
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "playlistModel.h"
+
+#include <QFileInfo>
+#include <QMimeData>
+#include <QUrl>
+#include <QDebug>
+
+int playlistModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_paths.size();
+}
+
+QVariant playlistModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || (index.row() >= m_paths.size()))
+        return QVariant();
+
+    const int row = index.row();
+
+    switch (role)
+    {
+    case Qt::DisplayRole:
+        return m_names.at(row);
+    case Qt::ToolTipRole:
+        {
+            const QString title = metaData(row, TitleRole).toString();
+            if (title.isEmpty())
+                return m_paths.at(row);
+            const QString artist = m_artists.at(row);
+            return QString("%1\n%2").arg(artist.isEmpty() ? title : QString("%1 - %2").arg(artist, title), m_paths.at(row));
+        }
+    case PathRole:
+        return m_paths.at(row);
+    case FileNameRole:
+        return m_fileNames.at(row);
+    case TitleRole:
+    case ArtistRole:
+    case DurationRole:
+    case BackendRole:
+        return metaData(row, role);
+    default:
+        return QVariant();
+    }
+}
+
+QVariant playlistModel::metaData(int row, int role) const
+{
+    if (m_metaState.isEmpty() || (m_metaState.at(row) != metaState::AVAILABLE))
+    {
+        if (m_fetcher && (m_metaState.isEmpty() || (m_metaState.at(row) == metaState::NONE)))
+        {
+            if (m_metaState.isEmpty())
+                m_metaState.fill(metaState::NONE, m_paths.size());
+            m_metaState[row] = metaState::REQUESTED;
+            m_fetcher(row, m_paths.at(row));
+        }
+        return QVariant();
+    }
+
+    switch (role)
+    {
+    case TitleRole:
+        return m_titles.at(row);
+    case ArtistRole:
+        return m_artists.at(row);
+    case DurationRole:
+        return m_durations.at(row);
+    case BackendRole:
+        return m_backends.at(row);
+    default:
+        return QVariant();
+    }
+}
+
+Qt::ItemFlags playlistModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid())
+        return QAbstractListModel::flags(index) | Qt::ItemIsDropEnabled;
+
+    return QAbstractListModel::flags(index) | Qt::ItemIsDropEnabled | Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemNeverHasChildren;
+}
+
+void playlistModel::allocMetaData()
+{
+    const int rows = m_paths.size();
+    if (m_metaState.size() != rows)
+        m_metaState.fill(metaState::NONE, rows);
+    if (m_titles.size() == rows)
+        return;
+
+    m_titles.reserve(rows);
+    m_artists.reserve(rows);
+    m_backends.reserve(rows);
+    for (int i=0; i<rows; i++)
+    {
+        m_titles.append(QString());
+        m_artists.append(QString());
+        m_backends.append(QString());
+    }
+    m_durations.fill(0, rows);
+}
+
+void playlistModel::insertEntries(int row, const QStringList& paths)
+{
+    if (paths.isEmpty())
+        return;
+
+    beginInsertRows(QModelIndex(), row, row + paths.size() - 1);
+
+    const bool hasMeta = !m_titles.isEmpty();
+    for (const QString& path: paths)
+    {
+        const QFileInfo location(path);
+        m_paths.insert(row, path);
+        m_names.insert(row, location.completeBaseName());
+        m_fileNames.insert(row, location.fileName());
+        if (!m_metaState.isEmpty())
+            m_metaState.insert(row, metaState::NONE);
+        if (hasMeta)
+        {
+            m_titles.insert(row, QString());
+            m_artists.insert(row, QString());
+            m_backends.insert(row, QString());
+            m_durations.insert(row, 0);
+        }
+        row++;
+    }
+
+    endInsertRows();
+}
+
+bool playlistModel::removeRows(int row, int count, const QModelIndex &parent)
+{
+    if (parent.isValid() || (count <= 0) || (row < 0) || ((row + count) > m_paths.size()))
+        return false;
+
+    beginRemoveRows(QModelIndex(), row, row + count - 1);
+
+    const auto removeFrom = [row, count](auto& list)
+    {
+        if (!list.isEmpty())
+            list.erase(list.begin() + row, list.begin() + row + count);
+    };
+
+    removeFrom(m_paths);
+    removeFrom(m_names);
+    removeFrom(m_fileNames);
+    removeFrom(m_titles);
+    removeFrom(m_artists);
+    removeFrom(m_backends);
+    removeFrom(m_durations);
+    removeFrom(m_metaState);
+
+    endRemoveRows();
+    return true;
+}
+
+void playlistModel::setFiles(const QStringList& files)
+{
+    beginResetModel();
+
+    m_paths = files;
+    m_names.clear();
+    m_fileNames.clear();
+    m_names.reserve(files.size());
+    m_fileNames.reserve(files.size());
+    for (const QString& file: files)
+    {
+        const QFileInfo location(file);
+        m_names.append(location.completeBaseName());
+        m_fileNames.append(location.fileName());
+    }
+
+    m_titles.clear();
+    m_artists.clear();
+    m_backends.clear();
+    m_durations.clear();
+    m_metaState.clear();
+
+    endResetModel();
+}
+
+void playlistModel::clear()
+{
+    setFiles(QStringList());
+}
+
+void playlistModel::append(const QString& file)
+{
+    insertEntries(m_paths.size(), QStringList(file));
+}
+
+void playlistModel::setMetaData(int row, const QString& title, const QString& artist, int duration, const QString& backend)
+{
+    if ((row < 0) || (row >= m_paths.size()))
+        return;
+
+    allocMetaData();
+
+    m_titles[row] = title;
+    m_artists[row] = artist;
+    m_durations[row] = duration;
+    m_backends[row] = backend;
+    m_metaState[row] = metaState::AVAILABLE;
+
+    const QModelIndex idx = index(row, 0);
+    emit dataChanged(idx, idx, {TitleRole, ArtistRole, DurationRole, BackendRole});
+}
+
+void playlistModel::refreshMetaData()
+{
+    // rows requested while the info was not in the store are asked again
+    int first = -1;
+    int last = -1;
+    for (int row=0; row<m_metaState.size(); row++)
+    {
+        if (m_metaState.at(row) != metaState::REQUESTED)
+            continue;
+
+        m_metaState[row] = metaState::NONE;
+        if (first < 0)
+            first = row;
+        last = row;
+    }
+
+    if (first >= 0)
+        emit dataChanged(index(first, 0), index(last, 0), {Qt::ToolTipRole, TitleRole, ArtistRole, DurationRole, BackendRole});
+}
+
+bool playlistModel::canDropMimeData(const QMimeData *data, Qt::DropAction action, int row, int column, const QModelIndex &parent) const
+{
+    Q_UNUSED(action)
+    Q_UNUSED(row)
+    Q_UNUSED(column)
+    Q_UNUSED(parent)
+
+    return data->hasUrls();
+}
+
+bool playlistModel::dropMimeData(const QMimeData *data, Qt::DropAction action, int row, [[maybe_unused]] int column, const QModelIndex &parent)
+{
+    if (action == Qt::IgnoreAction)
+        return true;
+
+    int beginRow;
+
+    if (row != -1)
+        beginRow = row;
+    else if (parent.isValid())
+        beginRow = parent.row();
+    else
+        beginRow = rowCount();
+
+    QStringList files;
+    for (auto&& urlItem : data->urls())
+    {
+        QString url(urlItem.toLocalFile());
+        if (QFileInfo(url).isFile())
+        {
+            qDebug() << "adding url" << url;
+            files.append(url);
+        }
+    }
+
+    insertEntries(beginRow, files);
+
+    return true;
+}
+
+QStringList playlistModel::mimeTypes() const
+{
+    QStringList types;
+    types << QLatin1String("text/uri-list");
+    return types;
+}
@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2019-2021 Leandro Nini
+ *  Copyright (C) 2019-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -19,109 +19,102 @@
 #ifndef PLAYLISTMODEL_H
 #define PLAYLISTMODEL_H
 
-#include <QStringListModel>
-#include <QFileInfo>
+#include <QAbstractListModel>
 #include <QStringList>
-#include <QMimeData>
-#include <QUrl>
-#include <QDebug>
+#include <QVector>
 
-class playlistModel : public QStringListModel
+#include <functional>
+
+class QMimeData;
+
+/**
+ * Playlist model
+ *
+ * Entries are stored column-wise with names precomputed
+ * so that data() doesn't need to parse paths.
+ * Metadata columns are allocated and filled on demand.
+ */
+class playlistModel : public QAbstractListModel
 {
 public:
-    explicit playlistModel(QObject *parent=0) : QStringListModel(parent) {}
-
-    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override
+    enum role
     {
-        if (!index.isValid())
-            return QVariant();
+        PathRole = Qt::UserRole,
+        FileNameRole,
+        TitleRole,
+        ArtistRole,
+        DurationRole,
+        BackendRole
+    };
+
+    /// Called when metadata for a row is needed, should not block
+    using metaFetcher_t = std::function<void(int row, const QString& path)>;
+
+private:
+    enum class metaState : quint8 { NONE, REQUESTED, AVAILABLE };
+
+private:
+    QStringList m_paths;
+    QStringList m_names;
+    QStringList m_fileNames;
+
+    // metadata columns, empty until first used
+    QStringList m_titles;
+    QStringList m_artists;
+    QStringList m_backends;
+    QVector<int> m_durations;
+    mutable QVector<metaState> m_metaState;
+
+    metaFetcher_t m_fetcher;
+
+private:
+    void insertEntries(int row, const QStringList& paths);
+    void allocMetaData();
+    QVariant metaData(int row, int role) const;
 
-        const QFileInfo location(stringList().value(index.row()));
+public:
+    explicit playlistModel(QObject *parent=nullptr) : QAbstractListModel(parent) {}
 
-        if (role == Qt::DisplayRole)
-            return location.completeBaseName();
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
 
-        if (role == Qt::ToolTipRole)
-            return location.absoluteFilePath();
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
 
-        if (role == Qt::UserRole)
-            return stringList().value(index.row());
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
 
-        if (role == Qt::UserRole+1)
-            return location.fileName();
+    bool removeRows(int row, int count, const QModelIndex &parent = QModelIndex()) override;
 
-        return QVariant();
-    }
+    bool canDropMimeData(const QMimeData *data, Qt::DropAction action, int row, int column, const QModelIndex &parent) const override;
 
-    Qt::ItemFlags flags(const QModelIndex &index) const override
-    {
-        if (!index.isValid())
-            return QAbstractListModel::flags(index) | Qt::ItemIsDropEnabled;
+    bool dropMimeData(const QMimeData *data, Qt::DropAction action, int row, int column, const QModelIndex &parent) override;
 
-        return QAbstractListModel::flags(index) | Qt::ItemIsDropEnabled | Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemNeverHasChildren;
-    }
+    QStringList mimeTypes() const override;
 
-    void clear()
-    {
-        setStringList(QStringList());
-    }
+    /// Replace all entries
+    void setFiles(const QStringList& files);
 
-    void append(QString data)
-    {
-        const int rows = rowCount();
-        insertRow(rows);
-        setData(index(rows, 0), data);
-    }
+    /// Remove all entries
+    void clear();
 
-    bool canDropMimeData(const QMimeData *data, Qt::DropAction action, int row, int column, const QModelIndex &parent) const override
-    {
-        Q_UNUSED(action)
-        Q_UNUSED(row)
-        Q_UNUSED(column)
-        Q_UNUSED(parent)
+    /// Add an entry at the end
+    void append(const QString& file);
 
-        return data->hasUrls();
-    }
+    /// Full path of the given row
+    const QString& path(int row) const { return m_paths.at(row); }
 
-    bool dropMimeData(const QMimeData *data, Qt::DropAction action, int row, [[maybe_unused]] int column, const QModelIndex &parent) override
-    {
-        if (action == Qt::IgnoreAction)
-            return true;
-
-        int beginRow;
-
-        if (row != -1)
-            beginRow = row;
-        else if (parent.isValid())
-            beginRow = parent.row();
-        else
-            beginRow = rowCount();
-
-        QList<QUrl> urlList = data->urls();
-        int rows = urlList.size();
-
-        insertRows(beginRow, rows);
-
-        for (auto&& urlItem : urlList)
-        {
-            QString url(urlItem.toLocalFile());
-            if (QFileInfo(url).isFile())
-            {
-                qDebug() << "adding url" << url;
-                setData(index(beginRow, 0), url);
-                beginRow++;
-            }
-        }
-
-        return true;
-    }
-
-    QStringList mimeTypes() const override
-    {
-        QStringList types;
-        types << QLatin1String("text/uri-list");
-        return types;
-    }
+    /// File name of the given row
+    const QString& fileName(int row) const { return m_fileNames.at(row); }
+
+    /// Find the first row with the given name, -1 if not found
+    int find(const QString& name) const { return m_names.indexOf(name); }
+
+    /// Set the function used to request metadata
+    void setMetaFetcher(const metaFetcher_t& fetcher) { m_fetcher = fetcher; }
+
+    /// Fill metadata columns for the given row
+    void setMetaData(int row, const QString& title, const QString& artist, int duration, const QString& backend);
+
+    /// Request again metadata not found before, after the store was updated
+    void refreshMetaData();
 };
 
 #endif
@@ -24,6 +24,7 @@
 
 #include <algorithm>
 #include <random>
+#include <utility>
 
 class proxymodel final : public QSortFilterProxyModel
 {
@@ -33,13 +34,94 @@ public:
 private:
     sortMode m_mode;
 
-    QVector<int> m_randomOrder;
+    // source row -> position in the shuffled order
+    QVector<int> m_rank;
+
+    // source rows already played, in order
+    QVector<int> m_history;
+
+    // source row of the song being played, -1 if none
+    int m_current;
 
 private:
     proxymodel() {}
     proxymodel(const proxymodel&) = delete;
     proxymodel& operator=(const proxymodel&) = delete;
 
+    int rank(int row) const
+    {
+        // rows added after shuffling go to the end
+        return (row < m_rank.size()) ? m_rank[row] : m_rank.size() + row;
+    }
+
+    void shuffle()
+    {
+        const int rows = sourceModel()->rowCount();
+
+        // played songs first in play order, ending with the current one
+        // so that next only walks songs not played yet, then the rest randomly
+        QVector<bool> played(rows, false);
+        QVector<int> order;
+        order.reserve(rows);
+        for (int row: std::as_const(m_history))
+        {
+            if ((row < rows) && (row != m_current))
+            {
+                played[row] = true;
+                order.append(row);
+            }
+        }
+        if ((m_current >= 0) && (m_current < rows))
+        {
+            played[m_current] = true;
+            order.append(m_current);
+        }
+        const int start = order.size();
+        for (int row=0; row<rows; row++)
+        {
+            if (!played[row])
+                order.append(row);
+        }
+        std::shuffle(order.begin()+start, order.end(), std::mt19937(std::random_device()()));
+
+        m_rank.resize(rows);
+        for (int i=0; i<rows; i++)
+            m_rank[order[i]] = i;
+    }
+
+    void onRowsAboutToBeInserted(const QModelIndex&, int first, int last)
+    {
+        m_history.clear();
+        m_current = -1;
+        if (first < m_rank.size())
+        {
+            const int count = last - first + 1;
+            const int base = m_rank.size();
+            m_rank.insert(first, count, 0);
+            for (int i=0; i<count; i++)
+                m_rank[first+i] = base + i;
+        }
+    }
+
+    void onRowsRemoved(const QModelIndex&, int first, int last)
+    {
+        m_history.clear();
+        m_current = -1;
+        if (first < m_rank.size())
+            m_rank.remove(first, std::min(last, m_rank.size()-1) - first + 1);
+    }
+
+    void onModelReset()
+    {
+        m_history.clear();
+        m_current = -1;
+        if (m_mode == sortMode::Random)
+        {
+            shuffle();
+            invalidate();
+        }
+    }
+
 protected:
     bool lessThan(const QModelIndex &source_left, const QModelIndex &source_right) const override
     {
@@ -48,7 +130,7 @@ protected:
             // NOTE cannot return random value as this function must be consistent
             // see https://bugs.kde.org/show_bug.cgi?id=413018
             // https://commits.kde.org/plasma-workspace/a1cf305ffb21b8ae8bbaf4d6ce03bbaa94cff405
-            return m_randomOrder.indexOf(source_left.row()) < m_randomOrder.indexOf(source_right.row());
+            return rank(source_left.row()) < rank(source_right.row());
         }
         return QSortFilterProxyModel::lessThan(source_left, source_right);
     }
@@ -56,9 +138,19 @@ protected:
 public:
     proxymodel(QWidget * parent) :
         QSortFilterProxyModel(parent),
-        m_mode(sortMode::Ascending)
+        m_mode(sortMode::Ascending),
+        m_current(-1)
     {}
 
+    void setSourceModel(QAbstractItemModel *model) override
+    {
+        QSortFilterProxyModel::setSourceModel(model);
+
+        connect(model, &QAbstractItemModel::rowsAboutToBeInserted, this, &proxymodel::onRowsAboutToBeInserted);
+        connect(model, &QAbstractItemModel::rowsRemoved, this, &proxymodel::onRowsRemoved);
+        connect(model, &QAbstractItemModel::modelReset, this, &proxymodel::onModelReset);
+    }
+
     void sort(sortMode newMode)
     {
         if ((m_mode == newMode) && (newMode != sortMode::Random))
@@ -79,9 +171,7 @@ public:
             break;
         case sortMode::Random:
             order = Qt::AscendingOrder;
-            m_randomOrder.resize(sourceModel()->rowCount());
-            std::iota(m_randomOrder.begin(), m_randomOrder.end(), 0);
-            std::shuffle(m_randomOrder.begin(), m_randomOrder.end(), std::random_device());
+            shuffle();
             break;
         default:
             Q_UNREACHABLE();
@@ -91,6 +181,19 @@ public:
     }
 
     sortMode getMode() const { return m_mode; }
+
+    /// Mark a source row as played
+    void played(int row)
+    {
+        if (row < 0)
+            return;
+
+        m_current = row;
+
+        // moving back through the history doesn't change it
+        if (!m_history.contains(row))
+            m_history.append(row);
+    }
 };
 
 #endif
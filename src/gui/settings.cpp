@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2008-2023 Leandro Nini
+ *  Copyright (C) 2008-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -18,340 +18,7 @@
 
 #include "settings.h"
 
-#include "audio.h"
-#include "inputConfig.h"
-#include "inputFactory.h"
-#include "iconFactory.h"
-
-#ifdef HAVE_LASTFM
-#  include "lastfm.h"
-#endif
-
-#include <QDebug>
-#include <QButtonGroup>
-#include <QEvent>
-#include <QFrame>
-#include <QGroupBox>
-#include <QCheckBox>
-#include <QComboBox>
-#include <QPushButton>
-#include <QToolButton>
-#include <QRadioButton>
-#include <QStackedWidget>
 #include <QSettings>
-#include <QStatusTipEvent>
-#include <QMainWindow>
-#include <QStatusBar>
-#include <QHBoxLayout>
-
-settingsWindow::settingsWindow(QWidget* win, const QString& bkName) :
-    QDialog(win)
-{
-    setObjectName("Settings Dialog");
-
-    setWindowTitle(tr("Settings"));
-
-    QVBoxLayout* main = new QVBoxLayout(this);
-
-    QSizePolicy sizePol(QSizePolicy::Minimum, QSizePolicy::Fixed);
-    //QSizePolicy sizeMin(QSizePolicy::Expanding, QSizePolicy::Maximum);
-
-    QHBoxLayout *horizontal = new QHBoxLayout();
-    main->addLayout(horizontal);
-    QVBoxLayout *buttons = new QVBoxLayout();
-    horizontal->addLayout(buttons);
-    QStackedWidget *switcher = new QStackedWidget(this);
-    horizontal->addWidget(switcher);
-
-    QButtonGroup *buttonGroup = new QButtonGroup(this);
-    connect(buttonGroup, &QButtonGroup::idClicked, switcher, &QStackedWidget::setCurrentIndex);
-
-    // General settings
-    QWidget* optionpane = new QWidget();
-    QVBoxLayout* optionLayout = new QVBoxLayout(optionpane);
-    optionLayout->addWidget(new QLabel(tr("General settings"), this));
-
-    {
-        QFrame* line = new QFrame(this);
-        line->setFrameShape(QFrame::HLine);
-        line->setFrameShadow(QFrame::Sunken);
-        optionLayout->addWidget(line);
-    }
-
-    QCheckBox* cBox = new QCheckBox(tr("&Play subtunes"), this);
-    cBox->setToolTip(tr("Play all subtunes"));
-    cBox->setCheckState(SETTINGS->m_subtunes ? Qt::Checked : Qt::Unchecked);
-    connect(cBox,
-#if QT_VERSION >= QT_VERSION_CHECK(6, 7, 0)
-            &QCheckBox::checkStateChanged,
-        [](Qt::CheckState val)
-#else
-            &QCheckBox::stateChanged,
-        [](int val)
-#endif
-        {
-            SETTINGS->m_subtunes = (val == Qt::Checked);
-        }
-    );
-    optionLayout->addWidget(cBox);
-
-    cBox = new QCheckBox(tr("&Bauer stereophonic-to-binaural DSP"), this);
-    cBox->setToolTip(tr("Bauer stereophonic-to-binaural DSP"));
-    cBox->setCheckState(SETTINGS->m_bs2b ? Qt::Checked : Qt::Unchecked);
-    connect(cBox,
-#if QT_VERSION >= QT_VERSION_CHECK(6, 7, 0)
-            &QCheckBox::checkStateChanged,
-        [](Qt::CheckState val)
-#else
-            &QCheckBox::stateChanged,
-        [](int val)
-#endif
-        {
-            SETTINGS->m_bs2b = (val == Qt::Checked);
-        }
-    );
-    optionLayout->addWidget(cBox);
-#ifndef HAVE_BS2B
-    cBox->setDisabled(true);
-#endif
-
-    cBox = new QCheckBox(tr("&Use system icons"), this);
-    cBox->setToolTip(tr("Use icons from system theme (on next restart)"));
-    cBox->setCheckState(SETTINGS->m_themeIcons ? Qt::Checked : Qt::Unchecked);
-    connect(cBox,
-#if QT_VERSION >= QT_VERSION_CHECK(6, 7, 0)
-            &QCheckBox::checkStateChanged,
-        [](Qt::CheckState val)
-#else
-        &QCheckBox::stateChanged,
-        [](int val)
-#endif
-        {
-            SETTINGS->m_themeIcons = (val == Qt::Checked);
-        }
-    );
-    optionLayout->addWidget(cBox);
-#ifndef Q_OS_LINUX
-    cBox->setDisabled(true);
-#endif
-
-    {
-        QGroupBox *group = new QGroupBox(tr("Replaygain"));
-        QVBoxLayout *replayGainBox = new QVBoxLayout(group);
-        group->setCheckable(true);
-        group->setToolTip(tr("Enable replaygain loudness normalization"));
-        group->setChecked(SETTINGS->m_replayGain);
-        connect(group, &QGroupBox::toggled,
-            [](bool val)
-            {
-                SETTINGS->m_replayGain = val;
-            }
-        );
-
-        QButtonGroup *radioGroup = new QButtonGroup(this);
-
-        QRadioButton* radio = new QRadioButton(tr("Album gain"), this);
-        radio->setToolTip(tr("Preserve album dynamics"));
-        radio->setChecked(SETTINGS->m_replayGainMode==settings::rg_t::Album);
-        replayGainBox->layout()->addWidget(radio);
-        radioGroup->addButton(radio, 0);
-        radio = new QRadioButton(tr("Track gain"), this);
-        radio->setToolTip(tr("All tracks equal loudness"));
-        radio->setChecked(SETTINGS->m_replayGainMode==settings::rg_t::Track);
-        replayGainBox->layout()->addWidget(radio);
-        radioGroup->addButton(radio, 1);
-        replayGainBox->addStretch(1);
-        optionLayout->addWidget(group);
-
-        connect(radioGroup, &QButtonGroup::idClicked,
-            [](int val)
-            {
-                SETTINGS->m_replayGainMode = val == 0 ? settings::rg_t::Album : settings::rg_t::Track;
-            }
-        );
-    }
-    switcher->addWidget(optionpane);
-
-    optionLayout->addStretch();
-
-    int section = 0;
-
-    QToolButton* button = new QToolButton(this);
-    button->setToolButtonStyle(Qt::ToolButtonTextUnderIcon);
-    button->setIcon(GET_ICON(icon_preferencesdesktop));
-    button->setText(tr("General")); 
-    button->setToolTip(tr("General setting"));
-    button->setStatusTip("General setting");
-    button->setCheckable(true);
-    button->setChecked(true);
-    button->setSizePolicy(sizePol);
-    buttonGroup->addButton(button, section++);
-    buttons->addWidget(button);
-
-    // Audio settings
-    QWidget* audiopane = new QWidget(this);
-    QVBoxLayout* audioLayout = new QVBoxLayout(audiopane);
-    audioLayout->addWidget(new QLabel(tr("Audio settings"), this));
-
-    {
-        QFrame* line = new QFrame();
-        line->setFrameShape(QFrame::HLine);
-        line->setFrameShadow(QFrame::Sunken);
-        audioLayout->addWidget(line);
-    }
-
-    audioLayout->addWidget(new audioConfig(audiopane));
-    switcher->addWidget(audiopane);
-
-    button = new QToolButton(this);
-    button->setToolButtonStyle(Qt::ToolButtonTextUnderIcon);
-    button->setIcon(GET_ICON(icon_audiocard));
-    button->setText(tr("Audio")); 
-    button->setToolTip(tr("Audio setting"));
-    button->setStatusTip("Audio setting");
-    button->setCheckable(true);
-    button->setSizePolicy(sizePol);
-    buttonGroup->addButton(button, section++);
-    buttons->addWidget(button);
-
-    audioLayout->addStretch();
-#ifdef HAVE_LASTFM
-    // Last.fm settings
-    QWidget* lastfmpane = new QWidget(this);
-    QVBoxLayout* lastfmLayout = new QVBoxLayout(lastfmpane);
-    lastfmLayout->addWidget(new QLabel(tr("Last.fm settings"), this));
-
-    {
-        QFrame* line = new QFrame();
-        line->setFrameShape(QFrame::HLine);
-        line->setFrameShadow(QFrame::Sunken);
-        lastfmLayout->addWidget(line);
-    }
-
-    lastfmLayout->addWidget(new lastfmConfig(lastfmpane));
-    switcher->addWidget(lastfmpane);
-
-    button = new QToolButton(this);
-    button->setToolButtonStyle(Qt::ToolButtonTextUnderIcon);
-    button->setIcon(GET_ICON(icon_lastfm));
-    button->setText(tr("Last.fm")); 
-    button->setToolTip(tr("Last.fm setting"));
-    button->setStatusTip("Last.fm setting");
-    button->setCheckable(true);
-    button->setSizePolicy(sizePol);
-    buttonGroup->addButton(button, section++);
-    buttons->addWidget(button);
-
-    lastfmLayout->addStretch();
-#endif
-    // Backend settings
-    QWidget* backendpane = new QWidget(this);
-    QVBoxLayout* backendLayout = new QVBoxLayout(backendpane);
-    backendLayout->addWidget(new QLabel(tr("Backend settings"), this));
-
-    {
-        QFrame* line = new QFrame(this);
-        line->setFrameShape(QFrame::HLine);
-        line->setFrameShadow(QFrame::Sunken);
-        backendLayout->addWidget(line);
-    }
-
-    QStackedWidget *beSwitcher = new QStackedWidget(this);
-
-    {
-        QComboBox *backends = new QComboBox(this);
-        for (int i=0; i<IFACTORY->num(); i++)
-        {
-            backends->addItem(IFACTORY->name(i));
-            inputConfig *ic = IFACTORY->getConfig(i);
-            backends->setItemIcon(i, ic->icon());
-            m_inputConfigs.append(ic);
-            beSwitcher->addWidget(ic->config());
-        }
-        connect(backends, QOverload<int>::of(&QComboBox::currentIndexChanged), beSwitcher, &QStackedWidget::setCurrentIndex);
-
-        backends->setCurrentText(bkName);
-
-        QWidget *w = new QWidget(this);
-        QHBoxLayout *backendSelection = new QHBoxLayout(w);
-        backendSelection->addWidget(new QLabel(tr("Backend")));
-        backendSelection->addWidget(backends);
-        backendLayout->addWidget(w);
-    }
-
-    backendLayout->addWidget(beSwitcher);
-
-    backendLayout->addStretch();
-
-    switcher->addWidget(backendpane);
-
-    button = new QToolButton(this);
-    button->setToolButtonStyle(Qt::ToolButtonTextUnderIcon);
-    button->setIcon(GET_ICON(icon_backend));
-    button->setText(tr("Backend")); 
-    button->setToolTip(tr("Backend settings"));
-    button->setStatusTip("Backend settings");
-    button->setCheckable(true);
-    button->setSizePolicy(sizePol);
-    buttonGroup->addButton(button, section++);
-    buttons->addWidget(button);
-
-    {
-        QFrame* line = new QFrame(this);
-        line->setFrameShape(QFrame::HLine);
-        line->setFrameShadow(QFrame::Sunken);
-        main->addWidget(line);
-    }
-
-    QHBoxLayout* bottom = new QHBoxLayout();
-    main->addLayout(bottom);
-    QPushButton* initial = new QPushButton(GET_ICON(icon_dialogok), tr("&OK"), this);
-    bottom->addWidget(initial);
-    QPushButton* b = new QPushButton(GET_ICON(icon_dialogcancel), tr("&Cancel"), this);
-    bottom->addWidget(b);
-    initial->setFocus();
-    connect(b, &QPushButton::clicked,
-        [this]()
-        {
-            //SETTINGS->load();
-            for (inputConfig* ic: m_inputConfigs)
-            {
-                ic->loadSettings();
-                delete ic;
-            }
-            reject();
-        }
-    );
-    connect(initial, &QPushButton::clicked,
-        [this]()
-        {
-            //SETTINGS->save();
-            for (inputConfig* ic: m_inputConfigs)
-            {
-                ic->saveSettings();
-                delete ic;
-            }
-            accept();
-        }
-    );
-
-    buttons->addStretch();
-
-    layout()->setSizeConstraint(QLayout::SetFixedSize);
-}
-
-bool settingsWindow::event(QEvent *e)
-{
-    if (e->type() == QEvent::StatusTip)
-    {
-        QStatusTipEvent *ev = (QStatusTipEvent*)e;
-        ((QMainWindow*)parentWidget())->statusBar()->showMessage(ev->tip());
-        return true;
-    }
-    return QDialog::event(e);
-}
-
-/*****************************************************************/
 
 settings* SETTINGS
 {
@@ -365,14 +32,44 @@ void settings::load(const QSettings& appSettings)
     m_bits = appSettings.value(config::AUDIO_BITS, 16).toInt();
 
     m_bufLen = appSettings.value(config::AUDIO_BUFFERLEN, 500).toUInt();
+    m_highWatermark = appSettings.value(config::AUDIO_HIGHWM, 1000).toUInt();
+    m_lowWatermark = appSettings.value(config::AUDIO_LOWWM, 250).toUInt();
+    QString resamplerQuality = appSettings.value(config::AUDIO_RESAMPLER, "Medium").toString();
+    m_resamplerQuality = !resamplerQuality.compare("Fast") ? resampler_t::Fast
+        : !resamplerQuality.compare("Best") ? resampler_t::Best : resampler_t::Medium;
+    m_noiseShaping = appSettings.value(config::AUDIO_NOISESHAPING, false).toBool();
+    m_floatBus = appSettings.value(config::AUDIO_FLOATBUS, false).toBool();
+    m_crossfade = qMin(appSettings.value(config::AUDIO_CROSSFADE, 0).toUInt(), 20u);
+    m_trimSilence = appSettings.value(config::AUDIO_TRIMSILENCE, false).toBool();
 
     m_subtunes = appSettings.value(config::GENERAL_SUBTUNES, false).toBool();
     m_replayGain = appSettings.value(config::GENERAL_REPLAYGAIN, false).toBool();
     QString replayGainMode=appSettings.value(config::GENERAL_RG_MODE, "Album").toString();
     m_replayGainMode = (!replayGainMode.compare("Album")) ? settings::rg_t::Album : settings::rg_t::Track;
 
+    m_replayGainAnalyze = appSettings.value(config::GENERAL_RG_ANALYZE, false).toBool();
     m_bs2b=appSettings.value(config::GENERAL_BAUERDSP, false).toBool();
     m_themeIcons=appSettings.value(config::GENERAL_ICONTHEME, false).toBool();
+    m_scanLibrary=appSettings.value(config::GENERAL_SCANLIB, false).toBool();
+
+    m_preamp = appSettings.value(config::DSP_PREAMP, 0.).toFloat();
+    m_equalizer = appSettings.value(config::DSP_EQUALIZER, false).toBool();
+    {
+        static const float freqs[EQ_BANDS] = { 62.f, 125.f, 250.f, 500.f, 1000.f, 2000.f, 4000.f, 12000.f };
+        const QStringList bands = appSettings.value(config::DSP_EQBANDS).toStringList();
+        for (int i=0; i<EQ_BANDS; i++)
+        {
+            const bool shelf = (i == 0) || (i == EQ_BANDS-1);
+            m_eqBands[i] = { freqs[i], 0.f, shelf ? 0.707f : 1.f };
+
+            // "frequency,gain,q"
+            const QStringList band = (i < bands.size()) ? bands.at(i).split(',') : QStringList();
+            if (band.size() == 3)
+                m_eqBands[i] = { band.at(0).toFloat(), band.at(1).toFloat(), band.at(2).toFloat() };
+        }
+    }
+    m_limiter = appSettings.value(config::DSP_LIMITER, false).toBool();
+    m_limiterCeiling = appSettings.value(config::DSP_CEILING, -1.).toFloat();
 }
 
 void settings::save(QSettings& appSettings)
@@ -381,10 +78,31 @@ void settings::save(QSettings& appSettings)
     appSettings.setValue(config::AUDIO_BITS, m_bits);
 
     appSettings.setValue(config::AUDIO_BUFFERLEN, m_bufLen);
+    appSettings.setValue(config::AUDIO_HIGHWM, m_highWatermark);
+    appSettings.setValue(config::AUDIO_LOWWM, m_lowWatermark);
+    appSettings.setValue(config::AUDIO_RESAMPLER, (m_resamplerQuality == resampler_t::Fast) ? "Fast"
+        : (m_resamplerQuality == resampler_t::Best) ? "Best" : "Medium");
+    appSettings.setValue(config::AUDIO_NOISESHAPING, m_noiseShaping);
+    appSettings.setValue(config::AUDIO_FLOATBUS, m_floatBus);
+    appSettings.setValue(config::AUDIO_CROSSFADE, m_crossfade);
+    appSettings.setValue(config::AUDIO_TRIMSILENCE, m_trimSilence);
 
     appSettings.setValue(config::GENERAL_SUBTUNES, m_subtunes);
     appSettings.setValue(config::GENERAL_REPLAYGAIN, m_replayGain);
     appSettings.setValue(config::GENERAL_RG_MODE, (m_replayGainMode == settings::rg_t::Album) ? "Album" : "Track");
+    appSettings.setValue(config::GENERAL_RG_ANALYZE, m_replayGainAnalyze);
     appSettings.setValue(config::GENERAL_BAUERDSP, m_bs2b);
     appSettings.setValue(config::GENERAL_ICONTHEME, m_themeIcons);
+    appSettings.setValue(config::GENERAL_SCANLIB, m_scanLibrary);
+
+    appSettings.setValue(config::DSP_PREAMP, m_preamp);
+    appSettings.setValue(config::DSP_EQUALIZER, m_equalizer);
+    {
+        QStringList bands;
+        for (const eqBand_t& band: m_eqBands)
+            bands.append(QString("%1,%2,%3").arg(band.freq).arg(band.gain).arg(band.q));
+        appSettings.setValue(config::DSP_EQBANDS, bands);
+    }
+    appSettings.setValue(config::DSP_LIMITER, m_limiter);
+    appSettings.setValue(config::DSP_CEILING, m_limiterCeiling);
 }
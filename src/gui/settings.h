@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2008-2025 Leandro Nini
+ *  Copyright (C) 2008-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -23,17 +23,22 @@
 #  include "config.h"
 #endif
 
-#include <QDialog>
+#include "inputTypes.h"
+
 #include <QObject>
 #include <QLabel>
 
+#include <array>
+
 namespace config
 {
 constexpr const char* GENERAL_SUBTUNES   = "General Settings/play subtunes";
 constexpr const char* GENERAL_REPLAYGAIN = "General Settings/Replaygain";
 constexpr const char* GENERAL_RG_MODE    = "General Settings/Replaygain mode";
+constexpr const char* GENERAL_RG_ANALYZE = "General Settings/Replaygain analyze";
 constexpr const char* GENERAL_BAUERDSP   = "General Settings/Bauer DSP";
 constexpr const char* GENERAL_ICONTHEME  = "General Settings/Theme icons";
+constexpr const char* GENERAL_SCANLIB    = "General Settings/scan library";
 constexpr const char* GENERAL_POS        = "General Settings/pos";
 constexpr const char* GENERAL_SIZE       = "General Settings/size";
 constexpr const char* GENERAL_PLMODE     = "General Settings/playlist mode";
@@ -43,6 +48,19 @@ constexpr const char* AUDIO_CARD         = "Audio Settings/card";
 constexpr const char* AUDIO_BITS         = "Audio Settings/bits";
 constexpr const char* AUDIO_VOLUME       = "Audio Settings/volume";
 constexpr const char* AUDIO_BUFFERLEN    = "Audio Settings/buffer length";
+constexpr const char* AUDIO_HIGHWM       = "Audio Settings/high watermark";
+constexpr const char* AUDIO_LOWWM        = "Audio Settings/low watermark";
+constexpr const char* AUDIO_RESAMPLER    = "Audio Settings/resampler quality";
+constexpr const char* AUDIO_NOISESHAPING = "Audio Settings/noise shaping";
+constexpr const char* AUDIO_FLOATBUS     = "Audio Settings/float bus";
+constexpr const char* AUDIO_CROSSFADE    = "Audio Settings/crossfade";
+constexpr const char* AUDIO_TRIMSILENCE  = "Audio Settings/trim silence";
+
+constexpr const char* DSP_PREAMP         = "DSP Settings/preamp";
+constexpr const char* DSP_EQUALIZER      = "DSP Settings/equalizer";
+constexpr const char* DSP_EQBANDS        = "DSP Settings/equalizer bands";
+constexpr const char* DSP_LIMITER        = "DSP Settings/limiter";
+constexpr const char* DSP_CEILING        = "DSP Settings/limiter ceiling";
 
 constexpr const char* LASTFM_USERNAME    = "Last.fm Settings/User Name";
 constexpr const char* LASTFM_SESSIONKEY  = "Last.fm Settings/Session Key";
@@ -51,28 +69,6 @@ constexpr const char* LASTFM_SCROBBLING  = "Last.fm Settings/scrobbling";
 
 /*****************************************************************/
 
-class inputConfig;
-
-class settingsWindow : public QDialog
-{
-private:
-    QList<inputConfig*> m_inputConfigs;
-
-private:
-    settingsWindow() {}
-    settingsWindow(const settingsWindow&) = delete;
-    settingsWindow& operator=(const settingsWindow&) = delete;
-
-protected:
-    bool event(QEvent *e) override;
-
-public:
-    settingsWindow(QWidget* win, const QString& bkName);
-    ~settingsWindow() override = default;
-};
-
-/*****************************************************************/
-
 #define SETTINGS settings::instance()
 
 class QSettings;
@@ -81,6 +77,7 @@ class settings
 {
     friend class settingsWindow;
     friend class audioConfig;
+    friend class dspConfig;
 
 public:
     enum class rg_t
@@ -93,12 +90,27 @@ private:
     QString      m_card;
     unsigned int m_bits;
     unsigned int m_bufLen;
+    unsigned int m_highWatermark;
+    unsigned int m_lowWatermark;
+    resampler_t  m_resamplerQuality;
+    bool         m_noiseShaping;
+    bool         m_floatBus;
+    unsigned int m_crossfade;
+    bool         m_trimSilence;
 
     bool         m_subtunes;
     bool         m_bs2b;
     bool         m_themeIcons;
+    bool         m_scanLibrary;
     bool         m_replayGain;
     rg_t         m_replayGainMode;
+    bool         m_replayGainAnalyze;
+
+    float        m_preamp;
+    bool         m_equalizer;
+    std::array<eqBand_t, EQ_BANDS> m_eqBands;
+    bool         m_limiter;
+    float        m_limiterCeiling;
 
 protected:
     settings() {}
@@ -130,17 +142,59 @@ public:
     /// Replay Gain Mode
     rg_t replayGainMode() const { return m_replayGainMode; }
 
+    /// Measure loudness of files without Replay Gain tags in background
+    bool replayGainAnalyze() const { return m_replayGainAnalyze; }
+
     /// Bauer stereophonic-to-binaural DSP
     bool bs2b() const { return m_bs2b; }
 
     /// System theme icons
     bool themeIcons() const { return m_themeIcons; }
 
+    /// Index music library in background
+    bool scanLibrary() const { return m_scanLibrary; }
+
     /// Default bittdepth
     unsigned int bits() const { return m_bits; }
 
     /// Default buffer length
     unsigned int bufLen() const { return m_bufLen; }
+
+    /// Decode ahead buffer high watermark in milliseconds
+    unsigned int highWatermark() const { return m_highWatermark; }
+
+    /// Decode ahead buffer low watermark in milliseconds
+    unsigned int lowWatermark() const { return m_lowWatermark; }
+
+    /// Resampler quality preset
+    resampler_t resamplerQuality() const { return m_resamplerQuality; }
+
+    /// Noise shaped dither when reducing bitdepth
+    bool noiseShaping() const { return m_noiseShaping; }
+
+    /// Decode and process in float, converting to the card format at the end
+    bool floatBus() const { return m_floatBus; }
+
+    /// Crossfade length in seconds, 0 if disabled
+    unsigned int crossfade() const { return m_crossfade; }
+
+    /// Skip silence between songs
+    bool trimSilence() const { return m_trimSilence; }
+
+    /// Preamp gain in dB
+    float preamp() const { return m_preamp; }
+
+    /// Parametric equalizer
+    bool equalizer() const { return m_equalizer; }
+
+    /// Equalizer bands
+    const std::array<eqBand_t, EQ_BANDS>& eqBands() const { return m_eqBands; }
+
+    /// True peak limiter
+    bool limiter() const { return m_limiter; }
+
+    /// Limiter ceiling in dBTP
+    float limiterCeiling() const { return m_limiterCeiling; }
 };
 
 #endif
@@ -0,0 +1,396 @@
+/*
+ *  Copyright (C) 2008-2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "settingsWindow.h"
+
+#include "settings.h"
+#include "audioConfig.h"
+#include "dsp/dspConfig.h"
+#include "inputConfig.h"
+#include "inputFactory.h"
+#include "iconFactory.h"
+
+#ifdef HAVE_LASTFM
+#  include "lastfm.h"
+#endif
+
+#include <QDebug>
+#include <QButtonGroup>
+#include <QEvent>
+#include <QFrame>
+#include <QGroupBox>
+#include <QCheckBox>
+#include <QComboBox>
+#include <QPushButton>
+#include <QToolButton>
+#include <QRadioButton>
+#include <QStackedWidget>
+#include <QSettings>
+#include <QStatusTipEvent>
+#include <QMainWindow>
+#include <QStatusBar>
+#include <QHBoxLayout>
+
+settingsWindow::settingsWindow(QWidget* win, const QString& bkName) :
+    QDialog(win)
+{
+    setObjectName("Settings Dialog");
+
+    setWindowTitle(tr("Settings"));
+
+    QVBoxLayout* main = new QVBoxLayout(this);
+
+    QSizePolicy sizePol(QSizePolicy::Minimum, QSizePolicy::Fixed);
+    //QSizePolicy sizeMin(QSizePolicy::Expanding, QSizePolicy::Maximum);
+
+    QHBoxLayout *horizontal = new QHBoxLayout();
+    main->addLayout(horizontal);
+    QVBoxLayout *buttons = new QVBoxLayout();
+    horizontal->addLayout(buttons);
+    QStackedWidget *switcher = new QStackedWidget(this);
+    horizontal->addWidget(switcher);
+
+    QButtonGroup *buttonGroup = new QButtonGroup(this);
+    connect(buttonGroup, &QButtonGroup::idClicked, switcher, &QStackedWidget::setCurrentIndex);
+
+    // General settings
+    QWidget* optionpane = new QWidget();
+    QVBoxLayout* optionLayout = new QVBoxLayout(optionpane);
+    optionLayout->addWidget(new QLabel(tr("General settings"), this));
+
+    {
+        QFrame* line = new QFrame(this);
+        line->setFrameShape(QFrame::HLine);
+        line->setFrameShadow(QFrame::Sunken);
+        optionLayout->addWidget(line);
+    }
+
+    QCheckBox* cBox = new QCheckBox(tr("&Play subtunes"), this);
+    cBox->setToolTip(tr("Play all subtunes"));
+    cBox->setCheckState(SETTINGS->m_subtunes ? Qt::Checked : Qt::Unchecked);
+    connect(cBox,
+#if QT_VERSION >= QT_VERSION_CHECK(6, 7, 0)
+            &QCheckBox::checkStateChanged,
+        [](Qt::CheckState val)
+#else
+            &QCheckBox::stateChanged,
+        [](int val)
+#endif
+        {
+            SETTINGS->m_subtunes = (val == Qt::Checked);
+        }
+    );
+    optionLayout->addWidget(cBox);
+
+    cBox = new QCheckBox(tr("&Use system icons"), this);
+    cBox->setToolTip(tr("Use icons from system theme (on next restart)"));
+    cBox->setCheckState(SETTINGS->m_themeIcons ? Qt::Checked : Qt::Unchecked);
+    connect(cBox,
+#if QT_VERSION >= QT_VERSION_CHECK(6, 7, 0)
+            &QCheckBox::checkStateChanged,
+        [](Qt::CheckState val)
+#else
+        &QCheckBox::stateChanged,
+        [](int val)
+#endif
+        {
+            SETTINGS->m_themeIcons = (val == Qt::Checked);
+        }
+    );
+    optionLayout->addWidget(cBox);
+#ifndef Q_OS_LINUX
+    cBox->setDisabled(true);
+#endif
+
+    cBox = new QCheckBox(tr("&Index music library"), this);
+    cBox->setToolTip(tr("Scan music locations in background to collect song info"));
+    cBox->setCheckState(SETTINGS->m_scanLibrary ? Qt::Checked : Qt::Unchecked);
+    connect(cBox,
+#if QT_VERSION >= QT_VERSION_CHECK(6, 7, 0)
+            &QCheckBox::checkStateChanged,
+        [](Qt::CheckState val)
+#else
+        &QCheckBox::stateChanged,
+        [](int val)
+#endif
+        {
+            SETTINGS->m_scanLibrary = (val == Qt::Checked);
+        }
+    );
+    optionLayout->addWidget(cBox);
+
+    {
+        QGroupBox *group = new QGroupBox(tr("Replaygain"));
+        QVBoxLayout *replayGainBox = new QVBoxLayout(group);
+        group->setCheckable(true);
+        group->setToolTip(tr("Enable replaygain loudness normalization"));
+        group->setChecked(SETTINGS->m_replayGain);
+        connect(group, &QGroupBox::toggled,
+            [](bool val)
+            {
+                SETTINGS->m_replayGain = val;
+            }
+        );
+
+        QButtonGroup *radioGroup = new QButtonGroup(this);
+
+        QRadioButton* radio = new QRadioButton(tr("Album gain"), this);
+        radio->setToolTip(tr("Preserve album dynamics"));
+        radio->setChecked(SETTINGS->m_replayGainMode==settings::rg_t::Album);
+        replayGainBox->layout()->addWidget(radio);
+        radioGroup->addButton(radio, 0);
+        radio = new QRadioButton(tr("Track gain"), this);
+        radio->setToolTip(tr("All tracks equal loudness"));
+        radio->setChecked(SETTINGS->m_replayGainMode==settings::rg_t::Track);
+        replayGainBox->layout()->addWidget(radio);
+        radioGroup->addButton(radio, 1);
+
+        QCheckBox* analyze = new QCheckBox(tr("&Analyze untagged files"), this);
+        analyze->setToolTip(tr("Measure loudness of songs in music locations without replaygain tags"));
+        analyze->setCheckState(SETTINGS->m_replayGainAnalyze ? Qt::Checked : Qt::Unchecked);
+        connect(analyze,
+#if QT_VERSION >= QT_VERSION_CHECK(6, 7, 0)
+                &QCheckBox::checkStateChanged,
+            [](Qt::CheckState val)
+#else
+            &QCheckBox::stateChanged,
+            [](int val)
+#endif
+            {
+                SETTINGS->m_replayGainAnalyze = (val == Qt::Checked);
+            }
+        );
+        replayGainBox->layout()->addWidget(analyze);
+        replayGainBox->addStretch(1);
+        optionLayout->addWidget(group);
+
+        connect(radioGroup, &QButtonGroup::idClicked,
+            [](int val)
+            {
+                SETTINGS->m_replayGainMode = val == 0 ? settings::rg_t::Album : settings::rg_t::Track;
+            }
+        );
+    }
+    switcher->addWidget(optionpane);
+
+    optionLayout->addStretch();
+
+    int section = 0;
+
+    QToolButton* button = new QToolButton(this);
+    button->setToolButtonStyle(Qt::ToolButtonTextUnderIcon);
+    button->setIcon(GET_ICON(icon_preferencesdesktop));
+    button->setText(tr("General")); 
+    button->setToolTip(tr("General setting"));
+    button->setStatusTip("General setting");
+    button->setCheckable(true);
+    button->setChecked(true);
+    button->setSizePolicy(sizePol);
+    buttonGroup->addButton(button, section++);
+    buttons->addWidget(button);
+
+    // Audio settings
+    QWidget* audiopane = new QWidget(this);
+    QVBoxLayout* audioLayout = new QVBoxLayout(audiopane);
+    audioLayout->addWidget(new QLabel(tr("Audio settings"), this));
+
+    {
+        QFrame* line = new QFrame();
+        line->setFrameShape(QFrame::HLine);
+        line->setFrameShadow(QFrame::Sunken);
+        audioLayout->addWidget(line);
+    }
+
+    audioLayout->addWidget(new audioConfig(audiopane));
+    switcher->addWidget(audiopane);
+
+    button = new QToolButton(this);
+    button->setToolButtonStyle(Qt::ToolButtonTextUnderIcon);
+    button->setIcon(GET_ICON(icon_audiocard));
+    button->setText(tr("Audio")); 
+    button->setToolTip(tr("Audio setting"));
+    button->setStatusTip("Audio setting");
+    button->setCheckable(true);
+    button->setSizePolicy(sizePol);
+    buttonGroup->addButton(button, section++);
+    buttons->addWidget(button);
+
+    audioLayout->addStretch();
+
+    // DSP settings
+    QWidget* dsppane = new QWidget(this);
+    QVBoxLayout* dspLayout = new QVBoxLayout(dsppane);
+    dspLayout->addWidget(new QLabel(tr("DSP settings"), this));
+
+    {
+        QFrame* line = new QFrame();
+        line->setFrameShape(QFrame::HLine);
+        line->setFrameShadow(QFrame::Sunken);
+        dspLayout->addWidget(line);
+    }
+
+    dspLayout->addWidget(new dspConfig(dsppane));
+    switcher->addWidget(dsppane);
+
+    button = new QToolButton(this);
+    button->setToolButtonStyle(Qt::ToolButtonTextUnderIcon);
+    button->setIcon(GET_ICON(icon_guioptions));
+    button->setText(tr("DSP"));
+    button->setToolTip(tr("DSP setting"));
+    button->setStatusTip("DSP setting");
+    button->setCheckable(true);
+    button->setSizePolicy(sizePol);
+    buttonGroup->addButton(button, section++);
+    buttons->addWidget(button);
+
+    dspLayout->addStretch();
+#ifdef HAVE_LASTFM
+    // Last.fm settings
+    QWidget* lastfmpane = new QWidget(this);
+    QVBoxLayout* lastfmLayout = new QVBoxLayout(lastfmpane);
+    lastfmLayout->addWidget(new QLabel(tr("Last.fm settings"), this));
+
+    {
+        QFrame* line = new QFrame();
+        line->setFrameShape(QFrame::HLine);
+        line->setFrameShadow(QFrame::Sunken);
+        lastfmLayout->addWidget(line);
+    }
+
+    lastfmLayout->addWidget(new lastfmConfig(lastfmpane));
+    switcher->addWidget(lastfmpane);
+
+    button = new QToolButton(this);
+    button->setToolButtonStyle(Qt::ToolButtonTextUnderIcon);
+    button->setIcon(GET_ICON(icon_lastfm));
+    button->setText(tr("Last.fm")); 
+    button->setToolTip(tr("Last.fm setting"));
+    button->setStatusTip("Last.fm setting");
+    button->setCheckable(true);
+    button->setSizePolicy(sizePol);
+    buttonGroup->addButton(button, section++);
+    buttons->addWidget(button);
+
+    lastfmLayout->addStretch();
+#endif
+    // Backend settings
+    QWidget* backendpane = new QWidget(this);
+    QVBoxLayout* backendLayout = new QVBoxLayout(backendpane);
+    backendLayout->addWidget(new QLabel(tr("Backend settings"), this));
+
+    {
+        QFrame* line = new QFrame(this);
+        line->setFrameShape(QFrame::HLine);
+        line->setFrameShadow(QFrame::Sunken);
+        backendLayout->addWidget(line);
+    }
+
+    QStackedWidget *beSwitcher = new QStackedWidget(this);
+
+    {
+        QComboBox *backends = new QComboBox(this);
+        for (int i=0; i<IFACTORY->num(); i++)
+        {
+            backends->addItem(IFACTORY->name(i));
+            inputConfig *ic = IFACTORY->getConfig(i);
+            backends->setItemIcon(i, ic->icon());
+            m_inputConfigs.append(ic);
+            beSwitcher->addWidget(ic->config());
+        }
+        connect(backends, QOverload<int>::of(&QComboBox::currentIndexChanged), beSwitcher, &QStackedWidget::setCurrentIndex);
+
+        backends->setCurrentText(bkName);
+
+        QWidget *w = new QWidget(this);
+        QHBoxLayout *backendSelection = new QHBoxLayout(w);
+        backendSelection->addWidget(new QLabel(tr("Backend")));
+        backendSelection->addWidget(backends);
+        backendLayout->addWidget(w);
+    }
+
+    backendLayout->addWidget(beSwitcher);
+
+    backendLayout->addStretch();
+
+    switcher->addWidget(backendpane);
+
+    button = new QToolButton(this);
+    button->setToolButtonStyle(Qt::ToolButtonTextUnderIcon);
+    button->setIcon(GET_ICON(icon_backend));
+    button->setText(tr("Backend")); 
+    button->setToolTip(tr("Backend settings"));
+    button->setStatusTip("Backend settings");
+    button->setCheckable(true);
+    button->setSizePolicy(sizePol);
+    buttonGroup->addButton(button, section++);
+    buttons->addWidget(button);
+
+    {
+        QFrame* line = new QFrame(this);
+        line->setFrameShape(QFrame::HLine);
+        line->setFrameShadow(QFrame::Sunken);
+        main->addWidget(line);
+    }
+
+    QHBoxLayout* bottom = new QHBoxLayout();
+    main->addLayout(bottom);
+    QPushButton* initial = new QPushButton(GET_ICON(icon_dialogok), tr("&OK"), this);
+    bottom->addWidget(initial);
+    QPushButton* b = new QPushButton(GET_ICON(icon_dialogcancel), tr("&Cancel"), this);
+    bottom->addWidget(b);
+    initial->setFocus();
+    connect(b, &QPushButton::clicked,
+        [this]()
+        {
+            //SETTINGS->load();
+            for (inputConfig* ic: m_inputConfigs)
+            {
+                ic->loadSettings();
+                delete ic;
+            }
+            reject();
+        }
+    );
+    connect(initial, &QPushButton::clicked,
+        [this]()
+        {
+            //SETTINGS->save();
+            for (inputConfig* ic: m_inputConfigs)
+            {
+                ic->saveSettings();
+                delete ic;
+            }
+            accept();
+        }
+    );
+
+    buttons->addStretch();
+
+    layout()->setSizeConstraint(QLayout::SetFixedSize);
+}
+
+bool settingsWindow::event(QEvent *e)
+{
+    if (e->type() == QEvent::StatusTip)
+    {
+        QStatusTipEvent *ev = (QStatusTipEvent*)e;
+        ((QMainWindow*)parentWidget())->statusBar()->showMessage(ev->tip());
+        return true;
+    }
+    return QDialog::event(e);
+}
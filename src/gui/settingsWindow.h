@@ -0,0 +1,45 @@
+/*
+ *  Copyright (C) 2008-2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef SETTINGSWINDOW_H
+#define SETTINGSWINDOW_H
+
+#include <QDialog>
+#include <QList>
+
+class inputConfig;
+
+class settingsWindow : public QDialog
+{
+private:
+    QList<inputConfig*> m_inputConfigs;
+
+private:
+    settingsWindow() {}
+    settingsWindow(const settingsWindow&) = delete;
+    settingsWindow& operator=(const settingsWindow&) = delete;
+
+protected:
+    bool event(QEvent *e) override;
+
+public:
+    settingsWindow(QWidget* win, const QString& bkName);
+    ~settingsWindow() override = default;
+};
+
+#endif
@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2013-2023 Leandro Nini
+ *  Copyright (C) 2013-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -18,7 +18,9 @@
 
 #include "singleApp.h"
 
+#include "loudnessStore.h"
 #include "mainWindow.h"
+#include "metaDataStore.h"
 #include "player.h"
 #include "syspaths.h"
 
@@ -167,5 +169,10 @@ int main(int argc, char *argv[])
 
     splash.finish(&window);
 
-    return app.exec();
+    const int res = app.exec();
+
+    MDSTORE->save();
+    LDSTORE->save();
+
+    return res;
 }
@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2021-2023 Leandro Nini
+ *  Copyright (C) 2021-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -257,8 +257,8 @@ qlonglong dbusHandler::position() const
 {
     if (m_player->state() == state_t::STOP)
         return 0;
-    // (position / 100) * duration * 1000
-    return m_player->getPosition() * m_player->songDuration() * 10ll;
+    // in microseconds
+    return m_player->elapsed() * 1000ll;
 }
 
 void dbusHandler::SetPosition(const QDBusObjectPath &TrackId, qlonglong Position)
@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2023 Leandro Nini
+ *  Copyright (C) 2023-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -157,7 +157,7 @@ void lastfmScrobbler::nowPlaying(bool force)
         // unpausing
         if (m_track.data() != nullptr)
         {
-            m_timer.setInterval(scrobblePoint - m_player->seconds()*1000);
+            m_timer.setInterval(qMax(scrobblePoint - m_player->elapsed(), 0));
             m_timer.start();
         }
     }
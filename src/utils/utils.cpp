@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2006-2021 Leandro Nini
+ *  Copyright (C) 2006-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -20,7 +20,14 @@
 
 #include <cmath>
 
+#include <QDebug>
 #include <QString>
+#include <QThread>
+
+#ifdef Q_OS_LINUX
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#endif
 
 #ifdef _WIN32
 #include <windows.h>
@@ -45,3 +52,20 @@ QString utils::shrink(const QString& string)
         ? QString("...%1").arg(string.right(MAX_CHARS))
         : string;
 }
+
+void utils::lowPriority()
+{
+    thread_local bool done = false;
+    if (done)
+        return;
+
+    QThread::currentThread()->setPriority(QThread::LowestPriority);
+#ifdef Q_OS_LINUX
+    // idle I/O class, who=IOPRIO_WHO_PROCESS with pid 0 is the calling thread
+    constexpr int IOPRIO_CLASS_IDLE = 3;
+    constexpr int IOPRIO_CLASS_SHIFT = 13;
+    if (syscall(SYS_ioprio_set, 1, 0, IOPRIO_CLASS_IDLE << IOPRIO_CLASS_SHIFT) < 0)
+        qDebug() << "Cannot lower I/O priority";
+#endif
+    done = true;
+}
@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2006-2019 Leandro Nini
+ *  Copyright (C) 2006-2026 Leandro Nini
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -36,6 +36,9 @@ template<class T> inline void delPtr(T*& p) { delete p; p = nullptr; }
 
 /// Shrink a string if it's too long
 QString shrink(const QString& string);
+
+/// Lower CPU and I/O priority of the calling thread
+void lowPriority();
 }
 
 #endif